@@ -0,0 +1,37 @@
+//===- Translation.h --------------------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2023, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef AIE_C_TRANSLATION_H
+#define AIE_C_TRANSLATION_H
+
+#include "mlir-c/IR.h"
+#include "mlir-c/Support.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Callback receiving the LLVM IR and the linker script (or BCF) of a core. */
+typedef void (*AieCoreArtifactsCallback)(int col, int row, MlirStringRef llvmIR,
+                                         MlirStringRef linkerScript,
+                                         void *userData);
+
+/** Lowers the cores at (cols[i], rows[i]) of a placed module to LLVM IR in
+ * parallel and generates their linker scripts, or BCF files if bcf is set.
+ * passPipeline is run on each core after the standard lowering. The callback
+ * is invoked once per core, in order, after all cores succeeded.
+ */
+MLIR_CAPI_EXPORTED MlirLogicalResult
+aieTranslateCores(MlirOperation module, const int *cols, const int *rows,
+                  intptr_t numCores, MlirStringRef passPipeline, bool bcf,
+                  AieCoreArtifactsCallback callback, void *userData);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AIE_C_TRANSLATION_H
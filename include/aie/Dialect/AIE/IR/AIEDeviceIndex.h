@@ -0,0 +1,87 @@
+//===- AIEDeviceIndex.h -----------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef AIE_DEVICE_INDEX_H
+#define AIE_DEVICE_INDEX_H
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringMap.h"
+
+namespace xilinx::AIE {
+
+/// An index of the tiles of a device and of the operations placed on them,
+/// built in a single walk over the device.
+///
+/// Passes obtain it with getAnalysis<DeviceIndex>(). A pass that does not
+/// create, erase or retarget tiles, buffers, locks, cores, DMAs, switchboxes,
+/// shim muxes or shim DMA allocations should call
+/// markAnalysesPreserved<DeviceIndex>() so that later passes can reuse it.
+class DeviceIndex {
+public:
+  struct TileInfo {
+    TileOp tile;
+    CoreOp core;
+    MemOp mem;
+    MemTileDMAOp memTileDMA;
+    ShimDMAOp shimDMA;
+    SwitchboxOp switchbox;
+    ShimMuxOp shimMux;
+    llvm::SmallVector<BufferOp, 4> buffers;
+    llvm::SmallVector<LockOp, 4> locks;
+  };
+
+  explicit DeviceIndex(mlir::Operation *op);
+
+  /// Return the tile at the given coordinates, or null if there is none.
+  TileOp getTile(TileID coord) const { return tilesByCoord.lookup(coord); }
+  TileOp getTile(int col, int row) const { return getTile({col, row}); }
+
+  /// Return the tiles of the device in program order.
+  llvm::ArrayRef<TileOp> getTiles() const { return tiles; }
+
+  /// Return the information recorded for a tile of the device.
+  const TileInfo &getInfo(TileOp tile) const;
+
+  llvm::ArrayRef<BufferOp> getBuffers(TileOp tile) const {
+    return getInfo(tile).buffers;
+  }
+  llvm::ArrayRef<LockOp> getLocks(TileOp tile) const {
+    return getInfo(tile).locks;
+  }
+  CoreOp getCore(TileOp tile) const { return getInfo(tile).core; }
+  MemOp getMem(TileOp tile) const { return getInfo(tile).mem; }
+  MemTileDMAOp getMemTileDMA(TileOp tile) const {
+    return getInfo(tile).memTileDMA;
+  }
+  ShimDMAOp getShimDMA(TileOp tile) const { return getInfo(tile).shimDMA; }
+  SwitchboxOp getSwitchbox(TileOp tile) const {
+    return getInfo(tile).switchbox;
+  }
+  ShimMuxOp getShimMux(TileOp tile) const { return getInfo(tile).shimMux; }
+
+  /// Return the shim DMA allocation for the given symbol (usually an
+  /// objectFifo), if any.
+  std::optional<ShimDMAAllocationOp>
+  getShimDMAAllocation(llvm::StringRef symName) const;
+
+private:
+  TileInfo &getOrCreateInfo(mlir::Value tile);
+
+  llvm::SmallVector<TileOp> tiles;
+  llvm::DenseMap<TileID, TileOp> tilesByCoord;
+  llvm::DenseMap<mlir::Operation *, TileInfo> tileInfos;
+  llvm::StringMap<ShimDMAAllocationOp> shimDMAAllocations;
+};
+
+} // namespace xilinx::AIE
+
+#endif // AIE_DEVICE_INDEX_H
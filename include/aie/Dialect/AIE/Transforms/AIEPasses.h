@@ -41,6 +41,8 @@ std::unique_ptr<mlir::OperationPass<DeviceOp>>
 createAIEObjectFifoStatefulTransformPass();
 std::unique_ptr<mlir::OperationPass<DeviceOp>>
 createAIEObjectFifoRegisterProcessPass();
+std::unique_ptr<mlir::OperationPass<DeviceOp>>
+createAIEObjectFifoDepthSizingPass();
 
 /// Generate the code for registering passes.
 #define GEN_PASS_REGISTRATION
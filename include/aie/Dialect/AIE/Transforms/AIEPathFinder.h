@@ -111,29 +111,143 @@ typedef struct Flow {
   std::vector<PathEndPoint> dsts;
 } Flow;
 
+// An indexed binary min-heap of switchbox indices used as the priority queue
+// of the shortest path search. Entries are ordered by (distance, index), which
+// matches the (col, row) ordering of Switchbox pointers. The storage is kept
+// between searches so that routing a flow does not allocate.
+class SwitchboxQueue {
+  std::vector<std::pair<double, unsigned>> heap;
+  // Position of each switchbox index in heap, or -1 if it is not queued.
+  std::vector<int> position;
+
+  static bool lessThan(const std::pair<double, unsigned> &a,
+                       const std::pair<double, unsigned> &b);
+  void siftUp(unsigned pos);
+  void siftDown(unsigned pos);
+
+public:
+  void reset(unsigned numSwitchboxes);
+  bool empty() const { return heap.empty(); }
+  // Insert idx with the given distance, or lower its distance if it is
+  // already queued.
+  void update(unsigned idx, double distance);
+  unsigned pop();
+};
+
+// Scratch state of routing one flow. predChannels records the channel used to
+// reach each switchbox on its shortest path from the routing tree.
+typedef struct SearchState {
+  std::vector<double> distances;
+  std::vector<Channel *> predChannels;
+  SwitchboxQueue queue;
+  // Marks the destinations that are not yet connected to the routing tree.
+  std::vector<bool> isTarget;
+  // Marks the switchboxes of the routing tree, which are listed in treeNodes.
+  std::vector<bool> inTree;
+  std::vector<unsigned> treeNodes;
+  unsigned lastTarget = 0; // the destination settled last by a search
+  // The channels of the routing tree, in the order they are claimed.
+  std::vector<Channel *> path;
+  unsigned long expanded = 0; // switchboxes popped from the queue
+} SearchState;
+
+// Configuration of the routing performed by Pathfinder::findPaths.
+typedef struct PathfinderOptions {
+  // Search up to numThreads flows concurrently on the thread pool of the
+  // device's context. The routing is identical for any number of threads.
+  unsigned numThreads = 1;
+  // After the first iteration, only rip up and reroute the flows that use a
+  // channel which is over capacity, keeping all other routes.
+  bool incremental = false;
+  // Use A* with the Manhattan distance to the nearest destination times the
+  // minimum channel demand as the lower bound.
+  bool astar = false;
+  // If not negative, only expand switchboxes inside the bounding box of the
+  // flow's endpoints grown by this many switchboxes. The box is widened when
+  // a destination cannot be reached inside it.
+  int boundingBoxMargin = -1;
+  // Route flows with several destinations as Steiner trees, connecting the
+  // nearest unconnected destination to the tree built so far one at a time,
+  // instead of as a single shortest path tree from the source.
+  bool steiner = false;
+} PathfinderOptions;
+
+// Statistics of one routing iteration of Pathfinder::findPaths.
+typedef struct RoutingIterationStats {
+  int iteration;
+  unsigned flowsRouted;        // flows ripped up and searched again
+  unsigned overflowedChannels; // channels over capacity after the iteration
+  unsigned long switchboxesExpanded; // by all searches of the iteration
+  unsigned long channelsUsed;        // by the routes of all flows
+  double milliseconds;
+} RoutingIterationStats;
+
 class Pathfinder {
   SwitchboxGraph graph;
   std::vector<Flow> flows;
   bool maxIterReached{};
+  // A flow with a destination that can't be reached from its source.
+  const Flow *unroutableFlow = nullptr;
   std::map<TileID, Switchbox> grid;
   // Use a list instead of a vector because nodes have an edge list of raw
   // pointers to edges (so growing a vector would invalidate the pointers).
   std::list<Channel> edges;
 
+  // Dense view of the graph used by the shortest path search. The switchbox at
+  // (col, row) has index col * numRows + row. The outgoing channels of
+  // switchbox i are outChannels[outChannelOffsets[i], outChannelOffsets[i+1]).
+  int numCols = 0, numRows = 0;
+  std::vector<Switchbox *> switchboxes;
+  std::vector<unsigned> outChannelOffsets;
+  std::vector<Channel *> outChannels;
+  std::vector<unsigned> outChannelTargets;
+
+  // One search state per flow that may be searched concurrently, sized once
+  // and reused for every flow.
+  std::vector<SearchState> searchStates;
+  mlir::MLIRContext *context = nullptr;
+
+  // The channels claimed by each flow in its current route, in claim order.
+  std::vector<std::vector<Channel *>> flowPaths;
+  PathfinderOptions options;
+  // Lower bound on the demand of every channel, used by the A* heuristic.
+  double minDemand = 1.0;
+  std::vector<RoutingIterationStats> iterationStats;
+
+  unsigned getSwitchboxIndex(int col, int row) const {
+    return col * numRows + row;
+  }
+  unsigned getSwitchboxIndex(const Switchbox *sb) const {
+    return getSwitchboxIndex(sb->col, sb->row);
+  }
+  void resizeSearchState(SearchState &state);
+  mlir::LogicalResult routeFlow(const Flow &flow, SearchState &state) const;
+  bool findShortestPaths(const Flow &flow, SearchState &state,
+                         unsigned numTargets) const;
+  bool searchInBox(const Flow &flow, SearchState &state, unsigned numTargets,
+                   int minCol, int maxCol, int minRow, int maxRow) const;
+  unsigned tracePath(SearchState &state, unsigned idx) const;
+  bool claimPath(const Flow &flow, const std::vector<Channel *> &path,
+                 SwitchSettings &switchSettings);
+  void updateDemands();
+
 public:
   Pathfinder() = default;
   Pathfinder(int maxCol, int maxRow, DeviceOp &d);
   void addFlow(TileID srcCoords, Port srcPort, TileID dstCoords, Port dstPort);
   bool addFixedConnection(TileID coord, Port port);
   bool isLegal();
+  void setOptions(const PathfinderOptions &value);
+  const std::vector<RoutingIterationStats> &getIterationStats() const {
+    return iterationStats;
+  }
+  const Flow *getUnroutableFlow() const { return unroutableFlow; }
   std::map<PathEndPoint, SwitchSettings> findPaths(int maxIterations = 1000);
 
   Switchbox *getSwitchbox(TileID coords) {
-    auto sb = std::find_if(graph.begin(), graph.end(), [&](Switchbox *sb) {
-      return sb->col == coords.col && sb->row == coords.row;
-    });
-    assert(sb != graph.end() && "couldn't find sb");
-    return *sb;
+    assert(coords.col >= 0 && coords.col < numCols && coords.row >= 0 &&
+           coords.row < numRows && "couldn't find sb");
+    return switchboxes[getSwitchboxIndex(coords.col, coords.row)];
   }
 };
 
@@ -36,6 +36,8 @@ namespace aievec {
 
 std::unique_ptr<mlir::Pass> createAIEVecConvolutionAnalysisPass();
 
+std::unique_ptr<mlir::Pass> createAIEVecCycleEstimatePass();
+
 /// Generate the code for registering passes.
 #define GEN_PASS_REGISTRATION
 #include "aie/Dialect/AIEVec/Analysis/Passes.h.inc"
@@ -61,6 +61,12 @@ struct OptimizeAIEVecOptions
       *this, "shift",
       llvm::cl::desc("Shift parameter for rounding and saturation"),
       llvm::cl::init(0)};
+  PassOptions::Option<bool> keepAccInLoops{
+      *this, "keep-acc-in-loops",
+      llvm::cl::desc("Keep loop-carried accumulators moved out with an SRS in "
+                     "accumulator registers, skipping the saturation and "
+                     "rounding of every iteration but the last"),
+      llvm::cl::init(false)};
 };
 
 /// Options for the "convert-vector-to-aievec" pipeline.
@@ -87,6 +93,12 @@ struct ConvertVectorToAIEVecOptions
       llvm::cl::desc("Select AIE version: \"aie\" or \"aieml\". This will "
                      "determine the vector size and available operations."),
       llvm::cl::init("aie")};
+  PassOptions::Option<bool> keepAccInLoops{
+      *this, "keep-acc-in-loops",
+      llvm::cl::desc("Keep loop-carried accumulators moved out with an SRS in "
+                     "accumulator registers, skipping the saturation and "
+                     "rounding of every iteration but the last"),
+      llvm::cl::init(false)};
 
   mlir::LogicalResult parseFromString(mlir::StringRef options) {
     auto res = PassPipelineOptions::parseFromString(options);
@@ -95,6 +107,7 @@ struct ConvertVectorToAIEVecOptions
       canonicalizeOptions.aieTarget = aieTarget;
       optimizeOptions.aieTarget = aieTarget;
       optimizeOptions.shiftParam = shiftParam;
+      optimizeOptions.keepAccInLoops = keepAccInLoops;
     }
     return res;
   }
@@ -144,6 +157,11 @@ void registerAIEVecPipelines();
 /// Create a pass that removes unnecessary Copy operations.
 std::unique_ptr<::mlir::Pass> createCopyRemovalPass();
 
+/// Create a pass that keeps loop-carried accumulators in accumulator registers
+/// across the iterations of scf.for loops, where they are only moved between
+/// registers.
+std::unique_ptr<::mlir::Pass> createAIEVecAccumulatorLoopsPass();
+
 // Create a pass that rewrites the arith dialect to enable the support of
 // dynamic sized tensor/memref for the auto-vectorization to CPP flow.
 std::unique_ptr<::mlir::Pass> createDynamicSizeNoImplicitBroadcastPass();
@@ -0,0 +1,63 @@
+//===- AIETargets.h ---------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef AIE_TARGETS_AIETARGETS_H
+#define AIE_TARGETS_AIETARGETS_H
+
+#include "aie/Dialect/AIE/IR/AIETargetModel.h"
+
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Support/LogicalResult.h"
+#include "llvm/ADT/STLFunctionalExtras.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace xilinx {
+namespace AIE {
+
+mlir::LogicalResult AIETranslateToXAIEV2(mlir::ModuleOp module,
+                                         llvm::raw_ostream &output);
+mlir::LogicalResult AIEFlowsToJSON(mlir::ModuleOp module,
+                                   llvm::raw_ostream &output);
+mlir::LogicalResult ADFGenerateCPPGraph(mlir::ModuleOp module,
+                                        llvm::raw_ostream &output);
+mlir::LogicalResult AIETranslateSCSimConfig(mlir::ModuleOp module,
+                                            llvm::raw_ostream &output);
+mlir::LogicalResult AIETranslateShimSolution(mlir::ModuleOp module,
+                                             llvm::raw_ostream &);
+mlir::LogicalResult AIETranslateGraphXPE(mlir::ModuleOp module,
+                                         llvm::raw_ostream &);
+mlir::LogicalResult AIETranslateToCDO(mlir::ModuleOp module,
+                                      llvm::raw_ostream &output);
+mlir::LogicalResult AIETranslateToIPU(mlir::ModuleOp module,
+                                      llvm::raw_ostream &output, bool binary);
+mlir::LogicalResult AIETranslateToTransaction(mlir::ModuleOp module,
+                                              llvm::raw_ostream &output,
+                                              bool textual);
+mlir::LogicalResult AIETranslateToLdScript(mlir::ModuleOp module,
+                                           llvm::raw_ostream &output,
+                                           int tileCol, int tileRow);
+mlir::LogicalResult AIETranslateToBCF(mlir::ModuleOp module,
+                                      llvm::raw_ostream &output, int tileCol,
+                                      int tileRow);
+
+/// Lower each of the given cores of module to LLVM IR and generate its linker
+/// script (or BCF file, if bcf is set), in parallel on the thread pool of the
+/// context. Each core is lowered on a clone of module with
+/// aie-localize-locks, aie-standard-lowering and aiex-standard-lowering,
+/// followed by passPipeline. The results are passed to emit in the order of
+/// cores, from the calling thread.
+mlir::LogicalResult AIETranslateCores(
+    mlir::ModuleOp module, llvm::ArrayRef<TileID> cores,
+    llvm::StringRef passPipeline, bool bcf,
+    llvm::function_ref<void(TileID core, llvm::StringRef llvmIR,
+                            llvm::StringRef linkerScript)>
+        emit);
+} // namespace AIE
+} // namespace xilinx
+
+#endif // AIE_TARGETS_AIETARGETS_H
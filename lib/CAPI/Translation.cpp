@@ -0,0 +1,33 @@
+//===- Translation.cpp ------------------------------------------*- C++ -*-===//
+//
+// Copyright (C) 2023, Advanced Micro Devices, Inc. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie-c/Translation.h"
+
+#include "aie/Targets/AIETargets.h"
+
+#include "mlir/CAPI/IR.h"
+#include "mlir/CAPI/Support.h"
+
+using namespace mlir;
+using namespace xilinx::AIE;
+
+MlirLogicalResult aieTranslateCores(MlirOperation module, const int *cols,
+                                    const int *rows, intptr_t numCores,
+                                    MlirStringRef passPipeline, bool bcf,
+                                    AieCoreArtifactsCallback callback,
+                                    void *userData) {
+  SmallVector<TileID> cores;
+  for (intptr_t i = 0; i < numCores; i++)
+    cores.push_back({cols[i], rows[i]});
+  auto moduleOp = cast<ModuleOp>(unwrap(module));
+  return wrap(AIETranslateCores(
+      moduleOp, cores, unwrap(passPipeline), bcf,
+      [&](TileID core, StringRef llvmIR, StringRef linkerScript) {
+        callback(core.col, core.row, wrap(llvmIR), wrap(linkerScript),
+                 userData);
+      }));
+}
@@ -96,6 +96,164 @@ void encodeConf(uint32_t conf[2], const BufferParams &x, const BufferParams &z,
   conf[1] |= sub << 17;
 }
 
+// Fields of the AIE-ML vector MAC configuration word. The modes select the
+// operand and accumulator precisions, and the variant how the lanes of the
+// operands are paired.
+struct MacConf {
+  bool lhsSigned;
+  bool rhsSigned;
+  uint32_t amode;
+  uint32_t bmode;
+  uint32_t variant;
+  bool sub;
+};
+
+// Encode the AIE-ML MAC configuration word, with the same layout as the
+// constants of the matmul lowering.
+uint32_t encodeConf(const MacConf &x) {
+  return ((x.amode & 0x3) << 1) | ((x.bmode & 0x3) << 3) |
+         ((x.variant & 0x7) << 5) | (x.rhsSigned << 8) | (x.lhsSigned << 9) |
+         (x.sub << 11);
+}
+
+// Return the declaration of the intrinsic `name`, inserting it at the start of
+// the module if it doesn't exist yet.
+static LLVM::LLVMFuncOp getOrInsertIntrinsic(OpBuilder &rewriter,
+                                             Operation *op, StringRef name,
+                                             Type resultType,
+                                             ArrayRef<Type> argTypes) {
+  auto module = op->getParentOfType<ModuleOp>();
+  auto func = module.lookupSymbol<LLVM::LLVMFuncOp>(
+      StringAttr::get(rewriter.getContext(), name));
+  if (!func) {
+    OpBuilder::InsertionGuard guard(rewriter);
+    rewriter.setInsertionPointToStart(module.getBody());
+    func = rewriter.create<LLVM::LLVMFuncOp>(
+        rewriter.getUnknownLoc(), name,
+        LLVM::LLVMFunctionType::get(resultType, argTypes));
+  }
+  return func;
+}
+
+// Reinterpret the bits of `value` as type `type`, if it isn't already.
+static Value bitcastIfNeeded(OpBuilder &rewriter, Location loc, Value value,
+                             Type type) {
+  if (value.getType() == type)
+    return value;
+  return rewriter.create<LLVM::BitcastOp>(loc, type, value);
+}
+
+// Return a vector type with the same shape as `type` and integer elements of
+// the same width.
+static VectorType getIntegerVectorType(VectorType type) {
+  return VectorType::get(
+      type.getShape(),
+      IntegerType::get(type.getContext(), getElementSizeInBits(type)));
+}
+
+// Return a splat constant of `type` with every bit of every element set to
+// `bit`.
+static Value createSplatBitsConstant(OpBuilder &rewriter, Location loc,
+                                     VectorType type, bool bit) {
+  unsigned width = getElementSizeInBits(type);
+  auto attr = DenseElementsAttr::get(
+      type, bit ? APInt::getAllOnes(width) : APInt::getZero(width));
+  return rewriter.create<LLVM::ConstantOp>(loc, type, attr);
+}
+
+// Integer operands are signed unless their type says otherwise.
+static bool isSignedOperand(Value value) {
+  auto intTy =
+      dyn_cast<IntegerType>(cast<VectorType>(value.getType()).getElementType());
+  return intTy && !intTy.isUnsigned();
+}
+
+// Call the AIE-ML MAC intrinsic `name` with the configuration word `conf`.
+// It accumulates into `acc`, or only multiplies if `acc` is null.
+static Value createMacIntrinsicCall(OpBuilder &rewriter, Operation *op,
+                                    StringRef name, Value lhs, Value rhs,
+                                    Value acc, Type resultType, uint32_t conf) {
+  Location loc = op->getLoc();
+  auto i32ty = rewriter.getI32Type();
+  SmallVector<Value> args{lhs, rhs};
+  if (acc)
+    args.push_back(acc);
+  args.push_back(rewriter.create<LLVM::ConstantOp>(
+      loc, i32ty, rewriter.getI32IntegerAttr(conf)));
+  SmallVector<Type> argTypes(ValueRange(args).getTypes());
+  auto func = getOrInsertIntrinsic(rewriter, op, name, resultType, argTypes);
+  return rewriter.create<LLVM::CallOp>(loc, func, args).getResult();
+}
+
+// Lower an element-wise multiplication, accumulated into `acc` unless it is
+// null, to the AIE-ML MAC unit if it has a mode for the operand and result
+// types: 32 lanes of i16 into i32, or 16 lanes of bf16 into f32.
+static LogicalResult lowerElemToIntrinsic(Operation *op, Value lhs, Value rhs,
+                                          Value acc, bool fmsub,
+                                          ConversionPatternRewriter &rewriter) {
+  Location loc = op->getLoc();
+  auto accTy = cast<VectorType>(op->getResult(0).getType());
+  auto lhsTy = cast<VectorType>(lhs.getType());
+  if (lhsTy != rhs.getType())
+    return failure();
+
+  Type elemTy = lhsTy.getElementType();
+  if (elemTy.isInteger(16) && lhsTy.getNumElements() == 32 &&
+      accTy == VectorType::get({32}, rewriter.getI32Type())) {
+    uint32_t conf = encodeConf({isSignedOperand(lhs), isSignedOperand(rhs),
+                                /*amode=*/0, /*bmode=*/3, /*variant=*/1,
+                                fmsub});
+    Value result = createMacIntrinsicCall(
+        rewriter, op,
+        acc ? "llvm.aie2.i512.i512.acc1024.acc32.mac.conf"
+            : "llvm.aie2.i512.i512.acc1024.acc32.mul.conf",
+        lhs, rhs, acc, accTy, conf);
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+
+  if (elemTy.isBF16() && lhsTy.getNumElements() >= 16 &&
+      accTy == VectorType::get({16}, rewriter.getF32Type())) {
+    // The bf16 mode multiplies pairs of lanes and adds them, so each lane of
+    // the operands is paired with a zero.
+    int64_t lanes = lhsTy.getNumElements();
+    auto zero = rewriter.create<LLVM::ConstantOp>(loc, lhsTy,
+                                                  rewriter.getZeroAttr(lhsTy));
+    SmallVector<int32_t> mask;
+    for (int32_t i = 0; i < 16; i++)
+      mask.append({i, static_cast<int32_t>(lanes) + i});
+    lhs = rewriter.create<LLVM::ShuffleVectorOp>(loc, lhs, zero, mask);
+    rhs = rewriter.create<LLVM::ShuffleVectorOp>(loc, rhs, zero, mask);
+    uint32_t conf = encodeConf({false, false, /*amode=*/2, /*bmode=*/3,
+                                /*variant=*/1, fmsub});
+    Value result = createMacIntrinsicCall(
+        rewriter, op,
+        acc ? "llvm.aie2.bf.mac16.conf" : "llvm.aie2.bf.mul16.conf", lhs, rhs,
+        acc, accTy, conf);
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+  return failure();
+}
+
+// Extend the elements of the first `lanes` lanes of `value` to `elemType`, as
+// the accumulating element-wise and convolution ops do with their operands.
+static Value extendLanes(OpBuilder &rewriter, Location loc, Value value,
+                         int64_t lanes, Type elemType) {
+  auto vecTy = cast<VectorType>(value.getType());
+  if (vecTy.getNumElements() != lanes) {
+    SmallVector<int32_t> mask(lanes);
+    std::iota(mask.begin(), mask.end(), 0);
+    value = rewriter.create<LLVM::ShuffleVectorOp>(loc, value, value, mask);
+  }
+  auto extTy = VectorType::get({lanes}, elemType);
+  if (vecTy.getElementType() == elemType)
+    return value;
+  if (isa<FloatType>(elemType))
+    return rewriter.create<LLVM::FPExtOp>(loc, extTy, value);
+  return rewriter.create<LLVM::SExtOp>(loc, extTy, value);
+}
+
 class AddOpConversion : public mlir::ConvertOpToLLVMPattern<aievec::AddOp> {
 public:
   using ConvertOpToLLVMPattern<aievec::AddOp>::ConvertOpToLLVMPattern;
@@ -711,8 +869,32 @@ public:
   LogicalResult
   matchAndRewrite(aievec::FMAElemOp op, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
-    op.emitWarning() << "aie.mac_elem conversion is not implemented\n";
-    return failure();
+    if (succeeded(lowerElemToIntrinsic(op, adaptor.getLhs(), adaptor.getRhs(),
+                                       adaptor.getAcc(), op.getFmsub(),
+                                       rewriter)))
+      return success();
+
+    // Other types are multiplied lane by lane in the accumulator type.
+    Location loc = op.getLoc();
+    auto accTy = cast<VectorType>(op.getResult().getType());
+    int64_t lanes = accTy.getNumElements();
+    Type accElemTy = accTy.getElementType();
+    Value lhs = extendLanes(rewriter, loc, adaptor.getLhs(), lanes, accElemTy);
+    Value rhs = extendLanes(rewriter, loc, adaptor.getRhs(), lanes, accElemTy);
+    if (isa<FloatType>(accElemTy)) {
+      Value prod = rewriter.create<LLVM::FMulOp>(loc, lhs, rhs);
+      if (op.getFmsub())
+        rewriter.replaceOpWithNewOp<LLVM::FSubOp>(op, adaptor.getAcc(), prod);
+      else
+        rewriter.replaceOpWithNewOp<LLVM::FAddOp>(op, adaptor.getAcc(), prod);
+    } else {
+      Value prod = rewriter.create<LLVM::MulOp>(loc, lhs, rhs);
+      if (op.getFmsub())
+        rewriter.replaceOpWithNewOp<LLVM::SubOp>(op, adaptor.getAcc(), prod);
+      else
+        rewriter.replaceOpWithNewOp<LLVM::AddOp>(op, adaptor.getAcc(), prod);
+    }
+    return success();
   }
 };
 
@@ -884,6 +1066,523 @@ class MatMulOpConversion
   }
 };
 
+class MulElemOpConversion
+    : public mlir::ConvertOpToLLVMPattern<aievec::MulElemOp> {
+public:
+  using ConvertOpToLLVMPattern<aievec::MulElemOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::MulElemOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (succeeded(lowerElemToIntrinsic(op, adaptor.getLhs(), adaptor.getRhs(),
+                                       nullptr, /*fmsub=*/false, rewriter)))
+      return success();
+
+    // Other types are multiplied lane by lane in the accumulator type.
+    Location loc = op.getLoc();
+    auto accTy = cast<VectorType>(op.getResult().getType());
+    int64_t lanes = accTy.getNumElements();
+    Type accElemTy = accTy.getElementType();
+    Value lhs = extendLanes(rewriter, loc, adaptor.getLhs(), lanes, accElemTy);
+    Value rhs = extendLanes(rewriter, loc, adaptor.getRhs(), lanes, accElemTy);
+    if (isa<FloatType>(accElemTy))
+      rewriter.replaceOpWithNewOp<LLVM::FMulOp>(op, lhs, rhs);
+    else
+      rewriter.replaceOpWithNewOp<LLVM::MulOp>(op, lhs, rhs);
+    return success();
+  }
+};
+
+// Lower a convolution of an M-lane signal window with an N-tap filter:
+//   result[i] = acc[i] +/- sum(j = 0..N-1, lhs[i + j] * rhs[j])
+// A null `acc` lowers mul_conv, which has no accumulator input.
+static LogicalResult lowerConvolution(Operation *op, Value lhs, Value rhs,
+                                      Value acc, int64_t M, int64_t N,
+                                      bool fmsub,
+                                      ConversionPatternRewriter &rewriter) {
+  Location loc = op->getLoc();
+  auto accTy = cast<VectorType>(op->getResult(0).getType());
+  Type accElemTy = accTy.getElementType();
+  auto lhsTy = cast<VectorType>(lhs.getType());
+  if (accTy.getNumElements() != M || lhsTy.getNumElements() < M + N - 1 ||
+      cast<VectorType>(rhs.getType()).getNumElements() < N)
+    return failure();
+
+  // The AIE-ML MAC unit has convolution modes for a 16x4 window of i16 into
+  // i64 and a 32x8 window of i8 into i32, on full 512-bit operands.
+  if (lhsTy == rhs.getType() &&
+      lhsTy.getNumElements() * getElementSizeInBits(lhsTy) == 512) {
+    std::optional<MacConf> conf;
+    StringRef name;
+    if (lhsTy.getElementType().isInteger(16) && M == 16 && N == 4 &&
+        accElemTy.isInteger(64)) {
+      conf = MacConf{isSignedOperand(lhs), isSignedOperand(rhs), /*amode=*/1,
+                     /*bmode=*/3, /*variant=*/2, fmsub};
+      name = acc ? "llvm.aie2.i512.i512.acc1024.acc64.mac.conf"
+                 : "llvm.aie2.i512.i512.acc1024.acc64.mul.conf";
+    } else if (lhsTy.getElementType().isInteger(8) && M == 32 && N == 8 &&
+               accElemTy.isInteger(32)) {
+      conf = MacConf{isSignedOperand(lhs), isSignedOperand(rhs), /*amode=*/0,
+                     /*bmode=*/1, /*variant=*/2, fmsub};
+      name = acc ? "llvm.aie2.i512.i512.acc1024.acc32.mac.conf"
+                 : "llvm.aie2.i512.i512.acc1024.acc32.mul.conf";
+    }
+    if (conf) {
+      rewriter.replaceOp(op, createMacIntrinsicCall(rewriter, op, name, lhs,
+                                                    rhs, acc, accTy,
+                                                    encodeConf(*conf)));
+      return success();
+    }
+  }
+
+  // Other convolutions are unrolled into a multiplication per tap.
+
+  for (int64_t j = 0; j < N; j++) {
+    SmallVector<int32_t> window(M), tap(M, j);
+    std::iota(window.begin(), window.end(), j);
+    Value signal =
+        rewriter.create<LLVM::ShuffleVectorOp>(loc, lhs, lhs, window);
+    Value filter = rewriter.create<LLVM::ShuffleVectorOp>(loc, rhs, rhs, tap);
+    signal = extendLanes(rewriter, loc, signal, M, accElemTy);
+    filter = extendLanes(rewriter, loc, filter, M, accElemTy);
+    Value prod = rewriter.create<LLVM::MulOp>(loc, signal, filter);
+    if (!acc)
+      acc = prod;
+    else if (fmsub)
+      acc = rewriter.create<LLVM::SubOp>(loc, acc, prod);
+    else
+      acc = rewriter.create<LLVM::AddOp>(loc, acc, prod);
+  }
+  rewriter.replaceOp(op, acc);
+  return success();
+}
+
+class MulConvOpConversion
+    : public mlir::ConvertOpToLLVMPattern<aievec::MulConvOp> {
+public:
+  using ConvertOpToLLVMPattern<aievec::MulConvOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::MulConvOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    return lowerConvolution(op, adaptor.getLhs(), adaptor.getRhs(), nullptr,
+                            op.getM(), op.getN(), /*fmsub=*/false, rewriter);
+  }
+};
+
+class FMAConvOpConversion
+    : public mlir::ConvertOpToLLVMPattern<aievec::FMAConvOp> {
+public:
+  using ConvertOpToLLVMPattern<aievec::FMAConvOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::FMAConvOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    return lowerConvolution(op, adaptor.getLhs(), adaptor.getRhs(),
+                            adaptor.getAcc(), op.getM(), op.getN(),
+                            op.getFmsub(), rewriter);
+  }
+};
+
+// Lowers add_elem and sub_elem. Integer vectors are added in the vector unit,
+// while float vectors live in accumulators and use the accfloat intrinsics.
+template <typename SrcOpTy, typename IntOpTy>
+class AddOrSubElemOpConversion
+    : public mlir::ConvertOpToLLVMPattern<SrcOpTy> {
+public:
+  using mlir::ConvertOpToLLVMPattern<SrcOpTy>::ConvertOpToLLVMPattern;
+  using OpAdaptor = typename SrcOpTy::Adaptor;
+
+  LogicalResult
+  matchAndRewrite(SrcOpTy op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto vecTy = cast<VectorType>(op.getResult().getType());
+    if (isa<IntegerType>(vecTy.getElementType())) {
+      rewriter.replaceOpWithNewOp<IntOpTy>(op, adaptor.getLhs(),
+                                           adaptor.getRhs());
+      return success();
+    }
+    if (!vecTy.getElementType().isF32() || getVectorSizeInBits(vecTy) != 512)
+      return failure();
+
+    Location loc = op.getLoc();
+    StringRef intrinsicName = isa<aievec::AddElemOp>(op.getOperation())
+                                  ? "llvm.aie2.add.accfloat"
+                                  : "llvm.aie2.sub.accfloat";
+    auto accTy = VectorType::get({8}, rewriter.getI64Type());
+    auto func = getOrInsertIntrinsic(
+        rewriter, op, intrinsicName, accTy,
+        {accTy, accTy, rewriter.getI32Type()});
+    auto confCst = rewriter.create<LLVM::ConstantOp>(
+        loc, rewriter.getI32Type(), rewriter.getI32IntegerAttr(0));
+    auto callOp = rewriter.create<LLVM::CallOp>(
+        loc, func,
+        ValueRange{bitcastIfNeeded(rewriter, loc, adaptor.getLhs(), accTy),
+                   bitcastIfNeeded(rewriter, loc, adaptor.getRhs(), accTy),
+                   confCst});
+    rewriter.replaceOpWithNewOp<LLVM::BitcastOp>(op, vecTy,
+                                                 callOp.getResult());
+    return success();
+  }
+};
+
+using AddElemOpConversion =
+    AddOrSubElemOpConversion<aievec::AddElemOp, LLVM::AddOp>;
+using SubElemOpConversion =
+    AddOrSubElemOpConversion<aievec::SubElemOp, LLVM::SubOp>;
+
+// Return the suffix of the min/max/sel intrinsics for 512-bit vectors of
+// `vecTy`'s element type, or an empty string if there isn't one.
+static std::string getMinMaxIntrinsicSuffix(VectorType vecTy) {
+  if (getVectorSizeInBits(vecTy) != 512)
+    return "";
+  Type elemTy = vecTy.getElementType();
+  if (elemTy.isBF16())
+    return "bf16";
+  if (auto intTy = dyn_cast<IntegerType>(elemTy))
+    if (intTy.getWidth() == 8 || intTy.getWidth() == 16 ||
+        intTy.getWidth() == 32)
+      return std::to_string(intTy.getWidth());
+  return "";
+}
+
+// Return the type of the lane mask of a 512-bit vector of `vecTy`, as returned
+// by the comparison intrinsics and taken by the select intrinsics.
+static Type getLaneMaskType(VectorType vecTy) {
+  MLIRContext *ctx = vecTy.getContext();
+  if (getVectorLaneSize(vecTy) == 64)
+    return VectorType::get({2}, IntegerType::get(ctx, 32));
+  return IntegerType::get(ctx, 32);
+}
+
+// Call `llvm.aie2.vmax.lt<suffix>` (if `isMax`) or `llvm.aie2.vmin.ge<suffix>`
+// on `lhs` and `rhs`. These return both the lane-wise maximum (minimum) and
+// the mask of the lanes where lhs < rhs (lhs >= rhs).
+static std::pair<Value, Value>
+createMinMaxIntrinsic(ConversionPatternRewriter &rewriter, Operation *op,
+                      bool isMax, Value lhs, Value rhs, bool isSigned) {
+  Location loc = op->getLoc();
+  auto vecTy = cast<VectorType>(lhs.getType());
+  std::string suffix = getMinMaxIntrinsicSuffix(vecTy);
+  std::string name =
+      std::string(isMax ? "llvm.aie2.vmax.lt" : "llvm.aie2.vmin.ge") + suffix;
+  Type maskTy = getLaneMaskType(vecTy);
+  auto resultTy =
+      LLVM::LLVMStructType::getLiteral(rewriter.getContext(), {vecTy, maskTy});
+
+  SmallVector<Value> operands = {lhs, rhs};
+  SmallVector<Type> operandTypes = {vecTy, vecTy};
+  if (suffix != "bf16") {
+    operands.push_back(rewriter.create<LLVM::ConstantOp>(
+        loc, rewriter.getI32Type(), rewriter.getI32IntegerAttr(isSigned)));
+    operandTypes.push_back(rewriter.getI32Type());
+  }
+  auto func =
+      getOrInsertIntrinsic(rewriter, op, name, resultTy, operandTypes);
+  Value result = rewriter.create<LLVM::CallOp>(loc, func, operands).getResult();
+  Value vec = rewriter.create<LLVM::ExtractValueOp>(loc, result,
+                                                    ArrayRef<int64_t>{0});
+  Value mask = rewriter.create<LLVM::ExtractValueOp>(loc, result,
+                                                     ArrayRef<int64_t>{1});
+  return {vec, mask};
+}
+
+template <typename SrcOpTy, bool isMax>
+class MinOrMaxOpConversion : public mlir::ConvertOpToLLVMPattern<SrcOpTy> {
+public:
+  using mlir::ConvertOpToLLVMPattern<SrcOpTy>::ConvertOpToLLVMPattern;
+  using OpAdaptor = typename SrcOpTy::Adaptor;
+
+  LogicalResult
+  matchAndRewrite(SrcOpTy op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (getMinMaxIntrinsicSuffix(cast<VectorType>(op.getType())).empty())
+      return failure();
+    auto [result, mask] =
+        createMinMaxIntrinsic(rewriter, op, isMax, adaptor.getLhs(),
+                              adaptor.getRhs(), /*isSigned=*/true);
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+};
+
+using MinOpConversion = MinOrMaxOpConversion<aievec::MinOp, false>;
+using MaxOpConversion = MinOrMaxOpConversion<aievec::MaxOp, true>;
+
+class CmpOpConversion : public mlir::ConvertOpToLLVMPattern<aievec::CmpOp> {
+public:
+  using ConvertOpToLLVMPattern<aievec::CmpOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::CmpOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto vecTy = cast<VectorType>(op.getLhs().getType());
+    if (getMinMaxIntrinsicSuffix(vecTy).empty())
+      return failure();
+
+    // Every predicate is built from the lane masks of vmax.lt (lhs < rhs) and
+    // vmin.ge (lhs >= rhs).
+    StringRef pred = op.getPred();
+    bool isSigned = pred.empty() || pred.front() != 'u';
+    Value lhs = adaptor.getLhs();
+    Value rhs = adaptor.getRhs();
+    auto lessThan = [&](Value a, Value b) {
+      return createMinMaxIntrinsic(rewriter, op, true, a, b, isSigned).second;
+    };
+    auto greaterEqual = [&](Value a, Value b) {
+      return createMinMaxIntrinsic(rewriter, op, false, a, b, isSigned).second;
+    };
+
+    Location loc = op.getLoc();
+    Value mask;
+    if (pred == "slt" || pred == "ult") {
+      mask = lessThan(lhs, rhs);
+    } else if (pred == "sgt" || pred == "ugt") {
+      mask = lessThan(rhs, lhs);
+    } else if (pred == "sge" || pred == "uge") {
+      mask = greaterEqual(lhs, rhs);
+    } else if (pred == "sle" || pred == "ule") {
+      mask = greaterEqual(rhs, lhs);
+    } else if (pred == "eq") {
+      Value ge = greaterEqual(lhs, rhs);
+      Value le = greaterEqual(rhs, lhs);
+      mask = rewriter.create<LLVM::AndOp>(loc, ge, le);
+    } else if (pred == "ne") {
+      Value lt = lessThan(lhs, rhs);
+      Value gt = lessThan(rhs, lhs);
+      mask = rewriter.create<LLVM::OrOp>(loc, lt, gt);
+    } else {
+      return failure();
+    }
+
+    Type resultTy = getTypeConverter()->convertType(op.getResult().getType());
+    unsigned maskWidth = cast<IntegerType>(resultTy).getWidth();
+    if (isa<VectorType>(mask.getType()))
+      mask = rewriter.create<LLVM::BitcastOp>(
+          loc, rewriter.getIntegerType(64), mask);
+    unsigned width = mask.getType().getIntOrFloatBitWidth();
+    if (width > maskWidth)
+      mask = rewriter.create<LLVM::TruncOp>(loc, resultTy, mask);
+    else if (width < maskWidth)
+      mask = rewriter.create<LLVM::ZExtOp>(loc, resultTy, mask);
+    rewriter.replaceOp(op, mask);
+    return success();
+  }
+};
+
+class SelOpConversion : public mlir::ConvertOpToLLVMPattern<aievec::SelOp> {
+public:
+  using ConvertOpToLLVMPattern<aievec::SelOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::SelOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto vecTy = cast<VectorType>(op.getResult().getType());
+    if (getVectorSizeInBits(vecTy) != 512)
+      return failure();
+
+    // Selection doesn't look at the values, so select on integers of the same
+    // width.
+    Location loc = op.getLoc();
+    auto intVecTy = getIntegerVectorType(vecTy);
+    unsigned width = getElementSizeInBits(vecTy);
+    Type maskTy = getLaneMaskType(intVecTy);
+    Value mask = adaptor.getSel();
+    unsigned selWidth = mask.getType().getIntOrFloatBitWidth();
+    if (isa<VectorType>(maskTy)) {
+      if (selWidth != 64)
+        mask = rewriter.create<LLVM::ZExtOp>(
+            loc, rewriter.getIntegerType(64), mask);
+      mask = rewriter.create<LLVM::BitcastOp>(loc, maskTy, mask);
+    } else if (selWidth > 32) {
+      mask = rewriter.create<LLVM::TruncOp>(loc, maskTy, mask);
+    } else if (selWidth < 32) {
+      mask = rewriter.create<LLVM::ZExtOp>(loc, maskTy, mask);
+    }
+
+    std::string name = "llvm.aie2.vsel" + std::to_string(width);
+    auto func = getOrInsertIntrinsic(rewriter, op, name, intVecTy,
+                                     {intVecTy, intVecTy, maskTy});
+    auto callOp = rewriter.create<LLVM::CallOp>(
+        loc, func,
+        ValueRange{bitcastIfNeeded(rewriter, loc, adaptor.getLhs(), intVecTy),
+                   bitcastIfNeeded(rewriter, loc, adaptor.getRhs(), intVecTy),
+                   mask});
+    rewriter.replaceOp(
+        op, bitcastIfNeeded(rewriter, loc, callOp.getResult(), vecTy));
+    return success();
+  }
+};
+
+class ShiftOpConversion
+    : public mlir::ConvertOpToLLVMPattern<aievec::ShiftOp> {
+public:
+  using ConvertOpToLLVMPattern<aievec::ShiftOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::ShiftOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto vecTy = cast<VectorType>(op.getResult().getType());
+    if (getVectorSizeInBits(vecTy) != 512 ||
+        getVectorSizeInBits(cast<VectorType>(op.getLhs().getType())) != 512)
+      return failure();
+
+    Location loc = op.getLoc();
+    auto v16i32Ty = VectorType::get({16}, rewriter.getI32Type());
+    auto i32Ty = rewriter.getI32Type();
+    auto func =
+        getOrInsertIntrinsic(rewriter, op, "llvm.aie2.vshift.I512.I512",
+                             v16i32Ty, {v16i32Ty, v16i32Ty, i32Ty, i32Ty});
+    auto stepCst = rewriter.create<LLVM::ConstantOp>(
+        loc, i32Ty, rewriter.getI32IntegerAttr(0));
+    auto callOp = rewriter.create<LLVM::CallOp>(
+        loc, func,
+        ValueRange{bitcastIfNeeded(rewriter, loc, adaptor.getLhs(), v16i32Ty),
+                   bitcastIfNeeded(rewriter, loc, adaptor.getRhs(), v16i32Ty),
+                   stepCst, adaptor.getShift()});
+    rewriter.replaceOp(
+        op, bitcastIfNeeded(rewriter, loc, callOp.getResult(), vecTy));
+    return success();
+  }
+};
+
+class ShuffleOpConversion
+    : public mlir::ConvertOpToLLVMPattern<aievec::ShuffleOp> {
+public:
+  using ConvertOpToLLVMPattern<aievec::ShuffleOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::ShuffleOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto vecTy = cast<VectorType>(op.getResult().getType());
+    if (getVectorSizeInBits(vecTy) != 512 ||
+        getVectorSizeInBits(cast<VectorType>(op.getSource().getType())) !=
+            512)
+      return failure();
+
+    Location loc = op.getLoc();
+    auto v16i32Ty = VectorType::get({16}, rewriter.getI32Type());
+    auto i32Ty = rewriter.getI32Type();
+    auto func = getOrInsertIntrinsic(rewriter, op, "llvm.aie2.vshuffle",
+                                     v16i32Ty, {v16i32Ty, v16i32Ty, i32Ty});
+    auto undef = rewriter.create<LLVM::UndefOp>(loc, v16i32Ty);
+    auto modeCst = rewriter.create<LLVM::ConstantOp>(
+        loc, i32Ty, rewriter.getI32IntegerAttr(op.getMode()));
+    auto callOp = rewriter.create<LLVM::CallOp>(
+        loc, func,
+        ValueRange{
+            bitcastIfNeeded(rewriter, loc, adaptor.getSource(), v16i32Ty),
+            undef, modeCst});
+    rewriter.replaceOp(
+        op, bitcastIfNeeded(rewriter, loc, callOp.getResult(), vecTy));
+    return success();
+  }
+};
+
+class ExtElemOpConversion
+    : public mlir::ConvertOpToLLVMPattern<aievec::ExtElemOp> {
+public:
+  using ConvertOpToLLVMPattern<aievec::ExtElemOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::ExtElemOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto vecTy = cast<VectorType>(op.getSource().getType());
+    Type resultTy = op.getResult().getType();
+    unsigned width = getElementSizeInBits(vecTy);
+    if (getVectorSizeInBits(vecTy) != 512) {
+      rewriter.replaceOpWithNewOp<LLVM::ExtractElementOp>(
+          op, adaptor.getSource(), adaptor.getIndex());
+      return success();
+    }
+
+    // The vextract intrinsics return the element sign-extended to 32 bits.
+    auto intVecTy = getIntegerVectorType(vecTy);
+    auto i32Ty = rewriter.getI32Type();
+    std::string name =
+        "llvm.aie2.vextract.elem" + std::to_string(width) + ".I512";
+    auto func = getOrInsertIntrinsic(rewriter, op, name, i32Ty,
+                                     {intVecTy, i32Ty, i32Ty});
+    auto signCst = rewriter.create<LLVM::ConstantOp>(
+        loc, i32Ty, rewriter.getI32IntegerAttr(1));
+    Value elem =
+        rewriter
+            .create<LLVM::CallOp>(
+                loc, func,
+                ValueRange{bitcastIfNeeded(rewriter, loc, adaptor.getSource(),
+                                           intVecTy),
+                           adaptor.getIndex(), signCst})
+            .getResult();
+    if (width < 32)
+      elem = rewriter.create<LLVM::TruncOp>(
+          loc, rewriter.getIntegerType(width), elem);
+    rewriter.replaceOp(op, bitcastIfNeeded(rewriter, loc, elem, resultTy));
+    return success();
+  }
+};
+
+class NegOpConversion : public mlir::ConvertOpToLLVMPattern<aievec::NegOp> {
+public:
+  using ConvertOpToLLVMPattern<aievec::NegOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(aievec::NegOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto vecTy = cast<VectorType>(op.getResult().getType());
+    if (isa<IntegerType>(vecTy.getElementType())) {
+      Value zero = createSplatBitsConstant(rewriter, loc, vecTy, false);
+      rewriter.replaceOpWithNewOp<LLVM::SubOp>(op, zero, adaptor.getSource());
+      return success();
+    }
+
+    // Negating a float flips its sign bit.
+    auto intVecTy = getIntegerVectorType(vecTy);
+    unsigned width = getElementSizeInBits(vecTy);
+    Value signBits = rewriter.create<LLVM::ConstantOp>(
+        loc, intVecTy,
+        DenseElementsAttr::get(intVecTy, APInt::getSignMask(width)));
+    Value source =
+        bitcastIfNeeded(rewriter, loc, adaptor.getSource(), intVecTy);
+    Value result = rewriter.create<LLVM::XOrOp>(loc, source, signBits);
+    rewriter.replaceOpWithNewOp<LLVM::BitcastOp>(op, vecTy, result);
+    return success();
+  }
+};
+
+// Lowers the bitwise ops, which operate on the bits of their operands
+// regardless of their element type.
+template <typename SrcOpTy, typename DstOpTy>
+class BitwiseOpConversion : public mlir::ConvertOpToLLVMPattern<SrcOpTy> {
+public:
+  using mlir::ConvertOpToLLVMPattern<SrcOpTy>::ConvertOpToLLVMPattern;
+  using OpAdaptor = typename SrcOpTy::Adaptor;
+
+  LogicalResult
+  matchAndRewrite(SrcOpTy op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto vecTy = cast<VectorType>(op.getResult().getType());
+    auto intVecTy = getIntegerVectorType(vecTy);
+    SmallVector<Value, 2> operands;
+    for (Value operand : adaptor.getOperands())
+      operands.push_back(bitcastIfNeeded(rewriter, loc, operand, intVecTy));
+    // bneg is an xor with all ones.
+    if (operands.size() == 1)
+      operands.push_back(
+          createSplatBitsConstant(rewriter, loc, intVecTy, true));
+    Value result = rewriter.create<DstOpTy>(loc, operands[0], operands[1]);
+    rewriter.replaceOp(op, bitcastIfNeeded(rewriter, loc, result, vecTy));
+    return success();
+  }
+};
+
+using BandOpConversion = BitwiseOpConversion<aievec::BandOp, LLVM::AndOp>;
+using BorOpConversion = BitwiseOpConversion<aievec::BorOp, LLVM::OrOp>;
+using BxorOpConversion = BitwiseOpConversion<aievec::BxorOp, LLVM::XOrOp>;
+using BnegOpConversion = BitwiseOpConversion<aievec::BnegOp, LLVM::XOrOp>;
+
 void populateAIEVecToLLVMConversionPatterns(mlir::LLVMTypeConverter &converter,
                                             mlir::RewritePatternSet &patterns) {
   // clang-format off
@@ -901,7 +1600,24 @@ void populateAIEVecToLLVMConversionPatterns(mlir::LLVMTypeConverter &converter,
                UnpackOpConversion,
                BroadcastOpConversion,
                FMAElemOpConversion,
-               MatMulOpConversion>(converter);
+               MatMulOpConversion,
+               MulElemOpConversion,
+               MulConvOpConversion,
+               FMAConvOpConversion,
+               AddElemOpConversion,
+               SubElemOpConversion,
+               MinOpConversion,
+               MaxOpConversion,
+               CmpOpConversion,
+               SelOpConversion,
+               ShiftOpConversion,
+               ShuffleOpConversion,
+               ExtElemOpConversion,
+               NegOpConversion,
+               BandOpConversion,
+               BorOpConversion,
+               BxorOpConversion,
+               BnegOpConversion>(converter);
   // clang-format on
 }
 
@@ -0,0 +1,62 @@
+//===- AIEDeviceIndex.cpp ---------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/IR/AIEDeviceIndex.h"
+
+using namespace mlir;
+using namespace xilinx::AIE;
+
+DeviceIndex::DeviceIndex(Operation *op) {
+  auto device = cast<DeviceOp>(op);
+  for (Operation &child : device.getBody()->getOperations()) {
+    if (auto tile = dyn_cast<TileOp>(child)) {
+      tiles.push_back(tile);
+      tilesByCoord[{tile.colIndex(), tile.rowIndex()}] = tile;
+      tileInfos[tile].tile = tile;
+    } else if (auto buffer = dyn_cast<BufferOp>(child)) {
+      getOrCreateInfo(buffer.getTile()).buffers.push_back(buffer);
+    } else if (auto lock = dyn_cast<LockOp>(child)) {
+      getOrCreateInfo(lock.getTile()).locks.push_back(lock);
+    } else if (auto core = dyn_cast<CoreOp>(child)) {
+      getOrCreateInfo(core.getTile()).core = core;
+    } else if (auto mem = dyn_cast<MemOp>(child)) {
+      getOrCreateInfo(mem.getTile()).mem = mem;
+    } else if (auto memTileDMA = dyn_cast<MemTileDMAOp>(child)) {
+      getOrCreateInfo(memTileDMA.getTile()).memTileDMA = memTileDMA;
+    } else if (auto shimDMA = dyn_cast<ShimDMAOp>(child)) {
+      getOrCreateInfo(shimDMA.getTile()).shimDMA = shimDMA;
+    } else if (auto switchbox = dyn_cast<SwitchboxOp>(child)) {
+      getOrCreateInfo(switchbox.getTile()).switchbox = switchbox;
+    } else if (auto shimMux = dyn_cast<ShimMuxOp>(child)) {
+      getOrCreateInfo(shimMux.getTile()).shimMux = shimMux;
+    } else if (auto alloc = dyn_cast<ShimDMAAllocationOp>(child)) {
+      // Keep the first allocation of a symbol, as a symbol use walk would.
+      shimDMAAllocations.try_emplace(alloc.getSymName(), alloc);
+    }
+  }
+}
+
+DeviceIndex::TileInfo &DeviceIndex::getOrCreateInfo(Value tile) {
+  return tileInfos[tile.getDefiningOp()];
+}
+
+const DeviceIndex::TileInfo &DeviceIndex::getInfo(TileOp tile) const {
+  auto it = tileInfos.find(tile);
+  assert(it != tileInfos.end() && "tile is not part of the indexed device");
+  return it->second;
+}
+
+std::optional<ShimDMAAllocationOp>
+DeviceIndex::getShimDMAAllocation(StringRef symName) const {
+  auto it = shimDMAAllocations.find(symName);
+  if (it == shimDMAAllocations.end())
+    return std::nullopt;
+  return it->second;
+}
@@ -1421,6 +1421,23 @@ LogicalResult xilinx::AIE::DMABDOp::verify() {
                            << std::to_string(memrefSize) << ".";
     }
   }
+
+  if (auto iteration = getIteration()) {
+    if (xilinx::AIE::getTargetModel(getOperation()).getTargetArch() ==
+        xilinx::AIE::AIEArch::AIE1)
+      return emitOpError("iteration is only supported on AIE-ML devices.");
+    // The wrap and the stepsize are encoded minus one, in 6 bits and in 13
+    // bits (17 bits on memtiles) respectively.
+    uint32_t maxStepsize = 1 << 13;
+    if (isa_and_nonnull<xilinx::AIE::MemTileDMAOp>((*this)->getParentOp()))
+      maxStepsize = 1 << 17;
+    if (iteration->getWrap() == 0 || iteration->getWrap() > 64)
+      return emitOpError("iteration wrap must be between 1 and 64.");
+    if (iteration->getStepsize() == 0 ||
+        iteration->getStepsize() > maxStepsize)
+      return emitOpError("iteration stepsize must be between 1 and ")
+             << maxStepsize << ".";
+  }
   return success();
 }
 
@@ -8,14 +8,19 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "aie/Dialect/AIE/IR/AIEDeviceIndex.h"
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
 #include "aie/Dialect/AIE/Transforms/AIEPasses.h"
 
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/PatternMatch.h"
+#include "mlir/Interfaces/CallInterfaces.h"
 #include "mlir/Pass/Pass.h"
 
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/Twine.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
 
 #define DEBUG_TYPE "aie-assign-buffers"
 
@@ -38,6 +43,262 @@ static int64_t assignAddress(AIE::BufferOp op, int64_t lastAddress,
   return endAddr;
 }
 
+static void printMemoryMap(InFlightDiagnostic &error, int stacksize,
+                           ArrayRef<BufferOp> buffers) {
+  auto &note = error.attachNote() << "MemoryMap:\n";
+  auto printbuffer = [&](StringRef name, int address, int size) {
+    note << "\t" << name << " \t"
+         << ": 0x" << llvm::utohexstr(address) << "-0x"
+         << llvm::utohexstr(address + size - 1) << " \t(" << size
+         << " bytes)\n";
+  };
+  if (stacksize > 0)
+    printbuffer("(stack)", 0, stacksize);
+  else
+    error << "(no stack allocated)\n";
+
+  for (auto buffer : buffers) {
+    if (buffer->getAttrOfType<IntegerAttr>("address"))
+      printbuffer(buffer.name(), buffer.address(), buffer.getAllocationSize());
+    else
+      note << "\t" << buffer.name() << " \t: (unallocated) \t("
+           << buffer.getAllocationSize() << " bytes)\n";
+  }
+}
+
+namespace {
+
+// A buffer being placed by the best-fit allocator.
+struct BufferRequest {
+  BufferOp buffer;
+  int64_t size;
+  int64_t alignment;
+  // Range of top-level core operations over which the buffer may be
+  // accessed. Buffers that cannot be analyzed are live throughout.
+  int64_t firstUse = 0;
+  int64_t lastUse = std::numeric_limits<int64_t>::max();
+  // Buffers of the same objectFifo (<fifo>_buff_<i>) form a group whose
+  // members are preferably placed in different banks, so that the core and
+  // the DMA can access the ping and the pong buffer concurrently.
+  StringRef group;
+  // Buffers that a DMA BD iterates over are placed as one block, the buffers
+  // after the first one at multiples of the stride from it.
+  SmallVector<BufferOp> followers;
+  int64_t stride = 0;
+  int64_t address = -1;
+
+  bool isLiveWith(const BufferRequest &other) const {
+    return firstUse <= other.lastUse && other.firstUse <= lastUse;
+  }
+};
+
+} // namespace
+
+// Buffers that can hold a full vector are aligned for vector loads and
+// stores; smaller buffers are aligned to their element type, and at least to
+// a word for the DMA.
+static int64_t getBufferAlignment(BufferOp buffer,
+                                  const AIETargetModel &targetModel) {
+  int64_t vectorBytes =
+      targetModel.getTargetArch() == AIEArch::AIE1 ? 32 : 64;
+  if (buffer.getAllocationSize() >= vectorBytes)
+    return vectorBytes;
+  MemRefType type = buffer.getType().cast<MemRefType>();
+  int64_t elementBytes = llvm::divideCeil(type.getElementTypeBitWidth(), 8);
+  return std::max<int64_t>(4, llvm::PowerOf2Ceil(elementBytes));
+}
+
+static StringRef getFifoGroup(BufferOp buffer) {
+  StringRef name = buffer.name();
+  size_t pos = name.rfind("_buff_");
+  if (pos == StringRef::npos)
+    return {};
+  unsigned index;
+  if (name.substr(pos + strlen("_buff_")).getAsInteger(10, index))
+    return {};
+  return name.substr(0, pos);
+}
+
+// The buffers of an objectFifo that a DMA BD iterates over, in order.
+struct IteratedGroup {
+  int64_t stride;
+  SmallVector<BufferOp> members;
+};
+
+// Find the DMA BDs with an iteration and the buffers they iterate over: the
+// buffer of the BD is <fifo>_buff_0 and each execution moves on to the next
+// buffer of the objectFifo, one stride further.
+static LogicalResult
+collectIteratedGroups(DeviceOp device,
+                      DenseMap<Operation *, IteratedGroup> &groups) {
+  WalkResult result = device.walk([&](DMABDOp bd) {
+    std::optional<DimTupleAttr> iteration = bd.getIteration();
+    if (!iteration)
+      return WalkResult::advance();
+    auto first = dyn_cast_or_null<BufferOp>(bd.getBuffer().getDefiningOp());
+    StringRef group = first ? getFifoGroup(first) : StringRef();
+    if (group.empty() || first.name() != (group + "_buff_0").str()) {
+      bd.emitOpError("iterates over buffers that do not belong to an "
+                     "objectFifo");
+      return WalkResult::interrupt();
+    }
+    IteratedGroup entry{4 * iteration->getStepsize(), {}};
+    for (unsigned i = 0; i < iteration->getWrap(); i++) {
+      auto member = dyn_cast_or_null<BufferOp>(SymbolTable::lookupSymbolIn(
+          device, (group + "_buff_" + Twine(i)).str()));
+      if (!member || member.getTile() != first.getTile() ||
+          member.getAllocationSize() > entry.stride) {
+        bd.emitOpError("cannot place buffer ")
+            << i << " of " << group << " at a stride of " << entry.stride
+            << " bytes";
+        return WalkResult::interrupt();
+      }
+      entry.members.push_back(member);
+    }
+    auto [it, inserted] = groups.try_emplace(first, entry);
+    if (!inserted && (it->second.stride != entry.stride ||
+                      it->second.members.size() != entry.members.size())) {
+      bd.emitOpError("iterates over the buffers of ")
+          << group << " differently from another BD";
+      return WalkResult::interrupt();
+    }
+    return WalkResult::advance();
+  });
+  return failure(result.wasInterrupted());
+}
+
+// Compute the live ranges of the buffers of a tile, in terms of the
+// top-level operations of the core body. A buffer gets a range only if every
+// access to it provably happens in the core of the tile: it is not referenced
+// by symbol, not used by a DMA or another core, and the core calls no
+// function, which could access buffers through their symbols. Views of the
+// buffer count as accesses to it.
+static void computeLiveRanges(DeviceOp device, CoreOp core,
+                              MutableArrayRef<BufferRequest> requests) {
+  if (!core || !core.getBody().hasOneBlock())
+    return;
+  Block &body = core.getBody().front();
+
+  bool hasCalls = false;
+  body.walk([&](CallOpInterface) { hasCalls = true; });
+  if (hasCalls)
+    return;
+
+  DenseMap<Operation *, int64_t> positions;
+  for (auto it : llvm::enumerate(body))
+    positions[&it.value()] = it.index();
+
+  for (auto &request : requests) {
+    if (!SymbolTable::symbolKnownUseEmpty(request.buffer, device))
+      continue;
+    int64_t first = std::numeric_limits<int64_t>::max();
+    int64_t last = -1;
+    bool local = true;
+    SmallVector<Value> worklist{request.buffer.getResult()};
+    while (local && !worklist.empty()) {
+      Value value = worklist.pop_back_val();
+      for (Operation *user : value.getUsers()) {
+        Operation *ancestor = body.findAncestorOpInBlock(*user);
+        if (!ancestor) {
+          local = false;
+          break;
+        }
+        first = std::min(first, positions[ancestor]);
+        last = std::max(last, positions[ancestor]);
+        for (Value result : user->getResults())
+          if (result.getType().isa<MemRefType>())
+            worklist.push_back(result);
+      }
+    }
+    // A buffer without any use may still be touched through its symbol by
+    // code linked into the core, so it is kept live.
+    if (!local || last < 0)
+      continue;
+    request.firstUse = first;
+    request.lastUse = last;
+  }
+}
+
+// Place the buffers of a tile one at a time, largest first. Candidate
+// addresses are the end of the stack, the ends of already placed buffers and
+// the bank boundaries; among the candidates that fit, the one in the
+// smallest free hole wins, and within a hole the lowest address. Buffers
+// whose live ranges do not overlap may share memory.
+static LogicalResult allocateBestFit(SmallVectorImpl<BufferRequest> &requests,
+                                     int64_t stacksize, int64_t memorySize,
+                                     int64_t numBanks) {
+  int64_t bankSize = memorySize / numBanks;
+  auto getBanks = [&](int64_t address, int64_t size) {
+    uint64_t banks = 0;
+    for (int64_t bank = address / bankSize;
+         bank <= (address + size - 1) / bankSize; bank++)
+      banks |= 1ull << bank;
+    return banks;
+  };
+
+  std::stable_sort(requests.begin(), requests.end(),
+                   [](const BufferRequest &a, const BufferRequest &b) {
+                     return a.size > b.size;
+                   });
+
+  SmallVector<BufferRequest *> placed;
+  for (auto &request : requests) {
+    SmallVector<int64_t> candidates{stacksize};
+    for (int64_t bank = 1; bank < numBanks; bank++)
+      candidates.push_back(bank * bankSize);
+    uint64_t siblingBanks = 0;
+    for (auto *other : placed) {
+      candidates.push_back(other->address + other->size);
+      if (!request.group.empty() && other->group == request.group)
+        siblingBanks |= getBanks(other->address, other->size);
+    }
+
+    bool bestPreferred = false;
+    int64_t bestHole = 0;
+    for (int64_t candidate : candidates) {
+      int64_t address = llvm::alignTo(candidate, request.alignment);
+      if (address < stacksize || address + request.size > memorySize)
+        continue;
+      int64_t holeStart = stacksize;
+      int64_t holeEnd = memorySize;
+      bool conflict = false;
+      for (auto *other : placed) {
+        if (!request.isLiveWith(*other))
+          continue;
+        int64_t otherEnd = other->address + other->size;
+        if (address < otherEnd && other->address < address + request.size) {
+          conflict = true;
+          break;
+        }
+        if (otherEnd <= address)
+          holeStart = std::max(holeStart, otherEnd);
+        else
+          holeEnd = std::min(holeEnd, other->address);
+      }
+      if (conflict)
+        continue;
+
+      bool preferred = !(getBanks(address, request.size) & siblingBanks);
+      int64_t hole = holeEnd - holeStart;
+      bool better = request.address < 0 ||
+                    std::make_tuple(!preferred, hole, address) <
+                        std::make_tuple(!bestPreferred, bestHole,
+                                        request.address);
+      if (better) {
+        request.address = address;
+        bestPreferred = preferred;
+        bestHole = hole;
+      }
+    }
+    if (request.address < 0)
+      return failure();
+    LLVM_DEBUG(llvm::dbgs() << "placed " << request.buffer.name() << " at 0x"
+                            << llvm::utohexstr(request.address) << "\n");
+    placed.push_back(&request);
+  }
+  return success();
+}
+
 struct AIEAssignBufferAddressesPass
     : public AIEAssignBufferAddressesBase<AIEAssignBufferAddressesPass> {
   void getDependentDialects(::mlir::DialectRegistry &registry) const override {
@@ -58,52 +319,121 @@ struct AIEAssignBufferAddressesPass
       }
     }
 
-    for (auto tile : device.getOps<TileOp>()) {
+    DenseMap<Operation *, IteratedGroup> groups;
+    if (failed(collectIteratedGroups(device, groups)))
+      return signalPassFailure();
+    DenseSet<Operation *> followers;
+    for (auto &entry : groups)
+      for (auto member : llvm::drop_begin(entry.second.members))
+        followers.insert(member);
+
+    // Only buffer attributes change, so the index stays valid.
+    const auto &index = getAnalysis<DeviceIndex>();
+    markAnalysesPreserved<DeviceIndex>();
+    for (auto tile : index.getTiles()) {
       const auto &targetModel = getTargetModel(tile);
       int max_data_memory_size = 0;
       if (tile.isMemTile())
         max_data_memory_size = targetModel.getMemTileSize();
       else
         max_data_memory_size = targetModel.getLocalMemorySize();
-      SmallVector<BufferOp, 4> buffers;
-      // Collect all the buffers for this tile.
-      for (auto buffer : device.getOps<BufferOp>())
-        if (buffer.getTileOp() == tile)
-          buffers.push_back(buffer);
+      SmallVector<BufferOp, 4> buffers(index.getBuffers(tile));
       // Sort by allocation size.
-      std::sort(buffers.begin(), buffers.end(), [](BufferOp a, BufferOp b) {
-        return a.getAllocationSize() > b.getAllocationSize();
-      });
+      std::stable_sort(buffers.begin(), buffers.end(),
+                       [](BufferOp a, BufferOp b) {
+                         return a.getAllocationSize() > b.getAllocationSize();
+                       });
 
       // Address range owned by the MemTile is 0x80000.
       // Address range owned by the tile is 0x8000,
       // but we need room at the bottom for stack.
       int stacksize = 0;
       int address = 0;
-      if (auto core = tile.getCoreOp()) {
+      CoreOp core = index.getCore(tile);
+      if (core) {
         stacksize = core.getStackSize();
         address += stacksize;
       }
-      for (auto buffer : buffers)
+
+      if (allocScheme == "best-fit") {
+        SmallVector<BufferRequest> requests;
+        for (auto buffer : buffers) {
+          if (followers.contains(buffer))
+            continue;
+          BufferRequest request{buffer, buffer.getAllocationSize(),
+                                getBufferAlignment(buffer, targetModel)};
+          auto it = groups.find(buffer);
+          if (it == groups.end()) {
+            request.group = getFifoGroup(buffer);
+            requests.push_back(request);
+            continue;
+          }
+          const IteratedGroup &group = it->second;
+          for (auto member : group.members) {
+            if (group.stride % getBufferAlignment(member, targetModel) == 0)
+              continue;
+            member.emitOpError("is iterated over at a stride of ")
+                << group.stride << " bytes, which breaks its alignment";
+            return signalPassFailure();
+          }
+          request.followers.assign(std::next(group.members.begin()),
+                                   group.members.end());
+          request.stride = group.stride;
+          request.size = group.stride * (group.members.size() - 1) +
+                         group.members.back().getAllocationSize();
+          requests.push_back(request);
+        }
+        computeLiveRanges(device, core, requests);
+        LogicalResult result = allocateBestFit(
+            requests, stacksize, max_data_memory_size,
+            targetModel.getNumBanks(tile.getCol(), tile.getRow()));
+        for (auto &request : requests) {
+          if (request.address < 0)
+            continue;
+          if (request.buffer->getAttrOfType<IntegerAttr>("address"))
+            request.buffer->emitWarning("Overriding existing address");
+          request.buffer->setAttr(
+              "address", builder.getI32IntegerAttr(request.address));
+          int64_t followerAddress = request.address;
+          for (auto follower : request.followers) {
+            followerAddress += request.stride;
+            follower->setAttr("address",
+                              builder.getI32IntegerAttr(followerAddress));
+          }
+        }
+        if (failed(result)) {
+          for (auto &request : requests)
+            if (request.address < 0)
+              request.buffer->removeAttr("address");
+          InFlightDiagnostic error = tile.emitOpError(
+              "allocated buffers exceeded available memory\n");
+          printMemoryMap(error, stacksize, buffers);
+          return signalPassFailure();
+        }
+        continue;
+      }
+      if (allocScheme != "sequential") {
+        device.emitError("unknown buffer allocation scheme: ") << allocScheme;
+        return signalPassFailure();
+      }
+
+      for (auto buffer : buffers) {
+        if (followers.contains(buffer))
+          continue;
+        int64_t start = address;
         address = assignAddress(buffer, address, builder);
+        auto it = groups.find(buffer);
+        if (it == groups.end())
+          continue;
+        const IteratedGroup &group = it->second;
+        for (int64_t i = 1, e = group.members.size(); i < e; i++)
+          address = assignAddress(group.members[i], start + i * group.stride,
+                                  builder);
+      }
       if (address > max_data_memory_size) {
         InFlightDiagnostic error =
             tile.emitOpError("allocated buffers exceeded available memory\n");
-        auto &note = error.attachNote() << "MemoryMap:\n";
-        auto printbuffer = [&](StringRef name, int address, int size) {
-          note << "\t" << name << " \t"
-               << ": 0x" << llvm::utohexstr(address) << "-0x"
-               << llvm::utohexstr(address + size - 1) << " \t(" << size
-               << " bytes)\n";
-        };
-        if (stacksize > 0)
-          printbuffer("(stack)", 0, stacksize);
-        else
-          error << "(no stack allocated)\n";
-
-        for (auto buffer : buffers)
-          printbuffer(buffer.name(), buffer.address(),
-                      buffer.getAllocationSize());
+        printMemoryMap(error, stacksize, buffers);
         return signalPassFailure();
       }
     }
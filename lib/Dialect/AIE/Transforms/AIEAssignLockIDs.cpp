@@ -8,26 +8,195 @@
 //
 //===----------------------------------------------------------------------===//
 
-// This pass aims to assign lockIDs to AIE.lock operations. The lockID is
-// numbered from the most recent AIE.lock within the same tile. If the lockID
-// exceeds 15 then the pass generates an error and terminates. AIE.lock
-// operations for different tiles are numbered independently. If there are
-// existing lock IDs, this pass is idempotent and only assign lock ids to locks
-// without an ID.
+// This pass aims to assign lockIDs to AIE.lock operations. Existing lock IDs
+// are kept, so the pass is idempotent and only assigns lock ids to locks
+// without an ID. AIE.lock operations for different tiles are numbered
+// independently, up to the number of locks of each tile.
+//
+// Two locks of a tile interfere, and need different IDs, unless a single core
+// uses both of them, one after the other, and the later one starts from the
+// value that the earlier one leaves. Such locks are private to the core: they
+// have no ID or name that code outside the device could refer to, and nothing
+// but the core uses them. All other locks, in particular those used by DMAs
+// or by several cores, are live for the whole run of the design. The
+// interference graph of each tile is colored greedily. A lock that does not
+// fit on its tile and is only used by cores is moved to a neighbouring tile
+// whose memory all those cores share, if one has a lock ID to spare.
 
+#include "aie/Dialect/AIE/IR/AIEDeviceIndex.h"
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
 #include "aie/Dialect/AIE/Transforms/AIEPasses.h"
 
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/Pass/Pass.h"
 
+#include "llvm/ADT/MapVector.h"
+
 #define DEBUG_TYPE "aie-assign-lock-ids"
 
 using namespace mlir;
 using namespace xilinx;
 using namespace xilinx::AIE;
 
+namespace {
+
+// How a lock is used, for deciding which locks may share a lock ID.
+struct LockUsage {
+  LockOp lock;
+  // The cores that use the lock, if nothing else uses it.
+  SmallVector<CoreOp, 2> cores;
+  bool onlyCores = true;
+  // The core the lock is private to, if any, and the range of top-level
+  // operations of its body over which the lock is used.
+  CoreOp owner;
+  int64_t firstUse = 0;
+  int64_t lastUse = 0;
+  // The value of a private lock after its last use, if it can be determined.
+  std::optional<int64_t> finalValue;
+};
+
+} // namespace
+
+// Two locks may share an ID if they are private to the same core, their uses
+// do not overlap and the later one starts from the value that the earlier
+// one leaves. The later one must not have an initial value of its own, since
+// it would be written to the lock when the design is loaded.
+static bool interfere(const LockUsage &a, const LockUsage &b) {
+  if (!a.owner || a.owner != b.owner)
+    return true;
+  const LockUsage *earlier = &a;
+  const LockUsage *later = &b;
+  if (b.lastUse < a.firstUse)
+    std::swap(earlier, later);
+  else if (a.lastUse >= b.firstUse)
+    return true;
+  return earlier->finalValue != 0 || later->lock.getInit().has_value();
+}
+
+// The value of a lock after the operations of a block have run, starting from
+// the given value, or std::nullopt if it cannot be determined. On AIE1 a
+// release sets the value of a lock and an acquire leaves it unchanged; on
+// AIE-ML locks count up on release and down on acquire.
+static std::optional<int64_t> simulateLock(Block &block, Value lock,
+                                           int64_t value, bool isAIE1) {
+  for (Operation &op : block) {
+    if (auto useLock = dyn_cast<UseLockOp>(op)) {
+      if (useLock.getLock() != lock)
+        continue;
+      int64_t lockValue = useLock.getLockValue();
+      if (useLock.release())
+        value = isAIE1 ? lockValue : value + lockValue;
+      else if (useLock.acquireGE() && !isAIE1)
+        value -= lockValue;
+      else if (!useLock.acquire() || !isAIE1)
+        return std::nullopt;
+      continue;
+    }
+
+    bool usesLock = false;
+    op.walk([&](UseLockOp use) {
+      if (use.getLock() == lock)
+        usesLock = true;
+    });
+    if (!usesLock)
+      continue;
+    auto forOp = dyn_cast<scf::ForOp>(op);
+    if (!forOp)
+      return std::nullopt;
+    std::optional<int64_t> lb = getConstantIntValue(forOp.getLowerBound());
+    std::optional<int64_t> ub = getConstantIntValue(forOp.getUpperBound());
+    std::optional<int64_t> step = getConstantIntValue(forOp.getStep());
+    if (!lb || !ub || !step || *step <= 0)
+      return std::nullopt;
+    if (*ub <= *lb)
+      continue;
+    int64_t tripCount = llvm::divideCeil(*ub - *lb, *step);
+    std::optional<int64_t> once =
+        simulateLock(*forOp.getBody(), lock, value, isAIE1);
+    if (!once)
+      return std::nullopt;
+    std::optional<int64_t> twice =
+        simulateLock(*forOp.getBody(), lock, *once, isAIE1);
+    if (!twice)
+      return std::nullopt;
+    // Either the loop leaves the lock as it found it after the first
+    // iteration, or it changes the lock by the same amount in each one.
+    if (*twice == *once)
+      value = *once;
+    else if (*twice - *once == *once - value)
+      value += tripCount * (*once - value);
+    else
+      return std::nullopt;
+  }
+  return value;
+}
+
+static LockUsage analyzeLock(LockOp lock, bool isAIE1,
+                             const DenseMap<Operation *, int64_t> &positions) {
+  LockUsage usage{lock};
+  for (Operation *user : lock->getUsers()) {
+    auto core = user->getParentOfType<CoreOp>();
+    if (!isa<UseLockOp>(user) || !core) {
+      usage.onlyCores = false;
+      continue;
+    }
+    if (!llvm::is_contained(usage.cores, core))
+      usage.cores.push_back(core);
+  }
+  if (!usage.onlyCores)
+    usage.cores.clear();
+
+  if (lock.getLockID() || lock.hasName() || usage.cores.size() != 1)
+    return usage;
+  CoreOp core = usage.cores.front();
+  if (!core.getBody().hasOneBlock())
+    return usage;
+  Block &body = core.getBody().front();
+  usage.firstUse = std::numeric_limits<int64_t>::max();
+  usage.lastUse = -1;
+  for (Operation *user : lock->getUsers()) {
+    int64_t position = positions.lookup(body.findAncestorOpInBlock(*user));
+    usage.firstUse = std::min(usage.firstUse, position);
+    usage.lastUse = std::max(usage.lastUse, position);
+  }
+  usage.owner = core;
+  usage.finalValue =
+      simulateLock(body, lock, lock.getInit().value_or(0), isAIE1);
+  return usage;
+}
+
+static void printTile(raw_ostream &os, TileOp tile) {
+  os << "(" << tile.getCol() << ", " << tile.getRow() << ")";
+}
+
+namespace {
+
+// The locks of a tile, by lock ID.
+struct TileLocks {
+  TileOp tile;
+  unsigned numLocks;
+  SmallVector<SmallVector<LockUsage *>> holders;
+
+  // Give the lock the lowest ID that none of the locks it interferes with
+  // holds.
+  bool assign(LockUsage &usage) {
+    for (unsigned id = 0; id < numLocks; id++) {
+      if (llvm::any_of(holders[id], [&](LockUsage *holder) {
+            return interfere(usage, *holder);
+          }))
+        continue;
+      holders[id].push_back(&usage);
+      return true;
+    }
+    return false;
+  }
+};
+
+} // namespace
+
 struct AIEAssignLockIDsPass
     : public AIEAssignLockIDsBase<AIEAssignLockIDsPass> {
   void getDependentDialects(::mlir::DialectRegistry &registry) const override {
@@ -38,57 +207,154 @@ struct AIEAssignLockIDsPass
 
     DeviceOp device = getOperation();
     OpBuilder rewriter = OpBuilder::atBlockEnd(device.getBody());
+    const auto &targetModel = device.getTargetModel();
+    bool isAIE1 = targetModel.getTargetArch() == AIEArch::AIE1;
+    const auto &index = getAnalysis<DeviceIndex>();
 
-    std::map<Operation *, std::pair<int, std::set<int>>> tileToLastID;
-
-    // The first pass scans for and stores the existing lockIDs. This data is
-    // stored in a map with the lock’s tile operation as the key, while the
-    // value to the key is a pair with the current potential lockID and a set
-    // that stores the currently assigned lockIDs.
-    for (auto lock : device.getOps<LockOp>()) {
-      if (lock.getLockID().has_value()) {
-        Operation *lock_tile = lock.getTile().getDefiningOp();
-        tileToLastID[lock_tile].first = 0;
-        tileToLastID[lock_tile].second.insert(lock.getLockIDValue());
-      }
+    DenseMap<Operation *, int64_t> positions;
+    for (auto core : device.getOps<CoreOp>())
+      if (core.getBody().hasOneBlock())
+        for (auto it : llvm::enumerate(core.getBody().front()))
+          positions[&it.value()] = it.index();
+
+    std::vector<LockUsage> usages;
+    for (auto lock : device.getOps<LockOp>())
+      usages.push_back(analyzeLock(lock, isAIE1, positions));
+
+    llvm::MapVector<Operation *, TileLocks> tiles;
+    for (auto tile : index.getTiles()) {
+      unsigned numLocks = targetModel.getNumLocks(tile.getCol(), tile.getRow());
+      tiles[tile] = {tile, numLocks, {}};
+      tiles[tile].holders.resize(numLocks);
+    }
+
+    // Existing lock IDs are kept. Locks that are live throughout are then
+    // numbered in program order, and private locks in the order of their
+    // first use, which colors each core's intervals optimally.
+    for (auto &usage : usages) {
+      if (!usage.lock.getLockID())
+        continue;
+      TileLocks &tileLocks = tiles[usage.lock.getTile().getDefiningOp()];
+      unsigned id = usage.lock.getLockIDValue();
+      if (tileLocks.holders.size() <= id)
+        tileLocks.holders.resize(id + 1);
+      tileLocks.holders[id].push_back(&usage);
     }
+    SmallVector<LockUsage *> pending;
+    for (auto &usage : usages)
+      if (!usage.lock.getLockID())
+        pending.push_back(&usage);
+    std::stable_sort(pending.begin(), pending.end(),
+                     [](LockUsage *a, LockUsage *b) {
+                       return std::make_pair((bool)a->owner, a->firstUse) <
+                              std::make_pair((bool)b->owner, b->firstUse);
+                     });
 
-    // The second pass scans for locks with no lockIDs and assigns locks.
-    for (auto lock : device.getOps<LockOp>()) {
-      Operation *lock_tile = lock.getTile().getDefiningOp();
-      if (!lock.getLockID().has_value()) {
-        if (tileToLastID.find(lock_tile) == tileToLastID.end()) {
-          // If the tile operation corresponding to the lock does not exist in
-          // the data structure, initialize the lockID with 0 with an empty set.
-          tileToLastID[lock_tile].first = 0;
-        } else if (tileToLastID[lock_tile].first < 15) {
-          // If the tile operation of the lock exists, the potential lockID is
-          // checked with the set containing occupied lockIDs until a lockID
-          // that is free is found.
-          int potential_ID = tileToLastID[lock_tile].first;
-          while (true) {
-            if (tileToLastID[lock_tile].second.find(potential_ID) !=
-                tileToLastID[lock_tile].second.end())
-              potential_ID++;
-            else
-              break;
+    SmallVector<std::pair<LockUsage *, TileOp>> moves;
+    for (LockUsage *usage : pending) {
+      TileOp tile = usage->lock.getTileOp();
+      if (tiles[tile].assign(*usage))
+        continue;
+      // Try the tiles whose memory, and locks, every core using the lock can
+      // access.
+      TileOp neighbour;
+      if (usage->onlyCores && !usage->cores.empty()) {
+        for (auto &[op, tileLocks] : tiles) {
+          if (op == tile ||
+              !llvm::all_of(usage->cores, [&](CoreOp core) {
+                return targetModel.isLegalMemAffinity(
+                    core.colIndex(), core.rowIndex(), tileLocks.tile.getCol(),
+                    tileLocks.tile.getRow());
+              }))
+            continue;
+          if (tileLocks.assign(*usage)) {
+            neighbour = tileLocks.tile;
+            break;
           }
-          tileToLastID[lock_tile].first = potential_ID;
-        } else {
-          lock->emitError() << "Exceeded the number of unique LockIDs";
-          return;
         }
-
-        // The lockID is assigned and is stored in the set.
-        lock->setAttr("lockID", rewriter.getI32IntegerAttr(
-                                    tileToLastID[lock_tile].first));
-        tileToLastID[lock_tile].second.insert(tileToLastID[lock_tile].first);
       }
+      if (!neighbour) {
+        InFlightDiagnostic error =
+            usage->lock->emitError("Exceeded the number of unique LockIDs");
+        error.attachNote(tile.getLoc()) << describePressure(tiles[tile]);
+        return signalPassFailure();
+      }
+      // The lock now refers to the neighbour, which must be defined first.
+      // Tiles have no operands, so the neighbour can always move up.
+      if (usage->lock->isBeforeInBlock(neighbour))
+        neighbour->moveBefore(usage->lock);
+      usage->lock.getTileMutable().assign(neighbour.getResult());
+      moves.push_back({usage, tile});
     }
+
+    for (auto &[op, tileLocks] : tiles)
+      for (auto [id, holders] : llvm::enumerate(tileLocks.holders))
+        for (LockUsage *usage : holders)
+          if (!usage->lock.getLockID())
+            usage->lock->setAttr("lockID", rewriter.getI32IntegerAttr(id));
+
+    // Only lock attributes change, unless locks moved to other tiles.
+    if (moves.empty())
+      markAnalysesPreserved<DeviceIndex>();
+
+    if (!printReport)
+      return;
+    for (auto [usage, from] : moves) {
+      llvm::errs() << "lock moved from tile ";
+      printTile(llvm::errs(), from);
+      llvm::errs() << " to tile ";
+      printTile(llvm::errs(), usage->lock.getTileOp());
+      llvm::errs() << "\n";
+    }
+    for (auto &[op, tileLocks] : tiles) {
+      std::string description = describePressure(tileLocks);
+      if (!description.empty())
+        llvm::errs() << description << "\n";
+    }
+  }
+
+  // Describe how many locks a tile has, on how many lock IDs, and how many
+  // of them are live at once at most, which no assignment can go below.
+  std::string describePressure(const TileLocks &tileLocks) {
+    SmallVector<LockUsage *> locks;
+    for (auto &holders : tileLocks.holders)
+      locks.append(holders.begin(), holders.end());
+    if (locks.empty())
+      return "";
+    unsigned numIDs = llvm::count_if(
+        tileLocks.holders, [](auto &holders) { return !holders.empty(); });
+
+    // Private locks are live together if their cores are different, or if
+    // their ranges overlap.
+    int64_t live = llvm::count_if(
+        locks, [](LockUsage *usage) { return !usage->owner; });
+    DenseMap<Operation *, int64_t> peakPerCore;
+    for (LockUsage *usage : locks) {
+      if (!usage->owner)
+        continue;
+      int64_t overlapping = llvm::count_if(locks, [&](LockUsage *other) {
+        return other->owner == usage->owner &&
+               other->firstUse <= usage->firstUse &&
+               usage->firstUse <= other->lastUse;
+      });
+      int64_t &peak = peakPerCore[usage->owner];
+      peak = std::max(peak, overlapping);
+    }
+    for (auto &entry : peakPerCore)
+      live += entry.second;
+
+    std::string description;
+    llvm::raw_string_ostream os(description);
+    os << "tile ";
+    printTile(os, tileLocks.tile);
+    os << ": " << locks.size() << " locks on " << numIDs << " of "
+       << tileLocks.numLocks << " lock IDs, at most " << live
+       << " live at once";
+    return os.str();
   }
 };
 
 std::unique_ptr<OperationPass<DeviceOp>>
 xilinx::AIE::createAIEAssignLockIDsPass() {
   return std::make_unique<AIEAssignLockIDsPass>();
-}
\ No newline at end of file
+}
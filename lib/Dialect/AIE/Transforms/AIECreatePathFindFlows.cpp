@@ -18,7 +18,13 @@
 #include "mlir/Pass/Pass.h"
 #include "mlir/Tools/mlir-translate/MlirTranslateMain.h"
 #include "mlir/Transforms/DialectConversion.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA256.h"
 
 using namespace mlir;
 using namespace xilinx;
@@ -26,6 +32,9 @@ using namespace xilinx::AIE;
 
 #define DEBUG_TYPE "aie-create-pathfinder-flows"
 
+static constexpr llvm::StringLiteral routingCacheVersion =
+    "aie-routing-cache 1";
+
 std::string stringifyDirs(std::set<Port> dirs) {
   unsigned int count = 0;
   std::string out = "{";
@@ -73,6 +82,12 @@ std::string stringifySwitchSettings(SwitchSettings settings) {
   return out + "\n";
 }
 
+std::string stringifyEndPoint(TileID coords, Port port) {
+  return std::to_string(coords.col) + " " + std::to_string(coords.row) + " " +
+         stringifyWireBundle(port.bundle).str() + " " +
+         std::to_string(port.channel);
+}
+
 // DynamicTileAnalysis integrates the Pathfinder class into the MLIR
 // environment. It passes flows to the Pathfinder as ordered pairs of ints.
 // Detailed routing is received as SwitchboxSettings
@@ -84,6 +99,8 @@ public:
   Pathfinder pathfinder;
   std::map<PathEndPoint, SwitchSettings> flowSolutions;
   std::map<PathEndPoint, bool> processedFlows;
+  bool routingCacheHit = false;
+  bool routingFailed = false;
 
   DenseMap<TileID, TileOp> coordToTile;
   DenseMap<TileID, SwitchboxOp> coordToSwitchbox;
@@ -92,7 +109,10 @@ public:
 
   const int maxIterations = 1000; // how long until declared unroutable
 
-  DynamicTileAnalysis(DeviceOp &d) : device(d) {
+  DynamicTileAnalysis(DeviceOp &d,
+                      const PathfinderOptions &options = PathfinderOptions(),
+                      StringRef routingCacheDir = "")
+      : device(d) {
     LLVM_DEBUG(llvm::dbgs()
                << "\t---Begin DynamicTileAnalysis Constructor---\n");
     // find the maxCol and maxRow
@@ -104,6 +124,10 @@ public:
     }
 
     pathfinder = Pathfinder(maxCol, maxRow, d);
+    pathfinder.setOptions(options);
+
+    // the flows and fixed connections, as keyed by the routing cache
+    std::vector<std::string> routingInputs;
 
     // for each flow in the device, add it to pathfinder
     // each source can map to multiple different destinations (fanout)
@@ -121,6 +145,8 @@ public:
                  << dstCoords.row << ")" << stringifyWireBundle(dstPort.bundle)
                  << dstPort.channel << "\n");
       pathfinder.addFlow(srcCoords, srcPort, dstCoords, dstPort);
+      routingInputs.push_back("flow " + stringifyEndPoint(srcCoords, srcPort) +
+                              " -> " + stringifyEndPoint(dstCoords, dstPort));
     }
 
     // add existing connections so Pathfinder knows which resources are
@@ -130,6 +156,8 @@ public:
         TileID existingCoord = {switchboxOp.colIndex(), switchboxOp.rowIndex()};
         Port existingPort = {connectOp.getDestBundle(),
                              connectOp.getDestChannel()};
+        routingInputs.push_back("fixed " +
+                                stringifyEndPoint(existingCoord, existingPort));
         if (!pathfinder.addFixedConnection(existingCoord, existingPort))
           switchboxOp.emitOpError(
               "Couldn't connect tile (" + std::to_string(existingCoord.col) +
@@ -139,12 +167,35 @@ public:
       }
     }
 
+    // reuse the routing of an earlier run with the same inputs, if any
+    std::string routingCachePath;
+    if (!routingCacheDir.empty()) {
+      routingCachePath = getRoutingCachePath(routingCacheDir, options,
+                                             std::move(routingInputs));
+      routingCacheHit = readRoutingCache(routingCachePath);
+      LLVM_DEBUG(llvm::dbgs() << "Routing cache "
+                              << (routingCacheHit ? "hit: " : "miss: ")
+                              << routingCachePath << "\n");
+    }
+
     // all flows are now populated, call the congestion-aware pathfinder
     // algorithm
     // check whether the pathfinder algorithm creates a legal routing
-    flowSolutions = pathfinder.findPaths(maxIterations);
-    if (!pathfinder.isLegal())
-      d.emitError("Unable to find a legal routing");
+    if (!routingCacheHit) {
+      flowSolutions = pathfinder.findPaths(maxIterations);
+      if (const Flow *flow = pathfinder.getUnroutableFlow()) {
+        d.emitError("Unable to route the flow from (")
+            << flow->src.sb->col << ", " << flow->src.sb->row << ") "
+            << stringifyWireBundle(flow->src.port.bundle) << " : "
+            << flow->src.port.channel << " to all of its destinations";
+        routingFailed = true;
+      } else if (!pathfinder.isLegal()) {
+        d.emitError("Unable to find a legal routing");
+        routingFailed = true;
+      } else if (!routingCachePath.empty()) {
+        writeRoutingCache(routingCachePath);
+      }
+    }
 
     // initialize all flows as unprocessed to prep for rewrite
     for (const auto &[pathEndPoint, switchSetting] : flowSolutions) {
@@ -185,6 +236,123 @@ public:
   int getMaxCol() { return maxCol; }
   int getMaxRow() { return maxRow; }
 
+  // The routing cache stores a legal routing in a file named after a hash of
+  // everything the routing depends on: the target device, the routing
+  // options, the flows and the fixed connections. The flows and connections
+  // are sorted, so reordering the aie.flow operations still hits the cache.
+  std::string getRoutingCachePath(StringRef routingCacheDir,
+                                  const PathfinderOptions &options,
+                                  std::vector<std::string> routingInputs) {
+    llvm::sort(routingInputs);
+    std::string key;
+    llvm::raw_string_ostream os(key);
+    os << routingCacheVersion << "\n"
+       << stringifyAIEDevice(device.getDevice()) << " " << maxCol << " "
+       << maxRow << "\n"
+       << "options " << maxIterations << " " << options.incremental << " "
+       << options.astar << " " << options.boundingBoxMargin << " "
+       << options.steiner << "\n";
+    for (const std::string &input : routingInputs)
+      os << input << "\n";
+
+    auto hash = llvm::SHA256::hash(llvm::arrayRefFromStringRef(os.str()));
+    SmallString<128> path(routingCacheDir);
+    llvm::sys::path::append(path,
+                            llvm::toHex(hash, /*LowerCase=*/true) + ".routing");
+    return std::string(path);
+  }
+
+  // Fill in flowSolutions from a routing cache file. Returns false if the file
+  // does not exist or cannot be parsed.
+  bool readRoutingCache(StringRef path) {
+    auto buffer = llvm::MemoryBuffer::getFile(path);
+    if (!buffer)
+      return false;
+    SmallVector<StringRef> lines;
+    (*buffer)->getBuffer().split(lines, '\n', -1, /*KeepEmpty=*/false);
+    if (lines.empty() || lines.front() != routingCacheVersion)
+      return false;
+
+    auto parseSwitchbox = [&](StringRef col, StringRef row) -> Switchbox * {
+      int c, r;
+      if (col.getAsInteger(10, c) || row.getAsInteger(10, r) || c < 0 ||
+          c > maxCol || r < 0 || r > maxRow)
+        return nullptr;
+      return pathfinder.getSwitchbox({c, r});
+    };
+    auto parsePort = [](StringRef bundle, StringRef channel, Port &port) {
+      auto wireBundle = symbolizeWireBundle(bundle);
+      if (!wireBundle || channel.getAsInteger(10, port.channel))
+        return false;
+      port.bundle = *wireBundle;
+      return true;
+    };
+
+    std::map<PathEndPoint, SwitchSettings> solutions;
+    SwitchSettings *settings = nullptr;
+    for (StringRef line : llvm::drop_begin(lines)) {
+      SmallVector<StringRef, 8> fields;
+      line.split(fields, ' ', -1, /*KeepEmpty=*/false);
+      if (fields.size() < 5)
+        return false;
+      Switchbox *sb = parseSwitchbox(fields[1], fields[2]);
+      Port port;
+      if (!sb || !parsePort(fields[3], fields[4], port))
+        return false;
+      if (fields[0] == "flow" && fields.size() == 5) {
+        settings = &solutions[{sb, port}];
+      } else if (fields[0] == "switchbox" && settings &&
+                 fields.size() % 2 == 1) {
+        SwitchSetting &setting = (*settings)[sb];
+        setting.src = port;
+        for (unsigned i = 5; i < fields.size(); i += 2) {
+          if (!parsePort(fields[i], fields[i + 1], port))
+            return false;
+          setting.dsts.insert(port);
+        }
+      } else {
+        return false;
+      }
+    }
+    flowSolutions = std::move(solutions);
+    return true;
+  }
+
+  // Store flowSolutions in a routing cache file. The file is written under a
+  // temporary name and renamed, so concurrent compilations never read a
+  // partial file. Failures only mean that the next run misses the cache.
+  void writeRoutingCache(StringRef path) {
+    if (llvm::sys::fs::create_directories(llvm::sys::path::parent_path(path)))
+      return;
+    int fd;
+    SmallString<128> tmpPath;
+    if (llvm::sys::fs::createUniqueFile(path + ".%%%%%%.tmp", fd, tmpPath))
+      return;
+    {
+      llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+      os << routingCacheVersion << "\n";
+      for (const auto &[src, settings] : flowSolutions) {
+        os << "flow " << stringifyEndPoint({src.sb->col, src.sb->row}, src.port)
+           << "\n";
+        for (const auto &[sb, setting] : settings) {
+          os << "switchbox "
+             << stringifyEndPoint({sb->col, sb->row}, setting.src);
+          for (const Port &dst : setting.dsts)
+            os << " " << stringifyWireBundle(dst.bundle) << " " << dst.channel;
+          os << "\n";
+        }
+      }
+      os.close();
+      if (os.has_error()) {
+        os.clear_error();
+        llvm::sys::fs::remove(tmpPath);
+        return;
+      }
+    }
+    if (llvm::sys::fs::rename(tmpPath, path))
+      llvm::sys::fs::remove(tmpPath);
+  }
+
   TileOp getTile(OpBuilder &builder, int col, int row) {
     if (coordToTile.count({col, row})) {
       return coordToTile[{col, row}];
@@ -421,7 +589,26 @@ struct AIEPathfinderPass
     LLVM_DEBUG(llvm::dbgs() << "---Begin AIEPathfinderPass---\n");
 
     DeviceOp d = getOperation();
-    DynamicTileAnalysis analyzer(d);
+    PathfinderOptions options;
+    options.numThreads = numThreads;
+    options.incremental = incremental;
+    options.astar = astar;
+    options.boundingBoxMargin = boundingBoxMargin;
+    options.steiner = steiner;
+    DynamicTileAnalysis analyzer(d, options, cacheDir);
+    if (printStats && analyzer.routingCacheHit)
+      llvm::errs() << "Pathfinder routing cache hit\n";
+    if (printStats) {
+      for (const auto &stats : analyzer.pathfinder.getIterationStats())
+        llvm::errs() << "Pathfinder iteration " << stats.iteration
+                     << ": rerouted " << stats.flowsRouted << " flows, "
+                     << stats.overflowedChannels << " channels over capacity, "
+                     << stats.switchboxesExpanded << " switchboxes expanded, "
+                     << stats.channelsUsed << " channels used, "
+                     << llvm::format("%.3f", stats.milliseconds) << " ms\n";
+    }
+    if (analyzer.routingFailed)
+      return signalPassFailure();
     OpBuilder builder = OpBuilder::atBlockEnd(d.getBody());
 
     // Apply rewrite rule to switchboxes to add assignments to every 'connect'
@@ -0,0 +1,347 @@
+//===- AIEObjectFifoDepthSizing.cpp -----------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+//
+// Choose the depth of each objectFifo from the acquire and release operations
+// of the cores that use it, within the memory of the tiles its buffers end up
+// in after aie-objectFifo-stateful-transform.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/IR/AIEDeviceIndex.h"
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+#include "aie/Dialect/AIE/Transforms/AIEPasses.h"
+
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/ADT/MapVector.h"
+
+#define DEBUG_TYPE "aie-objectFifo-depth-sizing"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+// Bytes moved per cycle by a DMA channel over a 32-bit stream.
+static constexpr int64_t streamBytesPerCycle = 4;
+
+namespace {
+
+// How the core of a tile uses one end of an objectFifo.
+struct PortUsage {
+  // Largest number of elements held at once, 0 if the core does not use it.
+  int held = 0;
+  // Largest number of elements released by one pass through a block.
+  int burst = 0;
+  // Elements released over the whole program, if every loop around a release
+  // has a constant trip count.
+  std::optional<int64_t> total = 0;
+};
+
+// The buffers of one end of an objectFifo after the stateful transform. An
+// objectFifo whose ends share memory has a single pool; otherwise the
+// producer and each consumer have their own, connected by DMAs.
+struct Pool {
+  TileOp tile;
+  // Position of the depth of the pool in the elemNumber array.
+  int index;
+  int oldDepth;
+  int depth;
+  // Fewest elements that cannot deadlock.
+  int required;
+  // Fewest elements that do not stall.
+  int ideal;
+};
+
+struct FifoSizing {
+  ObjectFifoCreateOp fifo;
+  int64_t elementBytes;
+  bool shared;
+  std::vector<Pool> pools;
+  // The usage of the producer, then of each consumer.
+  std::vector<PortUsage> usages;
+};
+
+} // namespace
+
+static std::optional<int64_t> getConstantTripCount(scf::ForOp loop) {
+  auto lb = getConstantIntValue(loop.getLowerBound());
+  auto ub = getConstantIntValue(loop.getUpperBound());
+  auto step = getConstantIntValue(loop.getStep());
+  if (!lb || !ub || !step || *step <= 0)
+    return std::nullopt;
+  return *ub > *lb ? (*ub - *lb + *step - 1) / *step : 0;
+}
+
+static PortUsage getPortUsage(DeviceOp device, ObjectFifoCreateOp fifo,
+                              ObjectFifoPort port, TileOp tile) {
+  PortUsage usage;
+  DenseMap<Block *, int> released;
+  for (auto core : device.getOps<CoreOp>()) {
+    if (core.getTileOp() != tile)
+      continue;
+    core.walk([&](Operation *op) {
+      if (auto acqOp = dyn_cast<ObjectFifoAcquireOp>(op)) {
+        if (acqOp.getObjectFifo() == fifo && acqOp.getPort() == port)
+          usage.held = std::max(usage.held, acqOp.acqNumber());
+        return;
+      }
+      auto relOp = dyn_cast<ObjectFifoReleaseOp>(op);
+      if (!relOp || relOp.getObjectFifo() != fifo || relOp.getPort() != port)
+        return;
+      int &inBlock = released[relOp->getBlock()];
+      inBlock += relOp.relNumber();
+      usage.burst = std::max(usage.burst, inBlock);
+      if (!usage.total)
+        return;
+      int64_t count = relOp.relNumber();
+      for (auto loop = relOp->getParentOfType<scf::ForOp>();
+           loop && core->isProperAncestor(loop);
+           loop = loop->getParentOfType<scf::ForOp>()) {
+        auto tripCount = getConstantTripCount(loop);
+        if (!tripCount) {
+          usage.total = std::nullopt;
+          return;
+        }
+        count *= *tripCount;
+      }
+      *usage.total += count;
+    });
+  }
+  return usage;
+}
+
+// Returns the tile that holds the only pool of an objectFifo whose ends share
+// memory, as chosen by the stateful transform, or a null tile if the
+// objectFifo is split into one pool per end.
+static TileOp getSharedPoolTile(ObjectFifoCreateOp fifo) {
+  if (fifo.getConsumerTiles().size() != 1 ||
+      !fifo.getDimensionsToStream().empty())
+    return {};
+  for (DimTupleArrayAttr dims : fifo.getDimensionsFromStreamPerConsumer())
+    if (dims.size() > 0)
+      return {};
+  TileOp producer = fifo.getProducerTileOp();
+  auto consumer = fifo.getConsumerTiles()[0].getDefiningOp<TileOp>();
+  if (producer.isShimTile() || consumer.isShimTile() ||
+      producer.isMemTile() != consumer.isMemTile())
+    return {};
+  const auto &targetModel = getTargetModel(producer);
+  if (targetModel.isLegalMemAffinity(consumer.colIndex(), consumer.rowIndex(),
+                                     producer.colIndex(), producer.rowIndex()))
+    return producer;
+  if (targetModel.isLegalMemAffinity(producer.colIndex(), producer.rowIndex(),
+                                     consumer.colIndex(), consumer.rowIndex()))
+    return consumer;
+  return {};
+}
+
+// The pool of one end of a split objectFifo, used by the given core usage.
+static Pool getEndPool(TileOp tile, int index, int oldDepth,
+                       const PortUsage &usage) {
+  if (tile.isShimTile())
+    return {tile, index, oldDepth, oldDepth, oldDepth, oldDepth};
+  if (tile.isMemTile())
+    return {tile, index, oldDepth, 2, 1, 2};
+  if (usage.held == 0)
+    return {tile, index, oldDepth, oldDepth, oldDepth, oldDepth};
+  int ideal = std::max(usage.held, usage.burst) + 1;
+  return {tile, index, oldDepth, ideal, usage.held, ideal};
+}
+
+static FifoSizing sizeObjectFifo(DeviceOp device, ObjectFifoCreateOp fifo) {
+  FifoSizing sizing;
+  sizing.fifo = fifo;
+  auto elemType = cast<MemRefType>(
+      cast<AIEObjectFifoType>(fifo.getElemType()).getElementType());
+  sizing.elementBytes =
+      elemType.getNumElements() * elemType.getElementTypeBitWidth() / 8;
+
+  TileOp producer = fifo.getProducerTileOp();
+  sizing.usages.push_back(
+      getPortUsage(device, fifo, ObjectFifoPort::Produce, producer));
+  for (auto consumer : fifo.getConsumerTiles())
+    sizing.usages.push_back(getPortUsage(device, fifo, ObjectFifoPort::Consume,
+                                         consumer.getDefiningOp<TileOp>()));
+
+  if (TileOp poolTile = getSharedPoolTile(fifo)) {
+    sizing.shared = true;
+    const PortUsage &prod = sizing.usages[0];
+    const PortUsage &cons = sizing.usages[1];
+    int oldDepth = fifo.size();
+    if (prod.held == 0 || cons.held == 0) {
+      sizing.pools.push_back(
+          {poolTile, 0, oldDepth, oldDepth, oldDepth, oldDepth});
+    } else {
+      // both cores hold their elements at the same time
+      int ideal = std::max(prod.held, prod.burst) +
+                  std::max(cons.held, cons.burst);
+      sizing.pools.push_back({poolTile, 0, oldDepth, ideal,
+                              prod.held + cons.held - 1, ideal});
+    }
+    return sizing;
+  }
+
+  sizing.shared = false;
+  sizing.pools.push_back(
+      getEndPool(producer, 0, fifo.size(0), sizing.usages[0]));
+  for (auto [i, consumer] : llvm::enumerate(fifo.getConsumerTiles())) {
+    int index = i + 1;
+    int oldDepth = isa<ArrayAttr>(fifo.getElemNumber()) ? fifo.size(index)
+                                                         : fifo.size();
+    sizing.pools.push_back(getEndPool(consumer.getDefiningOp<TileOp>(), index,
+                                      oldDepth, sizing.usages[index]));
+  }
+  return sizing;
+}
+
+static void printTile(raw_ostream &os, TileOp tile) {
+  os << "(" << tile.colIndex() << ", " << tile.rowIndex() << ")";
+}
+
+struct AIEObjectFifoDepthSizingPass
+    : AIEObjectFifoDepthSizingBase<AIEObjectFifoDepthSizingPass> {
+  void runOnOperation() override {
+    DeviceOp device = getOperation();
+    const auto &targetModel = device.getTargetModel();
+    // Only the depths of objectFifos change, so the index stays valid.
+    const auto &index = getAnalysis<DeviceIndex>();
+    markAnalysesPreserved<DeviceIndex>();
+
+    std::vector<FifoSizing> sizings;
+    for (auto fifo : device.getOps<ObjectFifoCreateOp>())
+      sizings.push_back(sizeObjectFifo(device, fifo));
+
+    // Fit the pools of each tile in the memory left by its stack and buffers.
+    llvm::MapVector<Operation *, std::vector<std::pair<FifoSizing *, Pool *>>>
+        poolsPerTile;
+    for (auto &sizing : sizings)
+      for (auto &pool : sizing.pools)
+        if (!pool.tile.isShimTile())
+          poolsPerTile[pool.tile].push_back({&sizing, &pool});
+    for (auto &[tileOp, pools] : poolsPerTile) {
+      auto tile = cast<TileOp>(tileOp);
+      int64_t available =
+          tile.isMemTile() ? targetModel.getMemTileSize()
+                           : targetModel.getLocalMemorySize();
+      if (auto core = index.getCore(tile))
+        available -= core.getStackSize();
+      for (auto buffer : index.getBuffers(tile))
+        available -= buffer.getAllocationSize();
+
+      int64_t used = 0;
+      for (auto [sizing, pool] : pools)
+        used += pool->depth * sizing->elementBytes;
+      while (used > available) {
+        std::pair<FifoSizing *, Pool *> largest = {nullptr, nullptr};
+        for (auto candidate : pools)
+          if (candidate.second->depth > candidate.second->required &&
+              (!largest.first ||
+               candidate.first->elementBytes > largest.first->elementBytes))
+            largest = candidate;
+        if (!largest.first) {
+          tile.emitWarning("objectFifo buffers need ")
+              << used << " bytes but only " << available
+              << " bytes of memory are available";
+          break;
+        }
+        largest.second->depth--;
+        used -= largest.first->elementBytes;
+      }
+    }
+
+    OpBuilder builder(device.getContext());
+    for (auto &sizing : sizings) {
+      // an array keeps the transform from recomputing the depth of the ends
+      // of split objectFifos
+      Attribute elemNumber;
+      if (sizing.shared) {
+        elemNumber = builder.getI32IntegerAttr(sizing.pools[0].depth);
+      } else {
+        SmallVector<Attribute> depths;
+        for (auto &pool : sizing.pools)
+          depths.push_back(builder.getI64IntegerAttr(pool.depth));
+        elemNumber = builder.getArrayAttr(depths);
+      }
+      sizing.fifo.setElemNumberAttr(elemNumber);
+    }
+
+    if (printReport)
+      report(llvm::errs(), sizings, index);
+  }
+
+  void report(raw_ostream &os, std::vector<FifoSizing> &sizings,
+              const DeviceIndex &deviceIndex) {
+    for (auto &sizing : sizings) {
+      os << "objectFifo @" << sizing.fifo.name().getValue() << " ("
+         << sizing.elementBytes << " bytes per element)\n";
+      for (auto [index, usage] : llvm::enumerate(sizing.usages)) {
+        if (usage.held == 0)
+          continue;
+        os << "  " << (index == 0 ? "producer " : "consumer ");
+        printTile(os, index == 0 ? sizing.fifo.getProducerTileOp()
+                                 : sizing.fifo.getConsumerTiles()[index - 1]
+                                       .getDefiningOp<TileOp>());
+        os << " holds " << usage.held << ", releases " << usage.burst
+           << " per iteration";
+        if (usage.total)
+          os << ", " << *usage.total << " in total";
+        os << "\n";
+      }
+      for (auto &pool : sizing.pools) {
+        os << "  " << (sizing.shared ? "shared" : "pool") << " on tile ";
+        printTile(os, pool.tile);
+        os << ": depth " << pool.oldDepth << " -> " << pool.depth << "\n";
+        if (pool.depth < pool.ideal)
+          os << "  bottleneck: limited by the memory of the tile, "
+             << pool.ideal << " elements needed to not stall\n";
+      }
+
+      const PortUsage &prod = sizing.usages[0];
+      for (auto &cons : llvm::drop_begin(sizing.usages))
+        if (prod.held && cons.held && prod.total && cons.total &&
+            *prod.total != *cons.total)
+          os << "  bottleneck: producer releases " << *prod.total
+             << " elements but a consumer releases " << *cons.total << "\n";
+    }
+
+    // The objectFifo that moves the most data by DMA per iteration of each
+    // core is the first to limit it when the DMAs cannot keep up.
+    llvm::MapVector<Operation *, std::pair<FifoSizing *, int64_t>> busiest;
+    for (auto &sizing : sizings) {
+      if (sizing.shared)
+        continue;
+      for (auto [index, usage] : llvm::enumerate(sizing.usages)) {
+        TileOp tile = index == 0 ? sizing.fifo.getProducerTileOp()
+                                 : sizing.fifo.getConsumerTiles()[index - 1]
+                                       .getDefiningOp<TileOp>();
+        int64_t bytes = usage.burst * sizing.elementBytes;
+        if (usage.held == 0 || !deviceIndex.getCore(tile))
+          continue;
+        auto it = busiest.find(tile);
+        if (it == busiest.end() || it->second.second < bytes)
+          busiest[tile] = {&sizing, bytes};
+      }
+    }
+    for (auto &[tile, busiestFifo] : busiest) {
+      os << "core ";
+      printTile(os, cast<TileOp>(tile));
+      os << ": @" << busiestFifo.first->fifo.name().getValue() << " moves "
+         << busiestFifo.second << " bytes per iteration by DMA ("
+         << busiestFifo.second / streamBytesPerCycle << " cycles)\n";
+    }
+  }
+};
+
+std::unique_ptr<OperationPass<DeviceOp>>
+xilinx::AIE::createAIEObjectFifoDepthSizingPass() {
+  return std::make_unique<AIEObjectFifoDepthSizingPass>();
+}
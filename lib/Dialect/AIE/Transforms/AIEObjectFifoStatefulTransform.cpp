@@ -171,6 +171,12 @@ struct AIEObjectFifoStatefulTransformPass
   DenseMap<ObjectFifoLinkOp, ObjectFifoCreateOp>
       objFifoLinks; // maps each ObjectFifoLinkOp to objFifo whose elements
                     // have been created and should be used
+  DenseMap<Operation *, DenseMap<std::pair<ObjectFifoCreateOp, int>, int>>
+      rolledLoops; // maps each loop kept rolled to the number of elements
+                   // each objFifo port it uses moves forward per iteration
+  DenseMap<std::tuple<Operation *, int, int>, Value>
+      rotations; // caches the rotation of the objFifos of a rolled loop for
+                 // a given objFifo size and advance per iteration
 
   /// Function that returns true if two tiles in the AIE array share a memory
   /// module. share_direction is equal to:
@@ -809,6 +815,106 @@ struct AIEObjectFifoStatefulTransformPass
     }
   }
 
+  /// Function used to fold a ring of Bd blocks over the buffers of an
+  /// objectFifo into a single Bd block that iterates over them. On AIE-ML,
+  /// the base address of a Bd can advance by a fixed stride each time it is
+  /// executed and all the buffers of an objectFifo share the same pair of
+  /// locks, so the blocks of such a ring only differ by their buffer. The
+  /// buffers are then placed contiguously, at that stride, by
+  /// AIEAssignBufferAddresses. Returns true if the ring was folded.
+  bool foldBdRing(Block *first, int64_t maxStepsize) {
+    SmallVector<Block *> ring;
+    Block *block = first;
+    do {
+      if (ring.size() == 64 || block->getOperations().size() != 4)
+        return false;
+      auto next = dyn_cast<NextBDOp>(block->getTerminator());
+      if (!next)
+        return false;
+      ring.push_back(block);
+      block = next.getDest();
+    } while (block != first);
+    if (ring.size() < 2)
+      return false;
+
+    // Each block is an acquire, a Bd, a release and the next Bd.
+    auto getOps = [](Block *block) {
+      auto it = block->begin();
+      auto acqOp = dyn_cast<UseLockOp>(&*it++);
+      auto bdOp = dyn_cast<DMABDOp>(&*it++);
+      auto relOp = dyn_cast<UseLockOp>(&*it);
+      return std::make_tuple(acqOp, bdOp, relOp);
+    };
+    auto [firstAcq, firstBd, firstRel] = getOps(first);
+    if (!firstAcq || !firstBd || !firstRel)
+      return false;
+    auto firstBuff =
+        dyn_cast_or_null<BufferOp>(firstBd.getBuffer().getDefiningOp());
+    if (!firstBuff || !firstBuff.hasName() ||
+        !firstBuff.name().endswith("_buff_0"))
+      return false;
+    StringRef prefix = firstBuff.name().drop_back();
+
+    for (size_t i = 1; i < ring.size(); i++) {
+      auto [acqOp, bdOp, relOp] = getOps(ring[i]);
+      if (!acqOp || !bdOp || !relOp)
+        return false;
+      if (acqOp.getLock() != firstAcq.getLock() ||
+          acqOp->getAttrDictionary() != firstAcq->getAttrDictionary() ||
+          relOp.getLock() != firstRel.getLock() ||
+          relOp->getAttrDictionary() != firstRel->getAttrDictionary() ||
+          bdOp->getAttrDictionary() != firstBd->getAttrDictionary() ||
+          bdOp.getBuffer().getType() != firstBd.getBuffer().getType())
+        return false;
+      auto buff = dyn_cast_or_null<BufferOp>(bdOp.getBuffer().getDefiningOp());
+      if (!buff || !buff.hasName() ||
+          buff.name() != prefix.str() + std::to_string(i))
+        return false;
+    }
+
+    // Buffers that hold a full vector are aligned to it by the allocator.
+    int64_t elemSize = firstBuff.getAllocationSize();
+    int64_t stride = llvm::alignTo(elemSize, elemSize >= 64 ? 64 : 4);
+    if (stride / 4 > maxStepsize)
+      return false;
+
+    firstBd.setIterationAttr(DimTupleAttr::get(
+        firstBd.getContext(), stride / 4, static_cast<uint16_t>(ring.size())));
+    first->getTerminator()->setSuccessor(first, 0);
+    for (Block *folded : llvm::drop_begin(ring))
+      folded->erase();
+    return true;
+  }
+
+  /// Function used to fold the Bd rings of the DMAs of a device, see
+  /// foldBdRing(). A DMA is compressed when it has more Bd blocks than its
+  /// tile has BDs, or in all cases with the compress-bd-chains option.
+  void compressBdChains(DeviceOp &device) {
+    const auto &targetModel = device.getTargetModel();
+    if (targetModel.getTargetArch() == AIEArch::AIE1)
+      return;
+    auto compress = [&](Operation *dmaOp, int col, int row) {
+      Region &body = dmaOp->getRegion(0);
+      auto hasBd = [](Block &block) {
+        return !block.getOps<DMABDOp>().empty();
+      };
+      if (!compressBds && llvm::count_if(body, hasBd) <=
+                              (int)targetModel.getNumBDs(col, row))
+        return;
+      int64_t maxStepsize = targetModel.isMemTile(col, row) ? 1 << 17 : 1 << 13;
+      SmallVector<DMAStartOp> starts;
+      for (auto &block : body)
+        for (auto start : block.getOps<DMAStartOp>())
+          starts.push_back(start);
+      for (auto start : starts)
+        foldBdRing(start.getDest(), maxStepsize);
+    };
+    for (auto memOp : device.getOps<MemOp>())
+      compress(memOp, memOp.colIndex(), memOp.rowIndex());
+    for (auto memTileDMAOp : device.getOps<MemTileDMAOp>())
+      compress(memTileDMAOp, memTileDMAOp.colIndex(), memTileDMAOp.rowIndex());
+  }
+
   // Function that computes the Least Common Multiplier of the values
   // of a vector.
   int computeLCM(std::set<int> values) {
@@ -935,6 +1041,177 @@ struct AIEObjectFifoStatefulTransformPass
     }
   }
 
+  /// Function that checks whether a loop that contains objectFifo operations
+  /// can be kept rolled, with the elements used by each iteration selected at
+  /// run time. This requires the loop to be the only user of its objFifo
+  /// ports in the core, to be nested in nothing but other loops that are not
+  /// unrolled themselves, and to release in each iteration every element it
+  /// acquires. The loops inside the outermost one must also run the same
+  /// number of iterations every time, as getRotation multiplies their trip
+  /// counts. Fills advance with the number of elements each objFifo port
+  /// moves forward per iteration.
+  bool canKeepLoopRolled(CoreOp coreOp, mlir::scf::ForOp forLoop,
+                         DenseMap<std::pair<ObjectFifoCreateOp, int>, int>
+                             &advance) {
+    Operation *outermost = forLoop;
+    for (Operation *parent = forLoop->getParentOp(); parent != coreOp;
+         parent = parent->getParentOp()) {
+      auto parentLoop = dyn_cast<mlir::scf::ForOp>(parent);
+      if (!parentLoop ||
+          !parentLoop.getBody()->getOps<ObjectFifoAcquireOp>().empty())
+        return false;
+      outermost = parentLoop;
+    }
+    for (Operation *loop = forLoop; loop != outermost;
+         loop = loop->getParentOp()) {
+      auto innerLoop = cast<mlir::scf::ForOp>(loop);
+      for (Value bound : {innerLoop.getLowerBound(), innerLoop.getUpperBound(),
+                          innerLoop.getStep()})
+        if (!bound.getDefiningOp<arith::ConstantOp>() &&
+            outermost->isAncestor(bound.getParentBlock()->getParentOp()))
+          return false;
+    }
+
+    // simulate one iteration: an acquire only takes the elements that are not
+    // held yet
+    DenseMap<std::pair<ObjectFifoCreateOp, int>, int> held;
+    for (Operation &op : forLoop.getBody()->without_terminator()) {
+      if (auto acqOp = dyn_cast<ObjectFifoAcquireOp>(op)) {
+        auto portNum = (acqOp.getPort() == ObjectFifoPort::Produce) ? 0 : 1;
+        int &numHeld = held[{acqOp.getObjectFifo(), portNum}];
+        advance[{acqOp.getObjectFifo(), portNum}] +=
+            std::max(0, acqOp.acqNumber() - numHeld);
+        numHeld = std::max(numHeld, acqOp.acqNumber());
+      } else if (auto relOp = dyn_cast<ObjectFifoReleaseOp>(op)) {
+        auto portNum = (relOp.getPort() == ObjectFifoPort::Produce) ? 0 : 1;
+        held[{relOp.getObjectFifo(), portNum}] -= relOp.relNumber();
+      }
+    }
+    for (auto &it : held)
+      if (it.second != 0)
+        return false;
+
+    // every other operation on these objFifo ports would need to know how
+    // far the loop has moved them, and operations on other objFifos in
+    // nested regions would be unrolled with the loop
+    bool onlyUser = true;
+    coreOp.walk([&](Operation *op) {
+      std::pair<ObjectFifoCreateOp, int> key;
+      if (auto acqOp = dyn_cast<ObjectFifoAcquireOp>(op))
+        key = {acqOp.getObjectFifo(),
+               (acqOp.getPort() == ObjectFifoPort::Produce) ? 0 : 1};
+      else if (auto relOp = dyn_cast<ObjectFifoReleaseOp>(op))
+        key = {relOp.getObjectFifo(),
+               (relOp.getPort() == ObjectFifoPort::Produce) ? 0 : 1};
+      else
+        return;
+      bool inLoop = forLoop->isAncestor(op);
+      if ((held.count(key) || inLoop) && op->getParentOp() != forLoop)
+        onlyUser = false;
+    });
+    return onlyUser;
+  }
+
+  /// Function that returns the number of elements, modulo its size, by which
+  /// an objFifo port used by a loop kept rolled has moved before the current
+  /// iteration of the loop, or a null value if the elements used by the loop
+  /// are the same in every iteration. This is the number of iterations so
+  /// far, counted across the loops that enclose it, times the number of
+  /// elements the port moves per iteration. Intermediate values are kept
+  /// modulo the size so that they cannot overflow in long running loops.
+  Value getRotation(OpBuilder &builder, Operation *user, ObjectFifoCreateOp op,
+                    int portNum) {
+    auto rolledLoop = rolledLoops.find(user->getParentOp());
+    if (rolledLoop == rolledLoops.end())
+      return nullptr;
+    int size = op.size();
+    int advance = rolledLoop->second[{op, portNum}] % std::max(size, 1);
+    if (advance == 0)
+      return nullptr;
+    auto key = std::make_tuple(rolledLoop->first, size, advance);
+    if (rotations.find(key) != rotations.end())
+      return rotations[key];
+
+    OpBuilder::InsertionGuard guard(builder);
+    auto forLoop = cast<mlir::scf::ForOp>(rolledLoop->first);
+    builder.setInsertionPointToStart(forLoop.getBody());
+    auto loc = builder.getUnknownLoc();
+    auto constant = [&](int64_t value) -> Value {
+      return builder.create<arith::ConstantOp>(loc,
+                                               builder.getIndexAttr(value));
+    };
+    Value sizeValue = constant(size);
+    SmallVector<mlir::scf::ForOp> loops;
+    for (Operation *loop = forLoop; isa<mlir::scf::ForOp>(loop);
+         loop = loop->getParentOp())
+      loops.push_back(cast<mlir::scf::ForOp>(loop));
+
+    // iterations so far, from the outermost loop inwards
+    Value iteration = constant(0);
+    for (auto loop : llvm::reverse(loops)) {
+      if (loop != loops.back()) {
+        Value tripCount = builder.create<arith::CeilDivUIOp>(
+            loc,
+            builder.create<arith::SubIOp>(loc, loop.getUpperBound(),
+                                          loop.getLowerBound()),
+            loop.getStep());
+        iteration = builder.create<arith::MulIOp>(
+            loc, iteration,
+            builder.create<arith::RemUIOp>(loc, tripCount, sizeValue));
+      }
+      Value current = builder.create<arith::DivUIOp>(
+          loc,
+          builder.create<arith::SubIOp>(loc, loop.getInductionVar(),
+                                        loop.getLowerBound()),
+          loop.getStep());
+      iteration = builder.create<arith::RemUIOp>(
+          loc,
+          builder.create<arith::AddIOp>(
+              loc, iteration,
+              builder.create<arith::RemUIOp>(loc, current, sizeValue)),
+          sizeValue);
+    }
+    Value rotation = builder.create<arith::RemUIOp>(
+        loc, builder.create<arith::MulIOp>(loc, iteration, constant(advance)),
+        sizeValue);
+    rotations[key] = rotation;
+    return rotation;
+  }
+
+  /// Function that creates an scf.index_switch on the element of an objFifo
+  /// that is at the given index once the objFifo has been rotated. The switch
+  /// has a case for each element, the last one being the default, and
+  /// buildCase is called in each case with the element it stands for.
+  mlir::scf::IndexSwitchOp
+  createElementSwitch(OpBuilder &builder, Value rotation, int index, int size,
+                      TypeRange resultTypes,
+                      function_ref<void(int)> buildCase) {
+    auto loc = builder.getUnknownLoc();
+    Value element = rotation;
+    if (index != 0) {
+      Value offset =
+          builder.create<arith::ConstantOp>(loc, builder.getIndexAttr(index));
+      Value sizeValue =
+          builder.create<arith::ConstantOp>(loc, builder.getIndexAttr(size));
+      element = builder.create<arith::RemUIOp>(
+          loc, builder.create<arith::AddIOp>(loc, rotation, offset),
+          sizeValue);
+    }
+    SmallVector<int64_t> cases(size - 1);
+    std::iota(cases.begin(), cases.end(), 0);
+    auto switchOp = builder.create<mlir::scf::IndexSwitchOp>(
+        loc, resultTypes, element, builder.getDenseI64ArrayAttr(cases),
+        size - 1);
+    OpBuilder::InsertionGuard guard(builder);
+    for (int i = 0; i < size; i++) {
+      Region &region = (i < size - 1) ? switchOp.getCaseRegions()[i]
+                                      : switchOp.getDefaultRegion();
+      builder.createBlock(&region);
+      buildCase(i);
+    }
+    return switchOp;
+  }
+
   // Function that unrolls for-loops that contain objectFifo operations.
   void unrollForLoops(DeviceOp &device, OpBuilder &builder,
                       std::set<TileOp> objectFifoTiles) {
@@ -960,6 +1237,25 @@ struct AIEObjectFifoStatefulTransformPass
           unrollFactor =
               computeLCM(objFifoSizes); // also counts original loop body
 
+          DenseMap<std::pair<ObjectFifoCreateOp, int>, int> advance;
+          if (found && dynamicObjFifos &&
+              canKeepLoopRolled(coreOp, forLoop, advance)) {
+            rolledLoops[forLoop] = advance;
+            return;
+          }
+
+          bool constantBounds = llvm::all_of(
+              ValueRange{forLoop.getLowerBound(), forLoop.getUpperBound(),
+                         forLoop.getStep()},
+              [](Value bound) {
+                return bound.getDefiningOp<arith::ConstantOp>() != nullptr;
+              });
+          if (found && !constantBounds) {
+            forLoop->emitOpError("with objectFifo operations must have "
+                                 "constant bounds to be unrolled");
+            return;
+          }
+
           if (found) {
             std::vector<Operation *>
                 operations; // operations in original loop body, without
@@ -1051,11 +1347,12 @@ struct AIEObjectFifoStatefulTransformPass
   /// Function used to create a UseLockOp based on input parameters.
   /// acc is an accumulator map that tracks the indices of the next locks to
   /// acquire (or release). Uses op to find index of acc for next lockID.
-  /// Updates acc.
+  /// Updates acc. user is the acquire or release operation being replaced.
   void createUseLocks(OpBuilder &builder, ObjectFifoCreateOp op,
                       ObjectFifoPort port,
                       DenseMap<std::pair<ObjectFifoCreateOp, int>, int> &acc,
-                      int numLocks, LockAction lockAction) {
+                      int numLocks, LockAction lockAction,
+                      Operation *user) {
     ObjectFifoCreateOp target = op;
     auto portNum = (port == ObjectFifoPort::Produce) ? 0 : 1;
     auto linkOp = getOptionalLinkOp(op);
@@ -1072,11 +1369,24 @@ struct AIEObjectFifoStatefulTransformPass
           (port == ObjectFifoPort::Consume &&
            lockAction == LockAction::Acquire))
         lockMode = 1;
+      // in a loop kept rolled, the lock is selected at run time
+      Value rotation = getRotation(builder, user, op, portNum);
       for (int i = 0; i < numLocks; i++) {
         int lockID = acc[{op, portNum}];
-        builder.create<UseLockOp>(builder.getUnknownLoc(),
-                                  locksPerFifo[target][lockID], lockMode,
-                                  lockAction);
+        if (rotation)
+          createElementSwitch(builder, rotation, lockID, op.size(), {},
+                              [&](int element) {
+                                builder.create<UseLockOp>(
+                                    builder.getUnknownLoc(),
+                                    locksPerFifo[target][element], lockMode,
+                                    lockAction);
+                                builder.create<mlir::scf::YieldOp>(
+                                    builder.getUnknownLoc());
+                              });
+        else
+          builder.create<UseLockOp>(builder.getUnknownLoc(),
+                                    locksPerFifo[target][lockID], lockMode,
+                                    lockAction);
         acc[{op, portNum}] =
             (lockID + 1) % op.size(); // update to next objFifo elem
       }
@@ -1391,6 +1701,7 @@ struct AIEObjectFifoStatefulTransformPass
                                WireBundle::DMA, consumerChan.channel);
       }
     }
+    compressBdChains(device);
 
     //===------------------------------------------------------------------===//
     // Unroll for loops
@@ -1404,6 +1715,8 @@ struct AIEObjectFifoStatefulTransformPass
       DenseMap<ObjectFifoAcquireOp, std::vector<BufferOp *>>
           subviews; // maps each "subview" to its buffer references (subviews
                     // are created by AcquireOps)
+      DenseMap<ObjectFifoAcquireOp, std::vector<int>>
+          subviewIndices; // maps each "subview" to the indices of its buffers
       DenseMap<std::pair<ObjectFifoCreateOp, int>, std::vector<int>>
           acquiresPerFifo; // maps each objFifo to indices of buffers acquired
                            // in latest subview of that objFifo (useful to
@@ -1444,7 +1757,7 @@ struct AIEObjectFifoStatefulTransformPass
         // release locks
         int numLocks = releaseOp.relNumber();
         createUseLocks(builder, op, port, relPerFifo, numLocks,
-                       LockAction::Release);
+                       LockAction::Release, releaseOp);
 
         // register release op
         if (releaseOps.find({op, portNum}) != releaseOps.end()) {
@@ -1578,10 +1891,10 @@ struct AIEObjectFifoStatefulTransformPass
         auto &targetArch = dev.getTargetModel();
         if (targetArch.getTargetArch() == xilinx::AIE::AIEArch::AIE1)
           createUseLocks(builder, op, port, acqPerFifo, numCreate,
-                         LockAction::Acquire);
+                         LockAction::Acquire, acquireOp);
         else
           createUseLocks(builder, op, port, acqPerFifo, numCreate,
-                         LockAction::AcquireGreaterEqual);
+                         LockAction::AcquireGreaterEqual, acquireOp);
 
         // if objFifo was linked with others, find which objFifos
         // elements to use
@@ -1600,6 +1913,7 @@ struct AIEObjectFifoStatefulTransformPass
           subviewRefs.push_back(&buffersPerFifo[target][index]);
 
         subviews[acquireOp] = subviewRefs;
+        subviewIndices[acquireOp] = acquiredIndices;
         acquiresPerFifo[{op, portNum}] = acquiredIndices;
       });
 
@@ -1616,6 +1930,21 @@ struct AIEObjectFifoStatefulTransformPass
                                 "ObjectFifoLinkOp");
           return;
         }
+        auto portNum = (acqOp.getPort() == ObjectFifoPort::Produce) ? 0 : 1;
+        if (Value rotation = getRotation(builder, acqOp, op, portNum)) {
+          // in a loop kept rolled, select the buffer at run time
+          builder.setInsertionPoint(accessOp);
+          int index = subviewIndices[acqOp][accessOp.getIndex()];
+          auto switchOp = createElementSwitch(
+              builder, rotation, index, op.size(),
+              accessOp.getOutput().getType(), [&](int element) {
+                builder.create<mlir::scf::YieldOp>(
+                    builder.getUnknownLoc(),
+                    buffersPerFifo[op][element].getBuffer());
+              });
+          accessOp.getOutput().replaceAllUsesWith(switchOp.getResult(0));
+          return;
+        }
         accessOp.getOutput().replaceAllUsesWith(
             subviews[acqOp][accessOp.getIndex()]->getBuffer());
       });
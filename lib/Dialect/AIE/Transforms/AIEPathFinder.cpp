@@ -10,9 +10,14 @@
 
 #include "aie/Dialect/AIE/Transforms/AIEPathFinder.h"
 
+#include "mlir/IR/Threading.h"
+
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/raw_os_ostream.h"
 
+#include <chrono>
+
 using namespace mlir;
 using namespace xilinx;
 using namespace xilinx::AIE;
@@ -88,6 +93,28 @@ Pathfinder::Pathfinder(int maxCol, int maxRow, DeviceOp &d) {
     edge.overCapacityCount = 0;
   }
 
+  // build the dense view of the graph; grid is ordered by (col, row), so
+  // switchboxes are visited in index order
+  numCols = maxCol + 1;
+  numRows = maxRow + 1;
+  switchboxes.clear();
+  outChannelOffsets.clear();
+  outChannels.clear();
+  outChannelTargets.clear();
+  for (auto &[coords, sb] : grid) {
+    assert(getSwitchboxIndex(coords.col, coords.row) == switchboxes.size());
+    switchboxes.push_back(&sb);
+    outChannelOffsets.push_back(outChannels.size());
+    for (Channel *ch : sb.getEdges()) {
+      outChannels.push_back(ch);
+      outChannelTargets.push_back(getSwitchboxIndex(&ch->getTargetNode()));
+    }
+  }
+  outChannelOffsets.push_back(outChannels.size());
+
+  context = d->getContext();
+  setOptions(PathfinderOptions());
+
   // initialize maximum iterations flag
   Pathfinder::maxIterReached = false;
 }
@@ -96,91 +123,330 @@ Pathfinder::Pathfinder(int maxCol, int maxRow, DeviceOp &d) {
 // to fanout.
 void Pathfinder::addFlow(TileID srcCoords, Port srcPort, TileID dstCoords,
                          Port dstPort) {
+  Switchbox *srcSb = getSwitchbox(srcCoords);
+  Switchbox *dstSb = getSwitchbox(dstCoords);
+
   // check if a flow with this source already exists
   for (auto &flow : flows) {
-    Switchbox *existingSrc = flow.src.sb;
-    assert(existingSrc && "nullptr flow source");
-    Port existingPort = flow.src.port;
-    if (existingSrc->col == srcCoords.col &&
-        existingSrc->row == srcCoords.row && existingPort == srcPort) {
-      // find the vertex corresponding to the destination
-      auto matchingSb =
-          std::find_if(graph.begin(), graph.end(), [&](const Switchbox *sb) {
-            return sb->col == dstCoords.col && sb->row == dstCoords.row;
-          });
-      assert(matchingSb != graph.end() && "didn't find flow dest");
-      flow.dsts.push_back({*matchingSb, dstPort});
+    assert(flow.src.sb && "nullptr flow source");
+    if (flow.src.sb == srcSb && flow.src.port == srcPort) {
+      flow.dsts.push_back({dstSb, dstPort});
       return;
     }
   }
 
   // If no existing flow was found with this source, create a new flow.
-  auto matchingSrcSb =
-      std::find_if(graph.begin(), graph.end(), [&](const Switchbox *sb) {
-        return sb->col == srcCoords.col && sb->row == srcCoords.row;
-      });
-  assert(matchingSrcSb != graph.end() && "didn't find flow source");
-  auto matchingDstSb =
-      std::find_if(graph.begin(), graph.end(), [&](const Switchbox *sb) {
-        return sb->col == dstCoords.col && sb->row == dstCoords.row;
-      });
-  assert(matchingDstSb != graph.end() && "didn't add flow destinations");
-  flows.push_back({PathEndPoint{*matchingSrcSb, srcPort},
-                   std::vector<PathEndPoint>{{*matchingDstSb, dstPort}}});
+  flows.push_back({PathEndPoint{srcSb, srcPort},
+                   std::vector<PathEndPoint>{{dstSb, dstPort}}});
 }
 
 // Keep track of connections already used in the AIE; Pathfinder algorithm will
 // avoid using these.
 bool Pathfinder::addFixedConnection(TileID coords, Port port) {
-  // find the correct Channel and indicate the fixed direction
-  auto matchingCh = std::find_if(edges.begin(), edges.end(), [&](Channel &ch) {
-    return ch.src.col == coords.col && ch.src.row == coords.row &&
-           ch.bundle == port.bundle;
-  });
-  if (matchingCh == edges.end())
+  if (coords.col < 0 || coords.col >= numCols || coords.row < 0 ||
+      coords.row >= numRows)
     return false;
 
-  matchingCh->fixedCapacity.insert(port.channel);
-  return true;
+  // find the correct Channel and indicate the fixed direction
+  unsigned idx = getSwitchboxIndex(coords.col, coords.row);
+  for (unsigned e = outChannelOffsets[idx]; e < outChannelOffsets[idx + 1];
+       e++) {
+    if (outChannels[e]->bundle == port.bundle) {
+      outChannels[e]->fixedCapacity.insert(port.channel);
+      return true;
+    }
+  }
+  return false;
 }
 
 static constexpr double INF = std::numeric_limits<double>::max();
 
-std::map<Switchbox *, Switchbox *>
-dijkstraShortestPaths(const SwitchboxGraph &graph, Switchbox *src) {
-  // Use std::map instead of DenseMap because DenseMap doesn't let you overwrite
-  // tombstones.
-  auto demand = std::map<Switchbox *, double>();
-  auto preds = std::map<Switchbox *, Switchbox *>();
-  for (Switchbox *sb : graph)
-    demand.emplace(sb, INF);
-  demand[src] = 0.0;
-  auto cmp = [](const std::pair<double, Switchbox *> &p1,
-                const std::pair<double, Switchbox *> &p2) {
-    return std::fabs(p1.first - p2.first) <
-                   std::numeric_limits<double>::epsilon()
-               ? std::less<Switchbox *>()(p1.second, p2.second)
-               : p1.first < p2.first;
-  };
-  std::set<std::pair<double, Switchbox *>, decltype(cmp)> priorityQueue(cmp);
-  priorityQueue.insert({demand[src], src});
+bool SwitchboxQueue::lessThan(const std::pair<double, unsigned> &a,
+                              const std::pair<double, unsigned> &b) {
+  return std::fabs(a.first - b.first) < std::numeric_limits<double>::epsilon()
+             ? a.second < b.second
+             : a.first < b.first;
+}
+
+void SwitchboxQueue::siftUp(unsigned pos) {
+  auto entry = heap[pos];
+  while (pos > 0) {
+    unsigned parent = (pos - 1) / 2;
+    if (!lessThan(entry, heap[parent]))
+      break;
+    heap[pos] = heap[parent];
+    position[heap[pos].second] = pos;
+    pos = parent;
+  }
+  heap[pos] = entry;
+  position[entry.second] = pos;
+}
+
+void SwitchboxQueue::siftDown(unsigned pos) {
+  auto entry = heap[pos];
+  unsigned size = heap.size();
+  while (2 * pos + 1 < size) {
+    unsigned child = 2 * pos + 1;
+    if (child + 1 < size && lessThan(heap[child + 1], heap[child]))
+      child++;
+    if (!lessThan(heap[child], entry))
+      break;
+    heap[pos] = heap[child];
+    position[heap[pos].second] = pos;
+    pos = child;
+  }
+  heap[pos] = entry;
+  position[entry.second] = pos;
+}
+
+void SwitchboxQueue::reset(unsigned numSwitchboxes) {
+  heap.clear();
+  heap.reserve(numSwitchboxes);
+  position.assign(numSwitchboxes, -1);
+}
+
+void SwitchboxQueue::update(unsigned idx, double distance) {
+  if (position[idx] < 0) {
+    heap.emplace_back(distance, idx);
+    siftUp(heap.size() - 1);
+  } else {
+    heap[position[idx]].first = distance;
+    siftUp(position[idx]);
+  }
+}
+
+unsigned SwitchboxQueue::pop() {
+  assert(!heap.empty() && "pop from empty queue");
+  unsigned idx = heap.front().second;
+  position[idx] = -1;
+  auto last = heap.back();
+  heap.pop_back();
+  if (!heap.empty()) {
+    heap.front() = last;
+    siftDown(0);
+  }
+  return idx;
+}
 
-  while (!priorityQueue.empty()) {
-    src = priorityQueue.begin()->second;
-    priorityQueue.erase(priorityQueue.begin());
-    for (Channel *e : src->getEdges()) {
-      Switchbox *dst = &e->getTargetNode();
-      if (demand[src] + e->demand < demand[dst]) {
-        priorityQueue.erase({demand[dst], dst});
+void Pathfinder::resizeSearchState(SearchState &state) {
+  state.distances.resize(switchboxes.size());
+  state.predChannels.resize(switchboxes.size());
+  state.queue.reset(switchboxes.size());
+  state.isTarget.assign(switchboxes.size(), false);
+  state.inTree.assign(switchboxes.size(), false);
+}
 
-        demand[dst] = demand[src] + e->demand;
-        preds[dst] = src;
+void Pathfinder::setOptions(const PathfinderOptions &value) {
+  options = value;
+  searchStates.resize(std::max(options.numThreads, 1u));
+  for (auto &state : searchStates)
+    resizeSearchState(state);
+}
 
-        priorityQueue.insert({demand[dst], dst});
+// Find the routing tree of a flow given the current demands, leaving its
+// channels in state.path. Only reads the channels, so flows with distinct
+// states can be routed concurrently. Fails if a destination of the flow can't
+// be reached.
+LogicalResult Pathfinder::routeFlow(const Flow &flow,
+                                    SearchState &state) const {
+  state.path.clear();
+  state.treeNodes.clear();
+  unsigned srcIdx = getSwitchboxIndex(flow.src.sb);
+  state.inTree[srcIdx] = true;
+  state.treeNodes.push_back(srcIdx);
+  unsigned numTargets = 0;
+  for (const PathEndPoint &endPoint : flow.dsts) {
+    unsigned idx = getSwitchboxIndex(endPoint.sb);
+    if (!state.isTarget[idx] && !state.inTree[idx]) {
+      state.isTarget[idx] = true;
+      numTargets++;
+    }
+  }
+
+  bool reached = true;
+  if (options.steiner && numTargets > 1) {
+    // grow the tree one destination at a time, searching from every
+    // switchbox already in the tree
+    while (numTargets > 0 && findShortestPaths(flow, state, 1))
+      numTargets -= tracePath(state, state.lastTarget);
+    reached = numTargets == 0;
+  } else if (numTargets > 0) {
+    // a single search from the source; trace each destination back until a
+    // switchbox already in the tree is reached
+    reached = findShortestPaths(flow, state, numTargets);
+    if (reached)
+      for (const PathEndPoint &endPoint : flow.dsts)
+        tracePath(state, getSwitchboxIndex(endPoint.sb));
+  }
+
+  for (unsigned idx : state.treeNodes)
+    state.inTree[idx] = false;
+  for (const PathEndPoint &endPoint : flow.dsts)
+    state.isTarget[getSwitchboxIndex(endPoint.sb)] = false;
+  return success(reached);
+}
+
+// Add the path from switchbox idx back to the routing tree to the tree, using
+// the predecessors of the last search. Returns the number of destinations that
+// were connected to the tree.
+unsigned Pathfinder::tracePath(SearchState &state, unsigned idx) const {
+  unsigned connected = 0;
+  while (!state.inTree[idx]) {
+    Channel *ch = state.predChannels[idx];
+    assert(ch && "couldn't find ch");
+    state.path.push_back(ch);
+    state.inTree[idx] = true;
+    state.treeNodes.push_back(idx);
+    if (state.isTarget[idx]) {
+      state.isTarget[idx] = false;
+      connected++;
+    }
+    idx = getSwitchboxIndex(&ch->src);
+  }
+  return connected;
+}
+
+// Find the shortest paths from the routing tree of a flow to the nearest
+// numTargets unconnected destinations, using demand as the channel weights. The
+// result is left in state.predChannels, which holds the last channel on the
+// shortest path to each switchbox reached (nullptr if it is in the tree or was
+// not reached). Returns true if numTargets destinations were reached.
+bool Pathfinder::findShortestPaths(const Flow &flow, SearchState &state,
+                                   unsigned numTargets) const {
+  int margin = options.boundingBoxMargin;
+  if (margin < 0)
+    return searchInBox(flow, state, numTargets, 0, numCols - 1, 0,
+                       numRows - 1);
+
+  int minCol = flow.src.sb->col, maxCol = flow.src.sb->col;
+  int minRow = flow.src.sb->row, maxRow = flow.src.sb->row;
+  for (const PathEndPoint &endPoint : flow.dsts) {
+    minCol = std::min(minCol, endPoint.sb->col);
+    maxCol = std::max(maxCol, endPoint.sb->col);
+    minRow = std::min(minRow, endPoint.sb->row);
+    maxRow = std::max(maxRow, endPoint.sb->row);
+  }
+  // widen the box until the destinations are reached or it covers the device
+  while (!searchInBox(flow, state, numTargets, std::max(minCol - margin, 0),
+                      std::min(maxCol + margin, numCols - 1),
+                      std::max(minRow - margin, 0),
+                      std::min(maxRow + margin, numRows - 1))) {
+    if (minCol - margin <= 0 && maxCol + margin >= numCols - 1 &&
+        minRow - margin <= 0 && maxRow + margin >= numRows - 1)
+      return false;
+    margin = 2 * margin + 1;
+  }
+  return true;
+}
+
+// Run a single search that only expands switchboxes inside the given box.
+// The search stops once numTargets destinations have been settled; switchboxes
+// on the shortest paths to them are settled earlier, so their predecessors are
+// final.
+bool Pathfinder::searchInBox(const Flow &flow, SearchState &state,
+                             unsigned numTargets, int minCol, int maxCol,
+                             int minRow, int maxRow) const {
+  auto &distances = state.distances;
+  auto &predChannels = state.predChannels;
+  auto &queue = state.queue;
+  std::fill(distances.begin(), distances.end(), INF);
+  std::fill(predChannels.begin(), predChannels.end(), nullptr);
+  queue.reset(switchboxes.size());
+
+  // Manhattan distance to the nearest unconnected destination, times the
+  // minimum demand. A channel only connects neighbouring switchboxes, so this
+  // is a consistent lower bound on the remaining distance.
+  auto lowerBound = [&](unsigned idx) {
+    if (!options.astar)
+      return 0.0;
+    const Switchbox *sb = switchboxes[idx];
+    int hops = std::numeric_limits<int>::max();
+    for (const PathEndPoint &endPoint : flow.dsts)
+      if (state.isTarget[getSwitchboxIndex(endPoint.sb)])
+        hops = std::min(hops, std::abs(sb->col - endPoint.sb->col) +
+                                  std::abs(sb->row - endPoint.sb->row));
+    return hops * minDemand;
+  };
+
+  for (unsigned idx : state.treeNodes) {
+    distances[idx] = 0.0;
+    queue.update(idx, lowerBound(idx));
+  }
+
+  while (!queue.empty()) {
+    unsigned curr = queue.pop();
+    state.expanded++;
+    if (state.isTarget[curr] && --numTargets == 0) {
+      state.lastTarget = curr;
+      return true;
+    }
+    for (unsigned e = outChannelOffsets[curr]; e < outChannelOffsets[curr + 1];
+         e++) {
+      Channel *ch = outChannels[e];
+      unsigned dst = outChannelTargets[e];
+      const Switchbox *dstSb = switchboxes[dst];
+      if (dstSb->col < minCol || dstSb->col > maxCol || dstSb->row < minRow ||
+          dstSb->row > maxRow)
+        continue;
+      if (distances[curr] + ch->demand < distances[dst]) {
+        distances[dst] = distances[curr] + ch->demand;
+        predChannels[dst] = ch;
+        queue.update(dst, distances[dst] + lowerBound(dst));
       }
     }
   }
-  return preds;
+  return false;
+}
+
+// Claim the channels of a traced path for a flow, increment used_capacity for
+// them and fill in the switchbox settings. Returns true if the demand of any
+// channel was changed.
+bool Pathfinder::claimPath(const Flow &flow, const std::vector<Channel *> &path,
+                           SwitchSettings &switchSettings) {
+  bool demandChanged = false;
+  // set the input bundle for the source endpoint
+  switchSettings[flow.src.sb].src = flow.src.port;
+  // set the output bundle for each destination endpoint
+  for (const PathEndPoint &endPoint : flow.dsts)
+    switchSettings[endPoint.sb].dsts.insert(endPoint.port);
+
+  for (Channel *ch : path) {
+    // don't use fixed channels
+    while (ch->fixedCapacity.count(ch->usedCapacity))
+      ch->usedCapacity++;
+
+    // add the entrance port for this Switchbox
+    switchSettings[&ch->getTargetNode()].src = {getConnectingBundle(ch->bundle),
+                                                ch->usedCapacity};
+    // add the current Switchbox to the map of the predecessor
+    switchSettings[&ch->src].dsts.insert({ch->bundle, ch->usedCapacity});
+
+    ch->usedCapacity++;
+    // if at capacity, bump demand to discourage using this Channel
+    if (ch->usedCapacity >= ch->maxCapacity) {
+      // this means the order matters!
+      ch->demand *= DEMAND_COEFF;
+      demandChanged = true;
+    }
+  }
+  return demandChanged;
+}
+
+void Pathfinder::updateDemands() {
+  minDemand = INF;
+  for (auto &ch : edges) {
+    if (ch.fixedCapacity.size() >= static_cast<unsigned int>(ch.maxCapacity)) {
+      ch.demand = INF;
+    } else {
+      double history = 1.0 + OVER_CAPACITY_COEFF * ch.overCapacityCount;
+      double congestion = 1.0 + USED_CAPACITY_COEFF * ch.usedCapacity;
+      ch.demand = history * congestion;
+      minDemand = std::min(minDemand, ch.demand);
+    }
+  }
+  // demands only grow until the next update, so this stays a lower bound
+  if (minDemand == INF)
+    minDemand = 1.0;
 }
 
 // Perform congestion-aware routing for all flows which have been added.
@@ -194,25 +460,21 @@ Pathfinder::findPaths(const int maxIterations) {
   LLVM_DEBUG(llvm::dbgs() << "Begin Pathfinder::findPaths\n");
   int iterationCount = 0;
   std::map<PathEndPoint, SwitchSettings> routingSolution;
+  std::vector<bool> ripUp(flows.size());
+  std::vector<size_t> flowsToRoute;
+  flowPaths.resize(flows.size());
+  iterationStats.clear();
+  unroutableFlow = nullptr;
 
   // initialize all Channel histories to 0
   for (auto &ch : edges)
     ch.overCapacityCount = 0;
 
+  bool legal;
   do {
     LLVM_DEBUG(llvm::dbgs()
                << "Begin findPaths iteration #" << iterationCount << "\n");
-    // update demand on all channels
-    for (auto &ch : edges) {
-      if (ch.fixedCapacity.size() >=
-          static_cast<unsigned int>(ch.maxCapacity)) {
-        ch.demand = INF;
-      } else {
-        double history = 1.0 + OVER_CAPACITY_COEFF * ch.overCapacityCount;
-        double congestion = 1.0 + USED_CAPACITY_COEFF * ch.usedCapacity;
-        ch.demand = history * congestion;
-      }
-    }
+    auto iterationStart = std::chrono::steady_clock::now();
     // if reach maxIterations, throw an error since no routing can be found
     // TODO: add error throwing mechanism
     if (++iterationCount > maxIterations) {
@@ -225,74 +487,104 @@ Pathfinder::findPaths(const int maxIterations) {
       return routingSolution;
     }
 
-    // "rip up" all routes, i.e. set used capacity in each Channel to 0
-    routingSolution.clear();
-    for (auto &ch : edges)
-      ch.usedCapacity = 0;
+    if (!options.incremental || iterationCount == 1) {
+      // update demand on all channels
+      updateDemands();
+      // "rip up" all routes, i.e. set used capacity in each Channel to 0
+      routingSolution.clear();
+      for (auto &ch : edges)
+        ch.usedCapacity = 0;
+      std::fill(ripUp.begin(), ripUp.end(), true);
+    } else {
+      // only "rip up" the flows that use a channel which is over capacity
+      for (size_t i = 0; i < flows.size(); i++)
+        ripUp[i] = llvm::any_of(flowPaths[i], [](const Channel *ch) {
+          return ch->usedCapacity > ch->maxCapacity;
+        });
+      // claim the channels of the routes that are kept again, so that used
+      // capacity and demand reflect only those routes
+      for (auto &ch : edges)
+        ch.usedCapacity = 0;
+      for (size_t i = 0; i < flows.size(); i++) {
+        if (ripUp[i])
+          continue;
+        SwitchSettings &switchSettings = routingSolution[flows[i].src];
+        switchSettings.clear();
+        claimPath(flows[i], flowPaths[i], switchSettings);
+      }
+      updateDemands();
+      for (auto &ch : edges)
+        if (ch.usedCapacity >= ch.maxCapacity)
+          ch.demand *= DEMAND_COEFF;
+    }
+    flowsToRoute.clear();
+    unsigned long switchboxesExpanded = 0;
+    for (size_t i = 0; i < flows.size(); i++)
+      if (ripUp[i])
+        flowsToRoute.push_back(i);
 
     // for each flow, find the shortest path from source to destination
     // update used_capacity for the path between them
-    for (const auto &flow : flows) {
+    size_t next = 0;
+    while (next < flowsToRoute.size()) {
       // Use dijkstra to find path given current demand from the start
-      // switchbox; find the shortest paths to each other switchbox. Output is
-      // in the predecessor map, which must then be processed to get individual
-      // switchbox settings
-      Switchbox *src = flow.src.sb;
-      assert(src && "nonexistent flow source");
-      std::set<Switchbox *> processed;
-      std::map<Switchbox *, Switchbox *> preds =
-          dijkstraShortestPaths(graph, src);
-
-      // trace the path of the flow backwards via predecessors
-      // increment used_capacity for the associated channels
-      SwitchSettings switchSettings;
-      // set the input bundle for the source endpoint
-      switchSettings[src].src = flow.src.port;
-      processed.insert(src);
-      for (const PathEndPoint &endPoint : flow.dsts) {
-        Switchbox *curr = endPoint.sb;
-        assert(curr && "endpoint has no source switchbox");
-        // set the output bundle for this destination endpoint
-        switchSettings[curr].dsts.insert(endPoint.port);
-
-        // trace backwards until a vertex already processed is reached
-        while (!processed.count(curr)) {
-          // find the edge from the pred to curr by searching incident edges
-          SmallVector<Channel *, 10> channels;
-          graph.findIncomingEdgesToNode(*curr, channels);
-          auto matchingCh =
-              std::find_if(channels.begin(), channels.end(), [&](Channel *ch) {
-                return ch->src == *preds[curr];
-              });
-          assert(matchingCh != channels.end() && "couldn't find ch");
-          Channel *ch = *matchingCh;
-
-          // don't use fixed channels
-          while (ch->fixedCapacity.count(ch->usedCapacity))
-            ch->usedCapacity++;
-
-          // add the entrance port for this Switchbox
-          switchSettings[curr].src = {getConnectingBundle(ch->bundle),
-                                      ch->usedCapacity};
-          // add the current Switchbox to the map of the predecessor
-          switchSettings[preds[curr]].dsts.insert(
-              {ch->bundle, ch->usedCapacity});
-
-          ch->usedCapacity++;
-          // if at capacity, bump demand to discourage using this Channel
-          if (ch->usedCapacity >= ch->maxCapacity) {
-            // this means the order matters!
-            ch->demand *= DEMAND_COEFF;
-          }
-
-          processed.insert(curr);
-          curr = preds[curr];
+      // switchbox; find the shortest paths to each other switchbox. Searches
+      // only read the demands, so the next few flows are searched
+      // concurrently. Committing a path may raise the demand of a channel
+      // that reached capacity; the remaining searches of the batch are then
+      // stale and are redone, so the result is the same as routing one flow
+      // at a time.
+      size_t batchSize =
+          std::min(searchStates.size(), flowsToRoute.size() - next);
+      std::vector<LogicalResult> routed(batchSize, success());
+      auto searchFlow = [&](size_t i) {
+        routed[i] = routeFlow(flows[flowsToRoute[next + i]], searchStates[i]);
+      };
+      if (batchSize > 1)
+        parallelFor(context, 0, batchSize, searchFlow);
+      else
+        searchFlow(0);
+      for (size_t i = 0; i < batchSize; i++) {
+        switchboxesExpanded += searchStates[i].expanded;
+        searchStates[i].expanded = 0;
+      }
+
+      for (size_t i = 0; i < batchSize; i++) {
+        size_t flowIdx = flowsToRoute[next++];
+        const Flow &flow = flows[flowIdx];
+        // no congestion makes a destination reachable, so give up
+        if (failed(routed[i])) {
+          unroutableFlow = &flow;
+          return routingSolution;
         }
+        flowPaths[flowIdx] = searchStates[i].path;
+        // add this flow to the proposed solution
+        SwitchSettings switchSettings;
+        bool demandChanged =
+            claimPath(flow, flowPaths[flowIdx], switchSettings);
+        routingSolution[flow.src] = switchSettings;
+        if (demandChanged)
+          break;
       }
-      // add this flow to the proposed solution
-      routingSolution[flow.src] = switchSettings;
     }
-  } while (!isLegal()); // continue iterations until a legal routing is found
+
+    legal = isLegal();
+    unsigned overflowedChannels = llvm::count_if(edges, [](const Channel &ch) {
+      return ch.usedCapacity > ch.maxCapacity;
+    });
+    unsigned long channelsUsed = 0;
+    for (const auto &path : flowPaths)
+      channelsUsed += path.size();
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - iterationStart;
+    iterationStats.push_back({iterationCount,
+                              static_cast<unsigned>(flowsToRoute.size()),
+                              overflowedChannels, switchboxesExpanded,
+                              channelsUsed, elapsed.count()});
+    LLVM_DEBUG(llvm::dbgs() << "Rerouted " << flowsToRoute.size()
+                            << " flows, " << overflowedChannels
+                            << " channels over capacity\n");
+  } while (!legal); // continue iterations until a legal routing is found
   return routingSolution;
 }
 
@@ -300,7 +592,7 @@ Pathfinder::findPaths(const int maxIterations) {
 bool Pathfinder::isLegal() {
   bool legal = true; // assume legal until found otherwise
   // check if maximum number of iterations has been reached
-  if (maxIterReached)
+  if (maxIterReached || unroutableFlow)
     legal = false;
   for (auto &e : edges)
     if (e.usedCapacity > e.maxCapacity) {
@@ -0,0 +1,470 @@
+//===- AIEVecCycleEstimate.cpp - Static cycle estimation of AIEVec loops --===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+// This file implements an analysis that statically estimates the cycles taken
+// by the scf.for loops of AIEVec code, using a simple model of the VLIW slots
+// of the AIE and AIE-ML cores. The result is a JSON report meant to rank
+// variants of a kernel against each other, not to replace the simulator.
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIEVec/AIEVecUtils.h"
+#include "aie/Dialect/AIEVec/Analysis/Passes.h"
+#include "aie/Dialect/AIEVec/IR/AIEVecOps.h"
+
+#include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/Support/FileUtilities.h"
+#include "llvm/ADT/TypeSwitch.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/ToolOutputFile.h"
+
+#include <optional>
+
+#define DEBUG_TYPE "aievec-cycle-estimate"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::aievec;
+
+namespace xilinx::aievec {
+#define GEN_PASS_DEF_AIEVECCYCLEESTIMATE
+#include "aie/Dialect/AIEVec/Analysis/Passes.h.inc"
+} // namespace xilinx::aievec
+
+namespace {
+
+// The issue slots of the VLIW bundle of an AIE core.
+enum class Slot { Load, Store, Vector, Scalar, Move, NumSlots };
+
+constexpr unsigned numSlots = static_cast<unsigned>(Slot::NumSlots);
+
+const char *getSlotName(Slot slot) {
+  switch (slot) {
+  case Slot::Load:
+    return "load";
+  case Slot::Store:
+    return "store";
+  case Slot::Vector:
+    return "vector";
+  case Slot::Scalar:
+    return "scalar";
+  case Slot::Move:
+    return "move";
+  default:
+    llvm_unreachable("Unknown slot");
+  }
+}
+
+// The resources and latencies of an AIE core. The latencies are the number of
+// cycles between issuing an op and being able to issue a consumer of its
+// result. They are approximations of the pipelines of each architecture.
+struct CoreModel {
+  unsigned slotsPerBundle[numSlots];
+  // Width in bits of a load or store port.
+  unsigned memPortWidth;
+  unsigned loadLatency;
+  unsigned macLatency;
+  // Latency between two MACs on the same accumulator, which bypass the
+  // accumulator register file.
+  unsigned macAccLatency;
+  unsigned vectorLatency;
+  unsigned moveLatency;
+  unsigned srsLatency;
+  unsigned scalarLatency;
+};
+
+//                          load store vec scal move
+constexpr CoreModel aieModel{{2, 1, 1, 1, 1}, 256, 5, 4, 1, 2, 1, 3, 1};
+constexpr CoreModel aiemlModel{{2, 1, 1, 1, 1}, 256, 7, 6, 1, 3, 2, 4, 1};
+
+// The cost of one op on a core.
+struct OpCost {
+  Slot slot = Slot::Scalar;
+  // Number of bundles in which the op occupies its slot.
+  unsigned issues = 0;
+  unsigned latency = 0;
+  // Latency of the path from the accumulator operand to the result, for ops
+  // that accumulate.
+  unsigned accLatency = 0;
+};
+
+// Return the accumulator operand of `op`, or a null value if `op` doesn't
+// accumulate.
+static Value getAccumulatorOperand(Operation *op) {
+  return TypeSwitch<Operation *, Value>(op)
+      .Case<aievec::FMAOp, aievec::FMAElemOp, aievec::FMAConvOp,
+            aievec::MatMulOp, vector::FMAOp, vector::ContractionOp>(
+          [](auto macOp) { return macOp.getAcc(); })
+      .Default([](Operation *) { return Value(); });
+}
+
+// Return the number of memory port accesses needed to transfer `type`.
+static unsigned getNumMemoryAccesses(Type type, const CoreModel &model) {
+  auto vecTy = dyn_cast<VectorType>(type);
+  if (!vecTy)
+    return 1;
+  unsigned bits = getVectorSizeInBits(vecTy);
+  return std::max(1u, (bits + model.memPortWidth - 1) / model.memPortWidth);
+}
+
+// Return true if `updOp` is one of a pair of upd ops that each load one half
+// of the result.
+static bool isHalfUpdate(aievec::UPDOp updOp) {
+  if (updOp.getVector())
+    return true;
+  return llvm::any_of(updOp->getUsers(), [&](Operation *user) {
+    auto nextUpdOp = dyn_cast<aievec::UPDOp>(user);
+    return nextUpdOp && nextUpdOp.getVector() == updOp.getResult();
+  });
+}
+
+static OpCost getOpCost(Operation *op, const CoreModel &model) {
+  OpCost cost;
+  // Ops that don't turn into instructions.
+  if (isa<arith::ConstantOp, scf::YieldOp, func::ReturnOp,
+          vector::ShapeCastOp>(op) ||
+      op->getNumRegions())
+    return cost;
+
+  cost.issues = 1;
+  if (isa<aievec::UPDOp, vector::TransferReadOp, vector::LoadOp,
+          memref::LoadOp, affine::AffineLoadOp>(op)) {
+    cost.slot = Slot::Load;
+    cost.latency = model.loadLatency;
+    Type type = op->getResult(0).getType();
+    if (auto updOp = dyn_cast<aievec::UPDOp>(op))
+      if (isHalfUpdate(updOp))
+        type = VectorType::get({getVectorLaneSize(cast<VectorType>(type)) / 2},
+                               getElementTypeOrSelf(type));
+    cost.issues = getNumMemoryAccesses(type, model);
+    return cost;
+  }
+  if (isa<vector::TransferWriteOp, vector::StoreOp, memref::StoreOp,
+          affine::AffineStoreOp>(op)) {
+    cost.slot = Slot::Store;
+    cost.issues = getNumMemoryAccesses(op->getOperand(0).getType(), model);
+    return cost;
+  }
+  if (isa<aievec::MulOp, aievec::FMAOp, aievec::MulElemOp, aievec::FMAElemOp,
+          aievec::MulConvOp, aievec::FMAConvOp, aievec::MatMulOp,
+          vector::FMAOp, vector::ContractionOp>(op)) {
+    cost.slot = Slot::Vector;
+    cost.latency = model.macLatency;
+    cost.accLatency = model.macAccLatency;
+    return cost;
+  }
+  if (isa<aievec::UPSOp, aievec::SRSOp>(op)) {
+    cost.slot = Slot::Move;
+    cost.latency = model.srsLatency;
+    return cost;
+  }
+  if (isa<aievec::ConcatOp, aievec::ExtOp, aievec::SelectOp, aievec::ShiftOp,
+          aievec::ShuffleOp, aievec::BroadcastOp, aievec::BroadcastScalarOp,
+          aievec::PackOp, aievec::UnpackOp, aievec::CastOp,
+          aievec::ExtElemOp, vector::BroadcastOp, vector::ExtractOp,
+          vector::InsertOp, vector::ExtractStridedSliceOp,
+          vector::InsertStridedSliceOp, vector::ShuffleOp>(op)) {
+    cost.slot = Slot::Move;
+    cost.latency = model.moveLatency;
+    return cost;
+  }
+  // Any other op on vectors runs on the vector unit, and anything else is
+  // scalar code.
+  if (llvm::any_of(op->getResultTypes(),
+                   [](Type type) { return isa<VectorType>(type); })) {
+    cost.slot = Slot::Vector;
+    cost.latency = model.vectorLatency;
+    return cost;
+  }
+  cost.latency = model.scalarLatency;
+  return cost;
+}
+
+// The cycle estimate of an scf.for loop.
+struct LoopEstimate {
+  scf::ForOp forOp;
+  unsigned depth = 0;
+  std::optional<int64_t> tripCount;
+  // Slot issues of one iteration, not counting the inner loops.
+  unsigned slotIssues[numSlots] = {};
+  // Lower bound of the initiation interval due to the slots.
+  unsigned resourceBound = 0;
+  // Lower bound of the initiation interval due to loop-carried values.
+  unsigned recurrenceBound = 0;
+  // Length of the critical path of one iteration, not counting inner loops.
+  unsigned scheduleLength = 0;
+  // Innermost loops are software pipelined, and start a new iteration every
+  // `ii` cycles. Any other loop runs its iterations back to back.
+  bool pipelined = false;
+  unsigned ii = 0;
+  std::optional<int64_t> cycles;
+  SmallVector<LoopEstimate> innerLoops;
+};
+
+class CycleEstimator {
+public:
+  CycleEstimator(const CoreModel &model) : model(model) {}
+
+  // Estimate the cycles of the loops in `block`, and return the cycles taken
+  // by the block.
+  std::optional<int64_t> estimateBlock(Block &block, unsigned depth,
+                                       SmallVectorImpl<LoopEstimate> &loops) {
+    unsigned slotIssues[numSlots] = {};
+    countSlotIssues(block, slotIssues, depth, loops);
+    std::optional<int64_t> cycles =
+        std::max(getResourceBound(slotIssues), getScheduleLength(block));
+    for (LoopEstimate &loop : loops)
+      cycles = add(cycles, loop.cycles);
+    return cycles;
+  }
+
+private:
+  const CoreModel &model;
+
+  static std::optional<int64_t> add(std::optional<int64_t> lhs,
+                                    std::optional<int64_t> rhs) {
+    if (!lhs || !rhs)
+      return std::nullopt;
+    return *lhs + *rhs;
+  }
+
+  unsigned getResourceBound(const unsigned slotIssues[numSlots]) const {
+    unsigned bound = 0;
+    for (unsigned slot = 0; slot < numSlots; slot++)
+      bound = std::max(bound, (slotIssues[slot] + model.slotsPerBundle[slot] -
+                               1) / model.slotsPerBundle[slot]);
+    return bound;
+  }
+
+  // Count the slot issues of the ops in `block`, including those in nested
+  // regions other than loops. Estimate the nested loops and append them to
+  // `loops`.
+  void countSlotIssues(Block &block, unsigned slotIssues[numSlots],
+                       unsigned depth, SmallVectorImpl<LoopEstimate> &loops) {
+    for (Operation &op : block) {
+      if (auto forOp = dyn_cast<scf::ForOp>(op)) {
+        loops.push_back(estimateLoop(forOp, depth));
+        continue;
+      }
+      OpCost cost = getOpCost(&op, model);
+      slotIssues[static_cast<unsigned>(cost.slot)] += cost.issues;
+      for (Region &region : op.getRegions())
+        for (Block &nestedBlock : region)
+          countSlotIssues(nestedBlock, slotIssues, depth, loops);
+    }
+  }
+
+  // Compute the cycle at which each value defined in `block` is available,
+  // starting the values in `sources` at cycle 0. Values that don't depend on
+  // any of the sources are not in the result. If `sources` is empty, all the
+  // values defined outside of the block are available at cycle 0. If `length`
+  // isn't null, set it to the cycle at which the last op is done.
+  DenseMap<Value, unsigned> getArrivalTimes(Block &block,
+                                            ArrayRef<Value> sources,
+                                            unsigned *length = nullptr) const {
+    DenseMap<Value, unsigned> arrival;
+    for (Value source : sources)
+      arrival[source] = 0;
+    bool fromAllInputs = sources.empty();
+    if (length)
+      *length = 0;
+    // Nested loops and regions are estimated on their own, so ops with
+    // regions only forward the dependences from their operands.
+    for (Operation &op : block) {
+      OpCost cost = getOpCost(&op, model);
+      Value acc = getAccumulatorOperand(&op);
+      std::optional<unsigned> ready;
+      for (Value operand : op.getOperands()) {
+        std::optional<unsigned> operandTime;
+        auto it = arrival.find(operand);
+        if (it != arrival.end())
+          operandTime = it->second;
+        else if (fromAllInputs)
+          operandTime = 0;
+        if (!operandTime)
+          continue;
+        unsigned latency = operand == acc ? cost.accLatency : cost.latency;
+        ready = std::max(ready.value_or(0), *operandTime + latency);
+      }
+      if (!ready && fromAllInputs)
+        ready = cost.latency;
+      if (!ready)
+        continue;
+      for (Value result : op.getResults())
+        arrival[result] = *ready;
+      if (length)
+        *length = std::max(*length, *ready);
+    }
+    return arrival;
+  }
+
+  // Return the length of the critical path through the ops of `block`.
+  unsigned getScheduleLength(Block &block) const {
+    unsigned length;
+    getArrivalTimes(block, {}, &length);
+    return length;
+  }
+
+  LoopEstimate estimateLoop(scf::ForOp forOp, unsigned depth) {
+    LoopEstimate loop;
+    loop.forOp = forOp;
+    loop.depth = depth;
+    std::optional<int64_t> lb = getConstantIntValue(forOp.getLowerBound());
+    std::optional<int64_t> ub = getConstantIntValue(forOp.getUpperBound());
+    std::optional<int64_t> step = getConstantIntValue(forOp.getStep());
+    if (lb && ub && step && *step > 0)
+      loop.tripCount = std::max<int64_t>(0, (*ub - *lb + *step - 1) / *step);
+
+    Block &body = *forOp.getBody();
+    countSlotIssues(body, loop.slotIssues, depth + 1, loop.innerLoops);
+    loop.resourceBound = getResourceBound(loop.slotIssues);
+    loop.scheduleLength = getScheduleLength(body);
+
+    // A value carried to the next iteration can't be used before the path
+    // from its previous value through the body is done.
+    auto yieldOp = cast<scf::YieldOp>(body.getTerminator());
+    for (auto [iterArg, yielded] :
+         llvm::zip(forOp.getRegionIterArgs(), yieldOp.getOperands())) {
+      DenseMap<Value, unsigned> arrival = getArrivalTimes(body, {iterArg});
+      auto it = arrival.find(yielded);
+      if (it != arrival.end())
+        loop.recurrenceBound = std::max(loop.recurrenceBound, it->second);
+    }
+    loop.ii = std::max({loop.resourceBound, loop.recurrenceBound, 1u});
+
+    // Only innermost loops are pipelined. Their last iteration still has to
+    // go through the whole schedule.
+    loop.pipelined = loop.innerLoops.empty();
+    if (!loop.tripCount)
+      return loop;
+    if (*loop.tripCount == 0) {
+      loop.cycles = 0;
+    } else if (loop.pipelined) {
+      loop.cycles = (*loop.tripCount - 1) * loop.ii +
+                    std::max(loop.scheduleLength, loop.ii);
+    } else {
+      std::optional<int64_t> iterationCycles =
+          std::max(loop.resourceBound, loop.scheduleLength);
+      for (LoopEstimate &innerLoop : loop.innerLoops)
+        iterationCycles = add(iterationCycles, innerLoop.cycles);
+      if (iterationCycles)
+        loop.cycles = *loop.tripCount * *iterationCycles;
+    }
+    return loop;
+  }
+};
+
+static std::string getLocationString(Location loc) {
+  if (auto fileLoc = loc->findInstanceOf<FileLineColLoc>())
+    return (fileLoc.getFilename().getValue() + ":" +
+            Twine(fileLoc.getLine()) + ":" + Twine(fileLoc.getColumn()))
+        .str();
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  loc.print(os);
+  return os.str();
+}
+
+static void writeOptional(llvm::json::OStream &json, StringRef key,
+                          std::optional<int64_t> value) {
+  if (value)
+    json.attribute(key, *value);
+  else
+    json.attribute(key, nullptr);
+}
+
+static void writeLoop(llvm::json::OStream &json, const LoopEstimate &loop) {
+  json.object([&] {
+    json.attribute("location", getLocationString(loop.forOp.getLoc()));
+    json.attribute("depth", loop.depth);
+    writeOptional(json, "trip_count", loop.tripCount);
+    json.attributeObject("slots", [&] {
+      for (unsigned slot = 0; slot < numSlots; slot++)
+        json.attribute(getSlotName(static_cast<Slot>(slot)),
+                       loop.slotIssues[slot]);
+    });
+    json.attribute("resource_bound", loop.resourceBound);
+    json.attribute("recurrence_bound", loop.recurrenceBound);
+    json.attribute("ii", loop.ii);
+    json.attribute("schedule_length", loop.scheduleLength);
+    json.attribute("pipelined", loop.pipelined);
+    writeOptional(json, "cycles", loop.cycles);
+    json.attributeArray("loops", [&] {
+      for (const LoopEstimate &innerLoop : loop.innerLoops)
+        writeLoop(json, innerLoop);
+    });
+  });
+}
+
+struct AIEVecCycleEstimate
+    : public AIEVecCycleEstimateBase<AIEVecCycleEstimate> {
+  AIEVecCycleEstimate() = default;
+
+  void runOnOperation() override {
+    markAllAnalysesPreserved();
+    ModuleOp module = getOperation();
+
+    const CoreModel *model = nullptr;
+    std::string target = aieTarget;
+    if (target == "aie") {
+      model = &aieModel;
+    } else if (target == "aieml") {
+      model = &aiemlModel;
+    } else {
+      module->emitError() << "unknown AIE target '" << aieTarget << "'";
+      signalPassFailure();
+      return;
+    }
+
+    std::string errorMessage;
+    std::unique_ptr<llvm::ToolOutputFile> output =
+        openOutputFile(outputFile, &errorMessage);
+    if (!output) {
+      module->emitError() << errorMessage;
+      signalPassFailure();
+      return;
+    }
+
+    CycleEstimator estimator(*model);
+    llvm::json::OStream json(output->os(), /*IndentSize=*/2);
+    json.object([&] {
+      json.attribute("target", target);
+      json.attributeArray("functions", [&] {
+        module.walk([&](func::FuncOp func) {
+          if (func.isExternal())
+            return;
+          SmallVector<LoopEstimate> loops;
+          std::optional<int64_t> cycles =
+              estimator.estimateBlock(func.getBody().front(), 0, loops);
+          json.object([&] {
+            json.attribute("name", func.getSymName());
+            writeOptional(json, "cycles", cycles);
+            json.attributeArray("loops", [&] {
+              for (const LoopEstimate &loop : loops)
+                writeLoop(json, loop);
+            });
+          });
+        });
+      });
+    });
+    output->os() << "\n";
+    output->keep();
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Pass> xilinx::aievec::createAIEVecCycleEstimatePass() {
+  return std::make_unique<AIEVecCycleEstimate>();
+}
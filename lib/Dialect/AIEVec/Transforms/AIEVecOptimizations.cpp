@@ -18,6 +18,8 @@
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/IR/Matchers.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/IR/TypeUtilities.h"
 #include "mlir/Pass/PassManager.h"
@@ -123,6 +125,64 @@ static bool singleColumnFMAOpCanFold(aievec::FMAOp fmaOp) {
          !singleColumnFMAOpCanFold(accFmaOp);
 }
 
+// Return true if `op` moves a vector into an accumulator register.
+static bool isMoveToAccumulator(Operation *op) {
+  if (auto castOp = dyn_cast<aievec::CastOp>(op))
+    return castOp.getIsResAcc();
+  return isa<aievec::UPSOp>(op);
+}
+
+// Match a loop-carried value of `forOp` that is moved into an accumulator at
+// the start of every iteration, and back out of it at the end:
+//   scf.for ... iter_args(%v = %init) -> (vector<16xi16>) {
+//     %acc = aievec.ups %v {shift = s} : vector<16xi16>, vector<16xi48>
+//     ...
+//     %next = aievec.srs %acc', s : vector<16xi48>, i32, vector<16xi16>
+//     scf.yield %next : vector<16xi16>
+//   }
+// On success, return the ops moving the `idx`-th iter_arg into and out of the
+// accumulator. Otherwise, return a pair of null operations. Casts only move
+// the value between registers, but an SRS also saturates and rounds it, so
+// UPS/SRS pairs are only matched if `matchUpsSrs` is set.
+static std::pair<Operation *, Operation *>
+getLoopCarriedAccumulatorMoves(scf::ForOp forOp, unsigned idx,
+                               bool matchUpsSrs) {
+  BlockArgument iterArg = forOp.getRegionIterArgs()[idx];
+  if (!iterArg.hasOneUse())
+    return {};
+  Operation *toAccOp = *iterArg.getUsers().begin();
+  if (!isMoveToAccumulator(toAccOp))
+    return {};
+
+  auto yieldOp = cast<scf::YieldOp>(forOp.getBody()->getTerminator());
+  Operation *fromAccOp = yieldOp.getOperand(idx).getDefiningOp();
+  if (!fromAccOp || fromAccOp->getBlock() != forOp.getBody())
+    return {};
+
+  if (auto castOp = dyn_cast<aievec::CastOp>(fromAccOp)) {
+    if (castOp.getIsResAcc() || !isa<aievec::CastOp>(toAccOp) ||
+        castOp.getSource().getType() != toAccOp->getResult(0).getType())
+      return {};
+    return {toAccOp, fromAccOp};
+  }
+
+  if (!matchUpsSrs)
+    return {};
+
+  // The values must keep their scale in the accumulator, so the SRS has to
+  // undo the shift of the UPS.
+  auto upsOp = dyn_cast<aievec::UPSOp>(toAccOp);
+  auto srsOp = dyn_cast<aievec::SRSOp>(fromAccOp);
+  if (!upsOp || !srsOp ||
+      srsOp.getSource().getType() != upsOp.getResult().getType())
+    return {};
+  APInt shift;
+  if (!matchPattern(srsOp.getShift(), m_ConstantInt(&shift)) ||
+      shift.getSExtValue() != upsOp.getShift())
+    return {};
+  return {toAccOp, fromAccOp};
+}
+
 //===----------------------------------------------------------------------===//
 // Lowering patterns
 //===----------------------------------------------------------------------===//
@@ -205,6 +265,72 @@ struct FoldAIECastOps : public OpConversionPattern<aievec::CastOp> {
     return success();
   }
 };
+// Keep a loop-carried value in an accumulator register through all the
+// iterations of an scf.for, instead of moving it out of the accumulator at the
+// end of each iteration and back in at the start of the next one. The value
+// is moved into the accumulator once before the loop and out of it once after.
+struct SinkAccumulatorMovesOutOfLoopPattern
+    : public OpRewritePattern<scf::ForOp> {
+  SinkAccumulatorMovesOutOfLoopPattern(MLIRContext *context, bool sinkUpsSrs)
+      : OpRewritePattern<scf::ForOp>(context), sinkUpsSrs(sinkUpsSrs) {}
+
+  LogicalResult matchAndRewrite(scf::ForOp forOp,
+                                PatternRewriter &rewriter) const override {
+    unsigned idx = 0;
+    Operation *toAccOp = nullptr, *fromAccOp = nullptr;
+    for (unsigned e = forOp.getNumRegionIterArgs(); idx < e; idx++) {
+      std::tie(toAccOp, fromAccOp) =
+          getLoopCarriedAccumulatorMoves(forOp, idx, sinkUpsSrs);
+      if (toAccOp)
+        break;
+    }
+    if (!toAccOp)
+      return failure();
+
+    // Move the initial value into the accumulator before the loop.
+    rewriter.setInsertionPoint(forOp);
+    IRMapping initMapping;
+    initMapping.map(toAccOp->getOperand(0), forOp.getInitArgs()[idx]);
+    Operation *initAccOp = rewriter.clone(*toAccOp, initMapping);
+    SmallVector<Value> initArgs(forOp.getInitArgs());
+    initArgs[idx] = initAccOp->getResult(0);
+    auto newForOp = rewriter.create<scf::ForOp>(
+        forOp.getLoc(), forOp.getLowerBound(), forOp.getUpperBound(),
+        forOp.getStep(), initArgs);
+    newForOp->setAttrs(forOp->getAttrs());
+
+    // Carry the accumulator itself from one iteration to the next.
+    Block *body = newForOp.getBody();
+    rewriter.mergeBlocks(forOp.getBody(), body, body->getArguments());
+    rewriter.replaceOp(toAccOp, body->getArgument(idx + 1));
+    auto yieldOp = cast<scf::YieldOp>(body->getTerminator());
+    rewriter.updateRootInPlace(yieldOp, [&]() {
+      yieldOp->setOperand(idx, fromAccOp->getOperand(0));
+    });
+
+    // Move the final value out of the accumulator after the loop. A shift
+    // defined in the loop is a constant, and is rematerialized after it.
+    rewriter.setInsertionPointAfter(newForOp);
+    IRMapping resultMapping;
+    resultMapping.map(fromAccOp->getOperand(0), newForOp.getResult(idx));
+    if (auto srsOp = dyn_cast<aievec::SRSOp>(fromAccOp)) {
+      Operation *shiftOp = srsOp.getShift().getDefiningOp();
+      if (newForOp->isAncestor(shiftOp))
+        rewriter.clone(*shiftOp, resultMapping);
+    }
+    Operation *resultOp = rewriter.clone(*fromAccOp, resultMapping);
+    if (fromAccOp->use_empty())
+      rewriter.eraseOp(fromAccOp);
+
+    SmallVector<Value> results(newForOp.getResults());
+    results[idx] = resultOp->getResult(0);
+    rewriter.replaceOp(forOp, results);
+    return success();
+  }
+
+  bool sinkUpsSrs;
+};
+
 //===----------------------------------------------------------------------===//
 // Pattern collection
 //===----------------------------------------------------------------------===//
@@ -404,6 +530,54 @@ createAIEVecConvOpTransformationPass(const OptimizeAIEVecOptions &options) {
   return std::make_unique<AIEVecConvOpTransformationPass>(options);
 }
 
+struct AIEVecAccumulatorLoopsPass
+    : public PassWrapper<AIEVecAccumulatorLoopsPass, OperationPass<>> {
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(AIEVecAccumulatorLoopsPass)
+
+  AIEVecAccumulatorLoopsPass() = default;
+  AIEVecAccumulatorLoopsPass(const AIEVecAccumulatorLoopsPass &pass)
+      : PassWrapper(pass) {}
+
+  AIEVecAccumulatorLoopsPass(const OptimizeAIEVecOptions &options)
+      : AIEVecAccumulatorLoopsPass() {
+    keepAccInLoops = options.keepAccInLoops;
+  }
+
+  // In case we want to register this pass as a standalone pass for test
+  // purposes.
+  StringRef getArgument() const final {
+    return "test-aievec-accumulator-loops";
+  }
+  StringRef getDescription() const final {
+    return "Keep loop-carried accumulators in accumulator registers.";
+  }
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<xilinx::aievec::AIEVecDialect, arith::ArithDialect,
+                    scf::SCFDialect>();
+  }
+
+  Option<bool> keepAccInLoops{
+      *this, "keep-acc-in-loops",
+      llvm::cl::desc("Also keep accumulators moved out with an SRS in "
+                     "accumulator registers. This skips the saturation and "
+                     "rounding of every iteration but the last."),
+      llvm::cl::init(false)};
+
+  void runOnOperation() override {
+    auto op = getOperation();
+    MLIRContext *context = &getContext();
+    RewritePatternSet patterns(context);
+    patterns.add<SinkAccumulatorMovesOutOfLoopPattern>(context,
+                                                       keepAccInLoops);
+    (void)applyPatternsAndFoldGreedily(op, std::move(patterns));
+  }
+};
+
+std::unique_ptr<::mlir::Pass>
+xilinx::aievec::createAIEVecAccumulatorLoopsPass() {
+  return std::make_unique<AIEVecAccumulatorLoopsPass>();
+}
+
 //============================================================================//
 //=============== Main AIEVec2AIEVec Pipeline Configuration ==================//
 //============================================================================//
@@ -422,6 +596,9 @@ void xilinx::aievec::buildOptimizeAIEVec(OpPassManager &pm,
     pm.addPass(createAIEVecConvOpTransformationPass(options));
   }
 
+  // Keep reductions in accumulator registers across loop iterations.
+  pm.addPass(std::make_unique<AIEVecAccumulatorLoopsPass>(options));
+
   // Add post-lowering canonicalization passes.
   pm.addPass(createCSEPass());
   pm.addPass(createCanonicalizerPass());
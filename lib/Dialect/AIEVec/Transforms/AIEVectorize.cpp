@@ -14,6 +14,7 @@
 
 #include "aie/Dialect/AIEVec/AIEVecUtils.h"
 #include "aie/Dialect/AIEVec/IR/AIEVecOps.h"
+#include "aie/Dialect/AIEVec/Pipelines/Passes.h"
 #include "aie/Dialect/AIEVec/Transforms/IntervalReuse.h"
 #include "aie/Dialect/AIEVec/Transforms/Passes.h"
 #include "mlir/Conversion/AffineToStandard/AffineToStandard.h"
@@ -2624,13 +2625,15 @@ static void preCanonicalizeIR(ModuleOp module) {
 
 // Run a post pipeline of cleanup and optimization passes (canonicalizer, LICM,
 // CSE, etc). At the end, lower the output from affine to scf, so that we can
-// use EmitC functionality to generate the loops.
+// use EmitC functionality to generate the loops, and keep the loop-carried
+// accumulators of those loops in accumulator registers.
 static void postCanonicalizeIR(ModuleOp module) {
   PassManager pm(module.getContext());
   pm.addPass(createCanonicalizerPass());
   pm.addPass(createCSEPass());
   pm.addPass(createLoopInvariantCodeMotionPass());
   pm.addPass(createLowerAffinePass());
+  pm.addPass(createAIEVecAccumulatorLoopsPass());
   [[maybe_unused]] bool success = pm.run(module).succeeded();
   assert(success);
 }
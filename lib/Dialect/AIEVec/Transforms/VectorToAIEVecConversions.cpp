@@ -31,6 +31,7 @@
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/ADT/TypeSwitch.h"
 
+#include <array>
 #include <bitset>
 #include <optional>
 #include <tuple>
@@ -224,6 +225,81 @@ buildAttributeListForRotationSelectOp(PatternRewriter &rewriter, VectorType vTy,
   return {};
 }
 
+// If `v` is the extension of a narrower vector, as produced when vectorizing
+// a mixed-precision contraction, return the narrower vector. The
+// `aievec.matmul` op takes its operands in the narrower type and extends
+// them itself.
+static Value getMatMulOperandSource(Value v) {
+  if (auto extSIOp = v.getDefiningOp<arith::ExtSIOp>())
+    return extSIOp.getIn();
+  if (auto extFOp = v.getDefiningOp<arith::ExtFOp>())
+    return extFOp.getIn();
+  return v;
+}
+
+// If `contractOp` is a plain matrix multiplication that can be decomposed into
+// native AIE-ML `aievec.matmul` ops, return the shape of those ops as
+// {M, K, N}.
+static std::optional<std::array<int64_t, 3>>
+getAIEMLMatMulNativeShape(vector::ContractionOp contractOp) {
+  if (contractOp.getKind() != vector::CombiningKind::ADD)
+    return std::nullopt;
+
+  auto accTy = dyn_cast<VectorType>(contractOp.getAccType());
+  if (!accTy || accTy.getRank() != 2)
+    return std::nullopt;
+
+  // Only (m, k) x (k, n) -> (m, n) is supported.
+  using MapList = ArrayRef<ArrayRef<AffineExpr>>;
+  auto infer = [](MapList m) { return AffineMap::inferFromExprList(m); };
+  AffineExpr m, n, k;
+  bindDims(contractOp.getContext(), m, n, k);
+  auto iteratorTypes = contractOp.getIteratorTypesArray();
+  if (iteratorTypes.size() != 3 ||
+      iteratorTypes[0] != vector::IteratorType::parallel ||
+      iteratorTypes[1] != vector::IteratorType::parallel ||
+      iteratorTypes[2] != vector::IteratorType::reduction ||
+      contractOp.getIndexingMapsArray() != infer({{m, k}, {k, n}, {m, n}}))
+    return std::nullopt;
+
+  auto lhsTy =
+      cast<VectorType>(getMatMulOperandSource(contractOp.getLhs()).getType());
+  auto rhsTy =
+      cast<VectorType>(getMatMulOperandSource(contractOp.getRhs()).getType());
+  Type lhsElTy = lhsTy.getElementType();
+  Type rhsElTy = rhsTy.getElementType();
+  Type accElTy = accTy.getElementType();
+
+  std::optional<std::array<int64_t, 3>> shape;
+  if (lhsElTy.isBF16() && rhsElTy.isBF16() && accElTy.isF32()) {
+    shape = {4, 8, 4};
+  } else if (lhsElTy.isSignlessInteger() && rhsElTy.isSignlessInteger() &&
+             accElTy.isSignlessInteger()) {
+    // The lhs, rhs and accumulator element widths of every integer matmul,
+    // and the corresponding native shape.
+    static const struct {
+      unsigned lhs, rhs, acc;
+      std::array<int64_t, 3> shape;
+    } intShapes[] = {{8, 4, 32, {4, 16, 8}},  {8, 8, 32, {4, 8, 8}},
+                     {16, 8, 32, {4, 4, 8}},  {16, 16, 32, {4, 2, 8}},
+                     {16, 8, 64, {4, 8, 4}},  {16, 16, 64, {4, 4, 4}},
+                     {32, 16, 64, {4, 2, 4}}};
+    for (const auto &intShape : intShapes)
+      if (lhsElTy.getIntOrFloatBitWidth() == intShape.lhs &&
+          rhsElTy.getIntOrFloatBitWidth() == intShape.rhs &&
+          accElTy.getIntOrFloatBitWidth() == intShape.acc)
+        shape = intShape.shape;
+  }
+  if (!shape)
+    return std::nullopt;
+
+  auto [m0, k0, n0] = *shape;
+  if (accTy.getDimSize(0) % m0 || accTy.getDimSize(1) % n0 ||
+      lhsTy.getDimSize(1) % k0)
+    return std::nullopt;
+  return shape;
+}
+
 namespace xilinx {
 namespace aievec {
 
@@ -2602,6 +2678,107 @@ struct ComputeSignedIntRightShiftOpPattern
   }
 };
 
+// Decompose a `vector.contract` computing a matrix multiplication into
+// `aievec.matmul` ops of the native AIE-ML shape for its element types. The
+// accumulator is split into native blocks, which are computed a register block
+// of `accRows` x `accCols` of them at a time. The accumulators of a register
+// block stay live across the whole reduction dimension, while each lhs (rhs)
+// block of the current step is reused across a row (column) of them.
+struct LowerVectorContractionOpToAIEVecMatMulPattern
+    : public OpConversionPattern<vector::ContractionOp> {
+  using OpConversionPattern<vector::ContractionOp>::OpConversionPattern;
+
+  LowerVectorContractionOpToAIEVecMatMulPattern(MLIRContext *context,
+                                                int64_t accRows = 2,
+                                                int64_t accCols = 2)
+      : OpConversionPattern<vector::ContractionOp>(context), accRows(accRows),
+        accCols(accCols) {}
+
+  LogicalResult
+  matchAndRewrite(vector::ContractionOp contractOp, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto nativeShape = getAIEMLMatMulNativeShape(contractOp);
+    if (!nativeShape)
+      return failure();
+    auto [m0, k0, n0] = *nativeShape;
+
+    Location loc = contractOp.getLoc();
+    Value lhs = getMatMulOperandSource(adaptor.getLhs());
+    Value rhs = getMatMulOperandSource(adaptor.getRhs());
+    Value acc = adaptor.getAcc();
+    auto accTy = cast<VectorType>(acc.getType());
+    int64_t numRows = accTy.getDimSize(0) / m0;
+    int64_t numCols = accTy.getDimSize(1) / n0;
+    int64_t numSteps = cast<VectorType>(lhs.getType()).getDimSize(1) / k0;
+    auto blockTy = VectorType::get({m0, n0}, accTy.getElementType());
+
+    auto extractBlock = [&](Value v, int64_t row, int64_t col, int64_t rows,
+                            int64_t cols) -> Value {
+      auto vTy = cast<VectorType>(v.getType());
+      if (vTy.getDimSize(0) == rows && vTy.getDimSize(1) == cols)
+        return v;
+      return rewriter.create<vector::ExtractStridedSliceOp>(
+          loc, v, ArrayRef<int64_t>{row * rows, col * cols},
+          ArrayRef<int64_t>{rows, cols}, ArrayRef<int64_t>{1, 1});
+    };
+
+    Value result = acc;
+    for (int64_t row0 = 0; row0 < numRows; row0 += accRows) {
+      for (int64_t col0 = 0; col0 < numCols; col0 += accCols) {
+        int64_t rowEnd = std::min(row0 + accRows, numRows);
+        int64_t colEnd = std::min(col0 + accCols, numCols);
+
+        SmallVector<Value> accBlocks;
+        for (int64_t row = row0; row < rowEnd; row++)
+          for (int64_t col = col0; col < colEnd; col++)
+            accBlocks.push_back(extractBlock(acc, row, col, m0, n0));
+
+        for (int64_t step = 0; step < numSteps; step++) {
+          SmallVector<Value> lhsBlocks, rhsBlocks;
+          for (int64_t row = row0; row < rowEnd; row++)
+            lhsBlocks.push_back(extractBlock(lhs, row, step, m0, k0));
+          for (int64_t col = col0; col < colEnd; col++)
+            rhsBlocks.push_back(extractBlock(rhs, step, col, k0, n0));
+
+          Value *accBlock = accBlocks.begin();
+          for (Value lhsBlock : lhsBlocks)
+            for (Value rhsBlock : rhsBlocks) {
+              *accBlock = rewriter.create<aievec::MatMulOp>(
+                  loc, blockTy, lhsBlock, rhsBlock, *accBlock);
+              accBlock++;
+            }
+        }
+
+        if (numRows == 1 && numCols == 1) {
+          result = accBlocks.front();
+          continue;
+        }
+        Value *accBlock = accBlocks.begin();
+        for (int64_t row = row0; row < rowEnd; row++)
+          for (int64_t col = col0; col < colEnd; col++)
+            result = rewriter.create<vector::InsertStridedSliceOp>(
+                loc, *accBlock++, result,
+                ArrayRef<int64_t>{row * m0, col * n0},
+                ArrayRef<int64_t>{1, 1});
+      }
+    }
+    rewriter.replaceOp(contractOp, result);
+
+    // The matmul ops extend their operands themselves, so extensions only
+    // used by this contraction are now dead.
+    for (Value operand : {adaptor.getLhs(), adaptor.getRhs()}) {
+      Operation *extOp = operand.getDefiningOp();
+      if (extOp && isa<arith::ExtSIOp, arith::ExtFOp>(extOp) &&
+          extOp->hasOneUse())
+        rewriter.eraseOp(extOp);
+    }
+
+    return success();
+  }
+
+  int64_t accRows, accCols;
+};
+
 //===----------------------------------------------------------------------===//
 // Pattern collection
 //===----------------------------------------------------------------------===//
@@ -2666,7 +2843,8 @@ static void populateAIEVecV2ConversionPatterns(RewritePatternSet &patterns,
       FoldVectorExtractAndBroadcastToAIEBroadcast,
       ConvertBroadcastToAIEBroadcast,
       ConvertMulAddToAIEVecFMAElemOpPattern,
-      LowerVectorExtractStridedSliceOpAIEMLPattern>(patterns.getContext());
+      LowerVectorExtractStridedSliceOpAIEMLPattern,
+      LowerVectorContractionOpToAIEVecMatMulPattern>(patterns.getContext());
   // clang-format on
 }
 
@@ -3102,6 +3280,12 @@ static void configureAIEVecV1Legalizations(ConversionTarget &target,
 static void configureAIEVecV2Legalizations(ConversionTarget &target,
                                            AnalysisManager &am) {
   target.addLegalOp<UnrealizedConversionCastOp>();
+  // Multi-dimensional slices only take the operands of native matmul ops out
+  // of larger contractions, and are left to the generic Vector lowering.
+  target.addDynamicallyLegalOp<vector::ExtractStridedSliceOp>(
+      [](vector::ExtractStridedSliceOp op) {
+        return op.getSourceVectorType().getRank() > 1;
+      });
 
   // A set recording the vector lane size and element width supported
   llvm::SmallSet<std::pair<unsigned, unsigned>, 16> laneSizeElWidthPairSet;
@@ -3284,6 +3468,11 @@ static void configureAIEVecV2Legalizations(ConversionTarget &target,
     return false;
   });
 
+  target.addDynamicallyLegalOp<vector::ContractionOp>(
+      [](vector::ContractionOp op) {
+        return !getAIEMLMatMulNativeShape(op);
+      });
+
   target.addDynamicallyLegalOp<vector::ReductionOp>(
       [=](vector::ReductionOp op) {
         auto kind = op.getKind();
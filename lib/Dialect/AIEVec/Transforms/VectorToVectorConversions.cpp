@@ -13,6 +13,7 @@
 
 #include "aie/Dialect/AIEVec/AIEVecUtils.h"
 #include "aie/Dialect/AIEVec/Pipelines/Passes.h"
+#include "aie/Dialect/AIEVec/Transforms/IntervalReuse.h"
 #include "aie/Dialect/AIEVec/Utils/Utils.h"
 
 #include "mlir/Conversion/AffineToStandard/AffineToStandard.h"
@@ -22,7 +23,9 @@
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/IR/TypeUtilities.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
 #include "mlir/Pass/PassManager.h"
+#include "mlir/Support/MathExtras.h"
 #include "mlir/Transforms/DialectConversion.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
@@ -258,6 +261,286 @@ struct HoistCastOpToDataSourcePattern : public RewritePattern {
 //============ AIEML canonicalization conversion patterns ===============//
 //============================================================================//
 
+// If the innermost index of `readOp` is the induction variable of `forOp`
+// plus a constant, return that constant.
+static std::optional<int64_t>
+getOffsetFromInductionVar(vector::TransferReadOp readOp,
+                          affine::AffineForOp forOp) {
+  Value idx = readOp.getIndices().back();
+  Value iv = forOp.getInductionVar();
+  if (idx == iv)
+    return 0;
+  auto applyOp = idx.getDefiningOp<affine::AffineApplyOp>();
+  if (!applyOp || applyOp.getMapOperands().size() != 1 ||
+      applyOp.getMapOperands()[0] != iv)
+    return std::nullopt;
+  AffineMap map = applyOp.getAffineMap();
+  if (map.getNumDims() != 1 || map.getNumResults() != 1)
+    return std::nullopt;
+  int64_t offset = map.compose(ArrayRef<int64_t>{0})[0];
+  if (map.getResult(0) != getAffineDimExpr(0, readOp.getContext()) + offset)
+    return std::nullopt;
+  return offset;
+}
+
+// Linearize the indices of `readOp` along the non-vectorized dimensions into
+// the invariant base of the access. Each distinct index value is given its own
+// dimension in `indexDims`, so that reads of the same row get the same base.
+static AffineExpr getInvariantBase(vector::TransferReadOp readOp,
+                                   DenseMap<Value, unsigned> &indexDims) {
+  MLIRContext *context = readOp.getContext();
+  AffineExpr base = getAffineConstantExpr(0, context);
+  for (auto [pos, idx] : llvm::enumerate(readOp.getIndices().drop_back())) {
+    unsigned dim = indexDims.try_emplace(idx, indexDims.size()).first->second;
+    base = base + getAffineDimExpr(dim, context) *
+                      getAffineSymbolExpr(pos, context);
+  }
+  return base;
+}
+
+// Return true if some operation in `forOp` may write to `memref`. As in the
+// rest of the reuse analysis, distinct memrefs are assumed not to alias.
+static bool mayWriteToMemRef(affine::AffineForOp forOp, Value memref) {
+  auto result = forOp.getBody()->walk([&](Operation *op) {
+    auto effectOp = dyn_cast<MemoryEffectOpInterface>(op);
+    if (!effectOp) {
+      if (op->hasTrait<OpTrait::HasRecursiveMemoryEffects>())
+        return WalkResult::advance();
+      return WalkResult::interrupt();
+    }
+    SmallVector<MemoryEffects::EffectInstance, 4> effects;
+    effectOp.getEffects<MemoryEffects::Write>(effects);
+    for (auto &effect : effects)
+      if (!effect.getValue() || effect.getValue() == memref)
+        return WalkResult::interrupt();
+    return WalkResult::advance();
+  });
+  return result.wasInterrupted();
+}
+
+// Return true if the value read by `readOp` is multiplied by an integer,
+// possibly after a sign extension. These reads are left to the convolution
+// folding, which expects both halves of a single wide load.
+static bool feedsIntegerMultiplication(vector::TransferReadOp readOp) {
+  return llvm::any_of(readOp->getUsers(), [](Operation *user) {
+    if (auto extOp = dyn_cast<arith::ExtSIOp>(user))
+      return llvm::any_of(extOp->getUsers(), [](Operation *extUser) {
+        return isa<arith::MulIOp>(extUser);
+      });
+    return isa<arith::MulIOp>(user);
+  });
+}
+
+// A group of reads from the same row of an array in the body of a loop. The
+// window is the range of aligned vectors, in units of the vector length and
+// relative to the induction variable, that covers all the reads in the group.
+struct SlidingWindow {
+  std::unique_ptr<IntervalReuse> reuse;
+  VectorType vType;
+  int64_t first, last;
+  SmallVector<std::pair<vector::TransferReadOp, int64_t>, 8> reads;
+};
+
+// This pattern rewrites the reads of a loop that overlap across iterations
+// into a window of aligned vectors that rotates through registers. If the loop
+// steps by one vector, the window of one iteration is the window of the
+// previous one moved by a single vector. The window for the first iteration is
+// loaded before the loop, every iteration only loads the newest vector, and
+// each read is realigned from two consecutive vectors with an `aievec.shift`:
+//   affine.for %j = 8 to 248 step 8 {
+//     %0 = vector.transfer_read %A[%i, %j - 1]
+//     %1 = vector.transfer_read %A[%i, %j + 1]
+//   }
+// becomes
+//   %w0 = vector.transfer_read %A[%i, 0]
+//   %w1 = vector.transfer_read %A[%i, 8]
+//   affine.for %j = 8 to 248 step 8 iter_args(%a = %w0, %b = %w1) {
+//     %c = vector.transfer_read %A[%i, %j + 8]
+//     %0 = aievec.shift %a, %b, 28
+//     %1 = aievec.shift %b, %c, 4
+//     affine.yield %b, %c
+//   }
+// Without it, each unaligned read is split into two aligned loads.
+struct ReuseSlidingWindowReadsPattern
+    : public OpRewritePattern<affine::AffineForOp> {
+  using OpRewritePattern<affine::AffineForOp>::OpRewritePattern;
+
+  ReuseSlidingWindowReadsPattern(MLIRContext *context, int64_t maxVectorSize,
+                                 int64_t alignment)
+      : OpRewritePattern<affine::AffineForOp>(context),
+        maxVectorSize(maxVectorSize), vectorAlignment(alignment) {}
+
+  // Return true if `readOp` can be served from a window of vectors of its own
+  // length that moves by one vector per iteration of `forOp`.
+  bool isWindowRead(vector::TransferReadOp readOp,
+                    affine::AffineForOp forOp) const {
+    auto vType = readOp.getVectorType();
+    if (readOp.getMask() || vType.getRank() != 1 ||
+        !readOp.getPermutationMap().isMinorIdentity())
+      return false;
+    int64_t vSize = vType.getNumElements() * vType.getElementTypeBitWidth();
+    if (vSize > maxVectorSize || vSize % vectorAlignment ||
+        !llvm::isPowerOf2_64(vSize))
+      return false;
+    int64_t lb = forOp.getConstantLowerBound();
+    if (forOp.getStepAsInt() != vType.getNumElements() ||
+        (lb * vType.getElementTypeBitWidth()) % vectorAlignment)
+      return false;
+    if (!forOp.isDefinedOutsideOfLoop(readOp.getSource()) ||
+        !forOp.isDefinedOutsideOfLoop(readOp.getPadding()) ||
+        !llvm::all_of(readOp.getIndices().drop_back(), [&](Value idx) {
+          return forOp.isDefinedOutsideOfLoop(idx);
+        }))
+      return false;
+    return !feedsIntegerMultiplication(readOp);
+  }
+
+  LogicalResult matchAndRewrite(affine::AffineForOp forOp,
+                                PatternRewriter &rewriter) const override {
+    if (!forOp.hasConstantLowerBound() || forOp.getNumResults())
+      return failure();
+
+    // Group the reads in the body of the loop that may share data. The groups
+    // are limited to windows of two full-size vectors.
+    Block *body = forOp.getBody();
+    DenseMap<Block *, SmallVector<Operation *, 8>> blockToEnclosingLoops;
+    blockToEnclosingLoops[body].push_back(forOp);
+    DenseMap<Operation *, IntervalReuse *> opToIntervalMap;
+    DenseMap<Value, unsigned> indexDims;
+    SmallVector<SlidingWindow, 4> windows;
+    for (auto readOp : body->getOps<vector::TransferReadOp>()) {
+      if (!isWindowRead(readOp, forOp))
+        continue;
+      std::optional<int64_t> offset = getOffsetFromInductionVar(readOp, forOp);
+      if (!offset)
+        continue;
+
+      auto vType = readOp.getVectorType();
+      int64_t vLen = vType.getNumElements();
+      int64_t first = floorDiv(*offset, vLen);
+      int64_t last = ceilDiv(*offset + vLen, vLen) - 1;
+      int64_t maxWindowLen = 2 * maxVectorSize / getVectorSizeInBits(vType);
+      AffineExpr base = getInvariantBase(readOp, indexDims);
+      SlidingWindow *window = nullptr;
+      for (auto &candidate : windows) {
+        int64_t windowLen = std::max(candidate.last, last) -
+                            std::min(candidate.first, first) + 1;
+        if (candidate.vType == vType && windowLen <= maxWindowLen &&
+            candidate.reuse->potentialReuse(readOp, base,
+                                            blockToEnclosingLoops)) {
+          window = &candidate;
+          break;
+        }
+      }
+      if (!window) {
+        windows.push_back({std::make_unique<IntervalReuse>(readOp, base),
+                           vType, first, last, {}});
+        window = &windows.back();
+      }
+      int32_t vSize = getVectorSizeInBits(vType);
+      window->reuse->insertInterval(readOp, opToIntervalMap, *offset,
+                                    /*loopStepSize=*/1, /*isSplat=*/false,
+                                    vSize);
+      auto extent = window->reuse->getAccessExtent(readOp);
+      window->first = std::min<int64_t>(window->first, extent.first / vSize);
+      window->last = std::max<int64_t>(window->last, extent.second / vSize - 1);
+      window->reads.push_back({readOp, *offset});
+    }
+
+    // Only a window of more than one vector has data to carry over to the
+    // next iteration.
+    llvm::erase_if(windows, [&](const SlidingWindow &window) {
+      return window.last == window.first ||
+             mayWriteToMemRef(forOp, window.reads.front().first.getSource());
+    });
+    if (windows.empty())
+      return failure();
+
+    Location loc = forOp.getLoc();
+    auto readVector = [&](const SlidingWindow &window,
+                          Value innerMostIdx) -> Value {
+      vector::TransferReadOp refReadOp = window.reads.front().first;
+      SmallVector<Value, 4> indices(refReadOp.getIndices().drop_back());
+      indices.push_back(innerMostIdx);
+      return rewriter
+          .create<vector::TransferReadOp>(loc, window.vType,
+                                          refReadOp.getSource(), indices,
+                                          refReadOp.getPadding())
+          .getResult();
+    };
+
+    // Load all but the last vector of each window for the first iteration.
+    rewriter.setInsertionPoint(forOp);
+    int64_t lb = forOp.getConstantLowerBound();
+    SmallVector<Value, 8> initArgs;
+    for (auto &window : windows) {
+      int64_t vLen = window.vType.getNumElements();
+      for (int64_t i = window.first; i < window.last; ++i)
+        initArgs.push_back(readVector(
+            window,
+            rewriter.create<arith::ConstantIndexOp>(loc, lb + i * vLen)));
+    }
+    auto newForOp = rewriter.create<affine::AffineForOp>(
+        loc, forOp.getLowerBoundOperands(), forOp.getLowerBoundMap(),
+        forOp.getUpperBoundOperands(), forOp.getUpperBoundMap(),
+        forOp.getStepAsInt(), initArgs);
+    Block *newBody = newForOp.getBody();
+    rewriter.mergeBlocks(body, newBody, newBody->getArguments().take_front());
+
+    Value iv = newForOp.getInductionVar();
+    auto carried = newBody->getArguments().drop_front();
+    SmallVector<Value, 8> yieldValues;
+    for (auto &window : windows) {
+      VectorType vType = window.vType;
+      int64_t vLen = vType.getNumElements();
+
+      // Every iteration loads the last vector of its window.
+      rewriter.setInsertionPointToStart(newBody);
+      Value lastIdx = iv;
+      if (window.last != 0)
+        lastIdx = rewriter.create<affine::AffineApplyOp>(
+            loc,
+            AffineMap::get(1, 0,
+                           getAffineDimExpr(0, rewriter.getContext()) +
+                               window.last * vLen),
+            ValueRange{iv});
+      int64_t numCarried = window.last - window.first;
+      SmallVector<Value, 4> vecs(carried.take_front(numCarried));
+      carried = carried.drop_front(numCarried);
+      vecs.push_back(readVector(window, lastIdx));
+
+      // Realign each read from the vectors in the window.
+      int32_t elemSizeInBytes = getElementSizeInBits(vType) / 8;
+      for (auto [readOp, offset] : window.reads) {
+        int64_t pos = floorDiv(offset, vLen) - window.first;
+        int64_t shift = mod(offset, vLen);
+        if (shift == 0) {
+          rewriter.replaceOp(readOp, vecs[pos]);
+          continue;
+        }
+        rewriter.setInsertionPoint(readOp);
+        auto shiftBytesConstOp = rewriter.create<arith::ConstantOp>(
+            readOp.getLoc(), rewriter.getIntegerType(32),
+            rewriter.getI32IntegerAttr(shift * elemSizeInBytes));
+        rewriter.replaceOpWithNewOp<aievec::ShiftOp>(
+            readOp, vType, vecs[pos], vecs[pos + 1], shiftBytesConstOp);
+      }
+
+      // Move the window by one vector for the next iteration.
+      yieldValues.append(std::next(vecs.begin()), vecs.end());
+    }
+
+    auto yieldOp = cast<affine::AffineYieldOp>(newBody->getTerminator());
+    rewriter.setInsertionPoint(yieldOp);
+    rewriter.replaceOpWithNewOp<affine::AffineYieldOp>(yieldOp, yieldValues);
+    rewriter.eraseOp(forOp);
+    return success();
+  }
+
+  int64_t maxVectorSize;
+  int64_t vectorAlignment;
+};
+
 //============================================================================//
 //================ Common AIE canonicalization configuration =================//
 //============================================================================//
@@ -414,6 +697,43 @@ static std::unique_ptr<::mlir::Pass> createHoistCastOpToDataSourcePass() {
   return std::make_unique<HoistCastOpToDataSourcePass>();
 }
 
+// This pass keeps the data of reads that overlap across the iterations of a
+// loop in registers, so that each vector of a row is only loaded once. It must
+// run before unaligned transfer reads are split into aligned ones.
+struct ReuseSlidingWindowReadsPass
+    : public PassWrapper<ReuseSlidingWindowReadsPass, OperationPass<>> {
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(ReuseSlidingWindowReadsPass)
+
+  // In case we want to register this pass as a standalone pass for test
+  // purposes.
+  StringRef getArgument() const final {
+    return "test-aievec-sliding-window-reads";
+  }
+
+  StringRef getDescription() const final {
+    return "Rotate overlapping loop reads through registers";
+  }
+
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<affine::AffineDialect, arith::ArithDialect,
+                    vector::VectorDialect, xilinx::aievec::AIEVecDialect>();
+  }
+
+  void runOnOperation() override {
+    auto op = getOperation();
+    MLIRContext *context = &getContext();
+    RewritePatternSet patterns(context);
+
+    patterns.add<ReuseSlidingWindowReadsPattern>(context, 512, 256);
+
+    (void)applyPatternsAndFoldGreedily(op, std::move(patterns));
+  }
+};
+
+static std::unique_ptr<::mlir::Pass> createReuseSlidingWindowReadsPass() {
+  return std::make_unique<ReuseSlidingWindowReadsPass>();
+}
+
 //============================================================================//
 //=============== Main Vector2Vector Pipeline Configuration ==================//
 //============================================================================//
@@ -424,6 +744,8 @@ void xilinx::aievec::buildCanonicalizeVectorForAIEVec(
   // TODO: Add passes to unroll vector with unsupported types
   // TODO: Add passes to split vectors that won't fit in registers
   pm.addPass(createCopyRemovalPass());
+  if (options.aieTarget == "aieml")
+    pm.addPass(createReuseSlidingWindowReadsPass());
   pm.addPass(createCanonicalizeVectorForAIEVecPass(options));
   pm.addPass(createHoistCastOpToDataSourcePass());
 }
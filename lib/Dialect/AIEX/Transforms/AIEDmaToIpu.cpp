@@ -8,6 +8,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "aie/Dialect/AIE/IR/AIEDeviceIndex.h"
 #include "aie/Dialect/AIEX/IR/AIEXDialect.h"
 #include "aie/Dialect/AIEX/Transforms/AIEXPasses.h"
 
@@ -84,25 +85,13 @@ struct RtpToIpuPattern : public OpConversionPattern<IpuWriteRTPOp> {
   }
 };
 
-std::optional<AIE::ShimDMAAllocationOp>
-getAllocOpForSymbol(AIE::DeviceOp dev, StringRef sym_name) {
-  auto sym = dev.lookupSymbol(sym_name);
-  if (!sym)
-    return std::nullopt;
-
-  auto uses = SymbolTable::getSymbolUses(sym, dev);
-  for (auto use : *uses)
-    if (auto infoOp = dyn_cast<AIE::ShimDMAAllocationOp>(use.getUser()))
-      return infoOp;
-
-  return std::nullopt;
-}
-
 struct PushToIpuPattern : public OpConversionPattern<IpuShimTilePushQueueOp> {
   using OpConversionPattern<IpuShimTilePushQueueOp>::OpConversionPattern;
 
-  PushToIpuPattern(MLIRContext *context, PatternBenefit benefit = 1)
-      : OpConversionPattern<IpuShimTilePushQueueOp>(context, benefit) {}
+  PushToIpuPattern(MLIRContext *context, const AIE::DeviceIndex &index,
+                   PatternBenefit benefit = 1)
+      : OpConversionPattern<IpuShimTilePushQueueOp>(context, benefit),
+        index(index) {}
 
   LogicalResult
   matchAndRewrite(IpuShimTilePushQueueOp op, OpAdaptor adaptor,
@@ -123,11 +112,7 @@ struct PushToIpuPattern : public OpConversionPattern<IpuShimTilePushQueueOp> {
     auto address = uzero;
     auto value = uzero;
 
-    auto dev = op->getParentOfType<AIE::DeviceOp>();
-    if (!dev)
-      return failure();
-
-    auto infoOp = getAllocOpForSymbol(dev, op.getMetadata());
+    auto infoOp = index.getShimDMAAllocation(op.getMetadata());
     if (!infoOp)
       return failure();
 
@@ -164,13 +149,18 @@ struct PushToIpuPattern : public OpConversionPattern<IpuShimTilePushQueueOp> {
     rewriter.eraseOp(op);
     return success();
   }
+
+private:
+  const AIE::DeviceIndex &index;
 };
 
 struct DmaToIpuPattern : public OpConversionPattern<IpuDmaMemcpyNdOp> {
   using OpConversionPattern<IpuDmaMemcpyNdOp>::OpConversionPattern;
 
-  DmaToIpuPattern(MLIRContext *context, PatternBenefit benefit = 1)
-      : OpConversionPattern<IpuDmaMemcpyNdOp>(context, benefit) {}
+  DmaToIpuPattern(MLIRContext *context, const AIE::DeviceIndex &index,
+                  PatternBenefit benefit = 1)
+      : OpConversionPattern<IpuDmaMemcpyNdOp>(context, benefit),
+        index(index) {}
 
   LogicalResult
   matchAndRewrite(IpuDmaMemcpyNdOp op, OpAdaptor adaptor,
@@ -180,11 +170,7 @@ struct DmaToIpuPattern : public OpConversionPattern<IpuDmaMemcpyNdOp> {
     auto zero = IntegerAttr::get(i32ty, 0);
     auto memref = adaptor.getMemref();
 
-    auto dev = op->getParentOfType<AIE::DeviceOp>();
-    if (!dev)
-      return failure();
-
-    auto infoOp = getAllocOpForSymbol(dev, op.getMetadata());
+    auto infoOp = index.getShimDMAAllocation(op.getMetadata());
     if (!infoOp)
       return failure();
 
@@ -371,6 +357,9 @@ struct DmaToIpuPattern : public OpConversionPattern<IpuDmaMemcpyNdOp> {
     rewriter.eraseOp(op);
     return success();
   }
+
+private:
+  const AIE::DeviceIndex &index;
 };
 
 struct AIEDmaToIpuPass : public AIEDmaToIpuBase<AIEDmaToIpuPass> {
@@ -386,13 +375,16 @@ struct AIEDmaToIpuPass : public AIEDmaToIpuBase<AIEDmaToIpuPass> {
     target.addIllegalOp<IpuDmaMemcpyNdOp>();
     target.addIllegalOp<IpuShimTilePushQueueOp>();
 
+    const auto &index = getAnalysis<AIE::DeviceIndex>();
     RewritePatternSet patterns(&getContext());
-    patterns.insert<DmaToIpuPattern>(&getContext());
-    patterns.insert<PushToIpuPattern>(&getContext());
+    patterns.insert<DmaToIpuPattern>(&getContext(), index);
+    patterns.insert<PushToIpuPattern>(&getContext(), index);
     patterns.insert<RtpToIpuPattern>(&getContext());
 
     if (failed(applyPartialConversion(device, target, std::move(patterns))))
       signalPassFailure();
+    // Only the runtime sequence is rewritten.
+    markAnalysesPreserved<AIE::DeviceIndex>();
   }
 };
 
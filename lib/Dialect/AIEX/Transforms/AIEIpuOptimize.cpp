@@ -0,0 +1,371 @@
+//===- AIEIpuOptimize.cpp ---------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+//
+// Peephole optimizations on the straight-line IPU instruction sequences
+// produced by aie-dma-to-ipu:
+//
+//  - a write32 to a configuration register is dropped if the register is
+//    overwritten, or already holds the same value, with no intervening sync
+//    or queue push;
+//  - a sync on a shim channel is dropped if it repeats the previous sync on
+//    the same channel and no task issuing a token was pushed onto that
+//    channel in between;
+//  - a shim BD write is dropped if the BD already holds the same
+//    configuration, or if another BD on the column does, in which case the
+//    queue pushes of the BD are redirected to it. A push is only redirected
+//    if a sync retires its task before the other BD is written again.
+//
+// Only the start queues of the shim DMA are recognized. Pushes onto the
+// queues of other tiles are kept as they are, and so are the syncs on their
+// channels, since the tokens those pushes issue are not counted.
+//
+// Writes to the shim DMA start queues are never removed: each one starts a
+// task. Neither are writes to lock, queue, status or memory registers, which
+// the hardware changes underneath the sequence.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Dialect/AIE/IR/AIEDeviceIndex.h"
+#include "aie/Dialect/AIEX/IR/AIEXDialect.h"
+#include "aie/Dialect/AIEX/Transforms/AIEXPasses.h"
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Pass/Pass.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/Statistic.h"
+
+#define DEBUG_TYPE "aie-ipu-optimize"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIEX;
+
+STATISTIC(numWritesRemoved, "Number of redundant write32 ops removed");
+STATISTIC(numSyncsRemoved, "Number of redundant sync ops removed");
+STATISTIC(numBdWritesRemoved, "Number of shim BD writes removed");
+
+// Shim tile DMA registers, matching the lowering in AIEDmaToIpu.cpp.
+static constexpr uint32_t shimBdBase = 0x1D000;
+static constexpr uint32_t shimBdStride = 0x20;
+static constexpr uint32_t shimNumBds = 16;
+static constexpr uint32_t shimS2MMQueue = 0x1D204;
+static constexpr uint32_t shimMM2SQueue = 0x1D214;
+static constexpr uint32_t queueChannelStride = 0x8;
+static constexpr uint32_t queueBdMask = 0xF;
+static constexpr uint32_t queueIssueToken = 0x80000000;
+
+// Registers that only the instruction sequence writes: the DMA BDs and the
+// stream switch configuration of the shim, memory and compute tiles.
+static constexpr std::pair<uint32_t, uint32_t> configurationRegisters[] = {
+    {0x1D000, 0x1D200}, // Shim and compute tile DMA BDs.
+    {0xA0000, 0xA0600}, // Memory tile DMA BDs.
+    {0x3F000, 0x3F400}, // Shim and compute tile stream switch.
+    {0xB0000, 0xB0400}, // Memory tile stream switch.
+};
+
+namespace {
+
+// (column, row, address) of a register written by write32.
+using RegisterKey = std::tuple<uint32_t, uint32_t, uint32_t>;
+// (column, row, direction, channel) of a DMA channel, with direction 0 for
+// S2MM and 1 for MM2S as in IpuSyncOp.
+using ChannelKey = std::tuple<uint32_t, uint32_t, uint32_t, uint32_t>;
+// (column, BD id) of a shim BD.
+using BdKey = std::pair<uint32_t, uint32_t>;
+
+struct QueuePush {
+  ChannelKey channel;
+  uint32_t bd;
+  bool issueToken;
+};
+
+// The task pushed by op onto a shim DMA start queue, if any.
+std::optional<QueuePush> getQueuePush(IpuWrite32Op op) {
+  if (op.getRow() != 0)
+    return std::nullopt;
+  uint32_t address = op.getAddress();
+  for (uint32_t direction : {0, 1}) {
+    uint32_t queue = direction ? shimMM2SQueue : shimS2MMQueue;
+    for (uint32_t channel : {0, 1})
+      if (address == queue + channel * queueChannelStride)
+        return QueuePush{{op.getColumn(), 0, direction, channel},
+                         op.getValue() & queueBdMask,
+                         (op.getValue() & queueIssueToken) != 0};
+  }
+  return std::nullopt;
+}
+
+std::optional<uint32_t> getShimBd(IpuWrite32Op op) {
+  uint32_t address = op.getAddress();
+  if (op.getRow() != 0 || address < shimBdBase ||
+      address >= shimBdBase + shimNumBds * shimBdStride)
+    return std::nullopt;
+  return (address - shimBdBase) / shimBdStride;
+}
+
+bool isConfigurationRegister(uint32_t address) {
+  return llvm::any_of(configurationRegisters, [&](auto range) {
+    return address >= range.first && address < range.second;
+  });
+}
+
+// The configuration of a BD write, without the BD id it is written to.
+DictionaryAttr getBdConfig(IpuWriteBdExShimTileOp op) {
+  NamedAttrList attrs(op->getAttrDictionary());
+  attrs.erase(op.getBdIdAttrName());
+  return attrs.getDictionary(op->getContext());
+}
+
+class IpuSequenceOptimizer {
+public:
+  void run(Block &block) {
+    for (Operation &op : llvm::make_early_inc_range(block)) {
+      if (auto write = dyn_cast<IpuWrite32Op>(op))
+        visitWrite32(write);
+      else if (auto sync = dyn_cast<IpuSyncOp>(op))
+        visitSync(sync);
+      else if (auto writeBd = dyn_cast<IpuWriteBdExShimTileOp>(op))
+        visitWriteBd(writeBd);
+      else if (!op.hasTrait<OpTrait::IsTerminator>())
+        reset(&op);
+    }
+    // BD writes that were never needed again are dropped for good.
+    dropDeferredBds();
+  }
+
+private:
+  void visitWrite32(IpuWrite32Op op) {
+    if (auto push = getQueuePush(op)) {
+      visitQueuePush(op, *push);
+      return;
+    }
+
+    // A BD write that was put off has to land before the write32 patches the
+    // BD, or it would overwrite it.
+    if (auto bd = getShimBd(op)) {
+      BdKey key{op.getColumn(), *bd};
+      if (deferredBds.contains(key))
+        flushDeferredBd(key, op);
+      invalidateBd(key);
+    }
+
+    if (!isConfigurationRegister(op.getAddress()))
+      return;
+
+    RegisterKey key{op.getColumn(), op.getRow(), op.getAddress()};
+    auto known = registerValues.find(key);
+    if (known != registerValues.end() && known->second == op.getValue()) {
+      op.erase();
+      numWritesRemoved++;
+      return;
+    }
+    auto pending = pendingWrites.find(key);
+    if (pending != pendingWrites.end()) {
+      pending->second.erase();
+      numWritesRemoved++;
+    }
+    registerValues[key] = op.getValue();
+    pendingWrites[key] = op;
+  }
+
+  void visitQueuePush(IpuWrite32Op op, const QueuePush &push) {
+    // The task reads whatever has been written so far, so earlier writes can
+    // no longer be overwritten in place, and it may change what the registers
+    // hold.
+    pendingWrites.clear();
+    registerValues.clear();
+
+    BdKey bd{std::get<0>(push.channel), push.bd};
+    auto alias = bdAliases.find(bd);
+    if (alias != bdAliases.end() &&
+        isRetiredBeforeRewrite(op, push, {bd.first, alias->second})) {
+      uint32_t value = (op.getValue() & ~queueBdMask) | alias->second;
+      op.setValueAttr(IntegerAttr::get(op.getValueAttr().getType(), value));
+    } else if (deferredBds.contains(bd)) {
+      flushDeferredBd(bd, op);
+    }
+
+    if (push.issueToken)
+      pendingTokens[push.channel]++;
+  }
+
+  void visitSync(IpuSyncOp op) {
+    pendingWrites.clear();
+    registerValues.clear();
+
+    if (op.getColumnNum() != 1 || op.getRowNum() != 1) {
+      lastSyncs.clear();
+      return;
+    }
+    if (op.getRow() != 0)
+      return;
+    ChannelKey channel{op.getColumn(), op.getRow(), op.getDirection(),
+                       op.getChannel()};
+    int &tokens = pendingTokens[channel];
+    if (tokens <= 0 && lastSyncs.contains(channel)) {
+      op.erase();
+      numSyncsRemoved++;
+      return;
+    }
+    if (tokens > 0)
+      tokens--;
+    lastSyncs.insert(channel);
+  }
+
+  void visitWriteBd(IpuWriteBdExShimTileOp op) {
+    BdKey bd{op.getColumn(), op.getBdId()};
+    bdAliases.erase(bd);
+    if (auto deferred = deferredBds.find(bd); deferred != deferredBds.end()) {
+      deferred->second->destroy();
+      deferredBds.erase(deferred);
+      numBdWritesRemoved++;
+    }
+
+    // The DMA advances the current iteration of a BD as it runs, so a BD
+    // with an iteration wrap is always rewritten.
+    if (op.getIterationWrap() != 0) {
+      invalidateBd(bd);
+      return;
+    }
+
+    DictionaryAttr config = getBdConfig(op);
+    auto programmed = programmedBds.find(bd);
+    if (programmed != programmedBds.end() && programmed->second == config) {
+      op.erase();
+      numBdWritesRemoved++;
+      return;
+    }
+
+    for (auto &it : programmedBds) {
+      if (it.first.first != bd.first || it.second != config)
+        continue;
+      bdAliases[bd] = it.first.second;
+      op->remove();
+      deferredBds[bd] = op;
+      return;
+    }
+
+    program(bd, config);
+  }
+
+  // Record that bd now holds config. Pushes that were redirected to bd
+  // because it held their configuration fall back to their own BD, which
+  // is rewritten before its next push.
+  void program(BdKey bd, DictionaryAttr config) {
+    invalidateBd(bd);
+    programmedBds[bd] = config;
+  }
+
+  void invalidateBd(BdKey bd) {
+    programmedBds.erase(bd);
+    for (auto it = bdAliases.begin(); it != bdAliases.end();) {
+      auto current = it++;
+      if (current->first.first == bd.first && current->second == bd.second)
+        bdAliases.erase(current);
+    }
+  }
+
+  // Whether a sync retires the task that op pushes before bd is written
+  // again, so that the task can run from bd. Tasks on a channel complete in
+  // order, so this takes one sync for every token pending on the channel,
+  // and the task must issue a token itself.
+  bool isRetiredBeforeRewrite(IpuWrite32Op op, const QueuePush &push,
+                              BdKey bd) {
+    if (!push.issueToken)
+      return false;
+    int syncs = pendingTokens.lookup(push.channel) + 1;
+    for (Operation *next = op->getNextNode(); next;
+         next = next->getNextNode()) {
+      if (auto sync = dyn_cast<IpuSyncOp>(next)) {
+        ChannelKey channel{sync.getColumn(), sync.getRow(),
+                           sync.getDirection(), sync.getChannel()};
+        if (sync.getColumnNum() == 1 && sync.getRowNum() == 1 &&
+            channel == push.channel && --syncs == 0)
+          return true;
+      } else if (auto write = dyn_cast<IpuWrite32Op>(next)) {
+        auto patched = getShimBd(write);
+        if (patched && BdKey{write.getColumn(), *patched} == bd)
+          return false;
+      } else if (auto writeBd = dyn_cast<IpuWriteBdExShimTileOp>(next)) {
+        if (BdKey{writeBd.getColumn(), writeBd.getBdId()} == bd)
+          return false;
+      } else {
+        // Any other op may write the BD, and the sequence may end with the
+        // task still running.
+        return false;
+      }
+    }
+    return false;
+  }
+
+  // Put the deferred write of bd back into the block before op.
+  void flushDeferredBd(BdKey bd, Operation *op) {
+    IpuWriteBdExShimTileOp writeBd = deferredBds.lookup(bd);
+    deferredBds.erase(bd);
+    bdAliases.erase(bd);
+    op->getBlock()->getOperations().insert(Block::iterator(op), writeBd);
+    program(bd, getBdConfig(writeBd));
+  }
+
+  // An op we know nothing about may touch any register, wait on any channel
+  // or push any BD, so every deferred BD write is emitted before it.
+  void reset(Operation *op) {
+    SmallVector<BdKey> deferred(llvm::make_first_range(deferredBds));
+    llvm::sort(deferred);
+    for (BdKey bd : deferred)
+      flushDeferredBd(bd, op);
+
+    pendingWrites.clear();
+    registerValues.clear();
+    lastSyncs.clear();
+    pendingTokens.clear();
+    bdAliases.clear();
+    programmedBds.clear();
+  }
+
+  // Deferred BD writes are unlinked from the block until they are needed.
+  void dropDeferredBds() {
+    for (auto &it : deferredBds) {
+      it.second->destroy();
+      numBdWritesRemoved++;
+    }
+    deferredBds.clear();
+  }
+
+  DenseMap<RegisterKey, IpuWrite32Op> pendingWrites;
+  DenseMap<RegisterKey, uint32_t> registerValues;
+  DenseSet<ChannelKey> lastSyncs;
+  DenseMap<ChannelKey, int> pendingTokens;
+  DenseMap<BdKey, DictionaryAttr> programmedBds;
+  DenseMap<BdKey, uint32_t> bdAliases;
+  DenseMap<BdKey, IpuWriteBdExShimTileOp> deferredBds;
+};
+
+} // namespace
+
+struct AIEIpuOptimizePass : public AIEIpuOptimizeBase<AIEIpuOptimizePass> {
+  void runOnOperation() override {
+    AIE::DeviceOp device = getOperation();
+    for (auto f : device.getOps<func::FuncOp>()) {
+      if (f.isDeclaration())
+        continue;
+      IpuSequenceOptimizer().run(f.getBody().front());
+    }
+    markAnalysesPreserved<AIE::DeviceIndex>();
+  }
+};
+
+std::unique_ptr<OperationPass<AIE::DeviceOp>>
+xilinx::AIEX::createAIEIpuOptimizePass() {
+  return std::make_unique<AIEIpuOptimizePass>();
+}
@@ -8,6 +8,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "aie/Dialect/AIE/IR/AIEDeviceIndex.h"
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
 #include "aie/Dialect/AIEX/AIETokenAnalysis.h"
 #include "aie/Dialect/AIEX/IR/AIEXDialect.h"
@@ -37,9 +38,11 @@ static TileOp dstTileOp(xilinx::AIEX::MemcpyOp op) {
 
 struct LowerAIEMemcpy : public OpConversionPattern<MemcpyOp> {
   using OpConversionPattern<MemcpyOp>::OpConversionPattern;
+  const DeviceIndex &index;
 
-  LowerAIEMemcpy(MLIRContext *context, PatternBenefit benefit = 1)
-      : OpConversionPattern<MemcpyOp>(context, benefit) {}
+  LowerAIEMemcpy(MLIRContext *context, const DeviceIndex &index,
+                 PatternBenefit benefit = 1)
+      : OpConversionPattern<MemcpyOp>(context, benefit), index(index) {}
 
   void createDMABlocksAndOps(MemOp &mem, StringRef tokenName, int acquireTknVal,
                              int releaseTknVal, Value buf, int offset, int len,
@@ -84,8 +87,8 @@ struct LowerAIEMemcpy : public OpConversionPattern<MemcpyOp> {
     int srcLen = op.getSrcLenValue();
     int dstLen = op.getDstLenValue();
 
-    MemOp srcMem = srcTileOp(op).getMemOp();
-    MemOp dstMem = dstTileOp(op).getMemOp();
+    MemOp srcMem = index.getMem(srcTileOp(op));
+    MemOp dstMem = index.getMem(dstTileOp(op));
 
     createDMABlocksAndOps(srcMem, tokenName, acquireTknVal, releaseTknVal,
                           srcBuf, srcOffset, srcLen, DMAChannelDir::MM2S, 0,
@@ -135,7 +138,11 @@ struct AIELowerMemcpyPass : public AIELowerMemcpyBase<AIELowerMemcpyPass> {
     target.addLegalOp<UseTokenOp>();
     target.addLegalOp<NextBDOp>();
 
-    patterns.insert<LowerAIEMemcpy>(&getContext());
+    // Only flows and the blocks of existing mems are created, so the index
+    // stays valid.
+    const auto &index = getAnalysis<DeviceIndex>();
+    markAnalysesPreserved<DeviceIndex>();
+    patterns.insert<LowerAIEMemcpy>(&getContext(), index);
 
     if (failed(applyPartialConversion(device, target, std::move(patterns))))
       signalPassFailure();
@@ -13,7 +13,7 @@
  * Converts the flows into a JSON file to be read by other tools.
  */
 
-#include "AIETargets.h"
+#include "aie/Targets/AIETargets.h"
 
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
 
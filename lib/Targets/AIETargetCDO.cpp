@@ -6,8 +6,9 @@
 //===----------------------------------------------------------------------===//
 
 #include "AIETargetShared.h"
-#include "AIETargets.h"
+#include "aie/Targets/AIETargets.h"
 
+#include "aie/Dialect/AIE/IR/AIEDeviceIndex.h"
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
 #include "aie/Dialect/AIEX/IR/AIEXDialect.h"
 
@@ -144,6 +145,7 @@ mlir::LogicalResult AIETranslateToCDO(ModuleOp m, raw_ostream &output) {
 
   DeviceOp targetOp = *(m.getOps<DeviceOp>().begin());
   auto &target_model = targetOp.getTargetModel();
+  DeviceIndex index(targetOp);
 
   output << cdoGenFileHeader();
   output << "XAie_InstDeclare(DevInst, &ConfigPtr);   // Declare global device "
@@ -166,7 +168,7 @@ mlir::LogicalResult AIETranslateToCDO(ModuleOp m, raw_ostream &output) {
     if (tileOp.isShimNOCorPLTile()) {
       // Resets no needed with V2 kernel driver
     } else {
-      if (auto coreOp = tileOp.getCoreOp()) {
+      if (auto coreOp = index.getCore(tileOp)) {
         std::string fileName;
         if (auto fileAttr = coreOp->getAttrOfType<StringAttr>("elf_file")) {
           fileName = std::string(fileAttr.getValue());
@@ -198,7 +200,7 @@ mlir::LogicalResult AIETranslateToCDO(ModuleOp m, raw_ostream &output) {
     int col = tileOp.colIndex();
     int row = tileOp.rowIndex();
     if (!tileOp.isShimTile()) {
-      if (auto coreOp = tileOp.getCoreOp()) {
+      if (auto coreOp = index.getCore(tileOp)) {
         output << "XAie_CoreEnable(" << deviceInstRef << ", "
                << tileLocStr(col, row) << ");\n";
       }
@@ -223,7 +225,7 @@ mlir::LogicalResult AIETranslateToCDO(ModuleOp m, raw_ostream &output) {
     int col = tileOp.colIndex();
     int row = tileOp.rowIndex();
     if (!tileOp.isShimTile()) {
-      if (auto coreOp = tileOp.getCoreOp()) {
+      if (auto coreOp = index.getCore(tileOp)) {
         output << "XAie_CoreReset(" << deviceInstRef << ", "
                << tileLocStr(col, row) << ");\n";
         output << "XAie_CoreUnreset(" << deviceInstRef << ", "
@@ -335,6 +337,7 @@ mlir::LogicalResult AIETranslateToCDO(ModuleOp m, raw_ostream &output) {
       //      StringRef FifoMode = disable; // FIXME: when to enable FIFO mode?
       int ndims = 0;
       ArrayRef<DimTupleAttr> dims;
+      std::optional<DimTupleAttr> iteration;
       for (auto op : block.getOps<DMABDOp>()) {
         foundBd = true;
         ShapedType bufferType =
@@ -358,6 +361,7 @@ mlir::LogicalResult AIETranslateToCDO(ModuleOp m, raw_ostream &output) {
           dims = *op.getDimensions();
           ndims = dims.size();
         }
+        iteration = op.getIteration();
       }
 
       if (hasA && hasB) {
@@ -424,6 +428,13 @@ mlir::LogicalResult AIETranslateToCDO(ModuleOp m, raw_ostream &output) {
           generateXAieDmaSetMultiDimAddr(output, ndims, dims, col, row, bdNum,
                                          BaseAddrA, offsetA, lenA, bytesA, "");
         }
+        if (iteration) {
+          output << "XAie_DmaSetBdIteration("
+                 << tileDMAInstRefStr(col, row, bdNum) << ", "
+                 << " /* stepsize */ " << iteration->getStepsize() << ", "
+                 << " /* wrap */ " << iteration->getWrap() << ", "
+                 << " /* current */ 0);\n";
+        }
 
         if (block.getNumSuccessors() > 0) {
           Block *nextBlock = block.getSuccessors()[0]; // should have only one
@@ -523,6 +534,7 @@ mlir::LogicalResult AIETranslateToCDO(ModuleOp m, raw_ostream &output) {
       StringRef AbMode = disable;
       int ndims = 0;
       ArrayRef<DimTupleAttr> dims;
+      std::optional<DimTupleAttr> iteration;
       //      StringRef FifoMode = disable; // FIXME: when to enable FIFO mode?
       for (auto op : block.getOps<DMABDOp>()) {
         foundBd = true;
@@ -547,6 +559,7 @@ mlir::LogicalResult AIETranslateToCDO(ModuleOp m, raw_ostream &output) {
           dims = *op.getDimensions();
           ndims = dims.size();
         }
+        iteration = op.getIteration();
       }
 
       if (hasA && hasB) {
@@ -614,6 +627,13 @@ mlir::LogicalResult AIETranslateToCDO(ModuleOp m, raw_ostream &output) {
           generateXAieDmaSetMultiDimAddr(output, ndims, dims, col, row, bdNum,
                                          BaseAddrA, offsetA, lenA, bytesA, "");
         }
+        if (iteration) {
+          output << "XAie_DmaSetBdIteration("
+                 << tileDMAInstRefStr(col, row, bdNum) << ", "
+                 << " /* stepsize */ " << iteration->getStepsize() << ", "
+                 << " /* wrap */ " << iteration->getWrap() << ", "
+                 << " /* current */ 0);\n";
+        }
 
         if (block.getNumSuccessors() > 0) {
           Block *nextBlock = block.getSuccessors()[0]; // should have only one
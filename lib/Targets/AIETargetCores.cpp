@@ -0,0 +1,99 @@
+//===- AIETargetCores.cpp ---------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+//
+// In-process, per-core lowering of a placed design. This does in one process
+// what aiecc otherwise does with one aie-opt and two aie-translate
+// invocations per core, each of which re-parses the whole design: the module
+// is parsed once by the caller, cloned for each core, and the cores are
+// lowered in parallel.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Targets/AIETargets.h"
+
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+
+#include "mlir/IR/Threading.h"
+#include "mlir/Pass/PassManager.h"
+#include "mlir/Pass/PassRegistry.h"
+#include "mlir/Target/LLVMIR/Dialect/Builtin/BuiltinToLLVMIRTranslation.h"
+#include "mlir/Target/LLVMIR/Dialect/LLVMIR/LLVMToLLVMIRTranslation.h"
+#include "mlir/Target/LLVMIR/Export.h"
+
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+namespace {
+struct CoreArtifacts {
+  std::unique_ptr<PassManager> pm;
+  std::string llvmIR;
+  std::string linkerScript;
+};
+} // namespace
+
+LogicalResult xilinx::AIE::AIETranslateCores(
+    ModuleOp module, ArrayRef<TileID> cores, StringRef passPipeline, bool bcf,
+    function_ref<void(TileID, StringRef, StringRef)> emit) {
+  MLIRContext *ctx = module.getContext();
+
+  // Everything that loads dialects or registers interfaces in the context
+  // happens here, before the workers start sharing it.
+  DialectRegistry registry;
+  registerBuiltinDialectTranslation(registry);
+  registerLLVMDialectTranslation(registry);
+  std::vector<CoreArtifacts> artifacts(cores.size());
+  for (auto [core, artifact] : llvm::zip(cores, artifacts)) {
+    artifact.pm = std::make_unique<PassManager>(
+        ctx, ModuleOp::getOperationName(), OpPassManager::Nesting::Implicit);
+    std::string pipeline =
+        "aie-localize-locks,aie-standard-lowering{tilecol=" +
+        std::to_string(core.col) + " tilerow=" + std::to_string(core.row) +
+        "},aiex-standard-lowering," + passPipeline.str();
+    if (failed(parsePassPipeline(pipeline, *artifact.pm)))
+      return module.emitError("failed to parse core pipeline: ") << pipeline;
+    artifact.pm->getDependentDialects(registry);
+  }
+  ctx->appendDialectRegistry(registry);
+  ctx->loadAllAvailableDialects();
+
+  LogicalResult result =
+      failableParallelForEachN(ctx, 0, cores.size(), [&](size_t i) {
+        TileID core = cores[i];
+        CoreArtifacts &artifact = artifacts[i];
+
+        // The linker script only reads the placed design.
+        llvm::raw_string_ostream script(artifact.linkerScript);
+        if (failed(bcf ? AIETranslateToBCF(module, script, core.col, core.row)
+                       : AIETranslateToLdScript(module, script, core.col,
+                                                core.row)))
+          return failure();
+
+        OwningOpRef<ModuleOp> coreModule = module.clone();
+        if (failed(artifact.pm->run(*coreModule)))
+          return failure();
+        llvm::LLVMContext llvmContext;
+        auto llvmModule = translateModuleToLLVMIR(*coreModule, llvmContext);
+        if (!llvmModule)
+          return coreModule->emitError("failed to translate core (")
+                 << core.col << ", " << core.row << ") to LLVM IR";
+        llvm::raw_string_ostream(artifact.llvmIR) << *llvmModule;
+        return success();
+      });
+  if (failed(result))
+    return failure();
+
+  for (auto [core, artifact] : llvm::zip(cores, artifacts))
+    emit(core, artifact.llvmIR, artifact.linkerScript);
+  return success();
+}
@@ -8,43 +8,58 @@
 //
 //===----------------------------------------------------------------------===//
 
-#include "AIETargets.h"
+#include "aie/Targets/AIETargets.h"
 
 #include "aie/Dialect/AIEX/IR/AIEXDialect.h"
 
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Tools/mlir-translate/MlirTranslateMain.h"
 
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/TypeSwitch.h"
-#include "llvm/Support/Format.h"
+#include "llvm/Support/Endian.h"
 
 using namespace mlir;
 using namespace xilinx;
 using namespace xilinx::AIE;
 using namespace xilinx::AIEX;
 
-static void emitProlog(llvm::raw_ostream &os) {
-  os << "00000011\n";
-  os << "01000405\n";
-  os << "01000100\n";
-  os << "0B590100\n";
-  os << "000055FF\n";
-  os << "00000001\n";
-  os << "00000010\n";
-  os << "314E5A5F\n";
-  os << "635F5F31\n";
-  os << "676E696C\n";
-  os << "39354E5F\n";
-  os << "6E693131\n";
-  os << "5F727473\n";
-  os << "64726F77\n";
-  os << "00004573\n";
-  os << "07BD9630\n";
-  os << "000055FF\n";
-}
+// Instruction stream header expected by the IPU firmware.
+static constexpr uint32_t prolog[] = {
+    0x00000011, 0x01000405, 0x01000100, 0x0B590100, 0x000055FF, 0x00000001,
+    0x00000010, 0x314E5A5F, 0x635F5F31, 0x676E696C, 0x39354E5F, 0x6E693131,
+    0x5F727473, 0x64726F77, 0x00004573, 0x07BD9630, 0x000055FF};
+
+// The binary file format starts with a header of binaryHeaderWords words:
+// magic, version, header size in words, number of instruction words that
+// follow, and the number of operations emitted for each opcode below
+// numOpcodes. All words are little endian. runtime_lib/test_lib/
+// ipu_instructions.h maps these files directly.
+static constexpr uint32_t binaryMagic = 0x55504941; // "AIPU"
+static constexpr uint32_t binaryVersion = 1;
+static constexpr unsigned numOpcodes = 8;
+static constexpr unsigned binaryHeaderWords = 4 + numOpcodes;
+
+namespace {
+// Accumulates the instruction words of a sequence together with the number
+// of operations of each opcode, so that the whole stream can be written out
+// in one go.
+struct InstructionStream {
+  std::vector<uint32_t> words;
+  uint32_t opcodeCounts[numOpcodes] = {};
+
+  void append(ArrayRef<uint32_t> opWords) {
+    uint32_t opcode = opWords.front() >> 24;
+    if (opcode < numOpcodes)
+      opcodeCounts[opcode]++;
+    words.insert(words.end(), opWords.begin(), opWords.end());
+  }
+};
+} // namespace
 
-static void emitSync(raw_ostream &output, IpuSyncOp op) {
-  std::vector<uint32_t> words(2, 0);
+static void emitSync(InstructionStream &stream, IpuSyncOp op) {
+  uint32_t words[2] = {};
 
   uint32_t op_code = 3;
   words[0] |= (op_code & 0xff) << 24;
@@ -56,12 +71,11 @@ static void emitSync(raw_ostream &output, IpuSyncOp op) {
   words[1] |= (op.getColumnNum() & 0xff) << 16;
   words[1] |= (op.getRowNum() & 0xff) << 8;
 
-  for (auto w : words)
-    output << llvm::format("%08X\n", w);
+  stream.append(words);
 }
 
-static void emitWrite32(raw_ostream &output, IpuWrite32Op op) {
-  std::vector<uint32_t> words(3, 0);
+static void emitWrite32(InstructionStream &stream, IpuWrite32Op op) {
+  uint32_t words[3] = {};
 
   uint32_t op_code = 2;
   words[0] |= (op_code & 0xff) << 24;
@@ -70,13 +84,12 @@ static void emitWrite32(raw_ostream &output, IpuWrite32Op op) {
   words[1] = op.getAddress();
   words[2] = op.getValue();
 
-  for (auto w : words)
-    output << llvm::format("%08X\n", w);
+  stream.append(words);
 }
 
-static void emitWriteBdShimTile(raw_ostream &output,
+static void emitWriteBdShimTile(InstructionStream &stream,
                                 IpuWriteBdExShimTileOp op) {
-  std::vector<uint32_t> words(10, 0);
+  uint32_t words[10] = {};
 
   uint32_t op_code = 6;
   words[0] |= (op_code & 0xff) << 24;
@@ -122,13 +135,14 @@ static void emitWriteBdShimTile(raw_ostream &output,
   words[9] |= (op.getLockAcqVal() & 0xef) << 5;
   words[9] |= op.getLockAcqId() & 0xf;
 
-  for (auto w : words)
-    output << llvm::format("%08X\n", w);
+  stream.append(words);
 }
 
 LogicalResult xilinx::AIE::AIETranslateToIPU(ModuleOp module,
-                                             raw_ostream &output) {
-  emitProlog(output);
+                                             raw_ostream &output,
+                                             bool binary) {
+  InstructionStream stream;
+  stream.words.assign(std::begin(prolog), std::end(prolog));
 
   DeviceOp deviceOp = *module.getOps<DeviceOp>().begin();
   auto funcOps = deviceOp.getOps<func::FuncOp>();
@@ -138,11 +152,37 @@ LogicalResult xilinx::AIE::AIETranslateToIPU(ModuleOp module,
     Block &entry = f.getRegion().front();
     for (auto &o : entry) {
       llvm::TypeSwitch<Operation *>(&o)
-          .Case<IpuSyncOp>([&](auto op) { emitSync(output, op); })
-          .Case<IpuWrite32Op>([&](auto op) { emitWrite32(output, op); })
+          .Case<IpuSyncOp>([&](auto op) { emitSync(stream, op); })
+          .Case<IpuWrite32Op>([&](auto op) { emitWrite32(stream, op); })
           .Case<IpuWriteBdExShimTileOp>(
-              [&](auto op) { emitWriteBdShimTile(output, op); });
+              [&](auto op) { emitWriteBdShimTile(stream, op); });
     }
   }
+
+  // Lay the whole file out in memory and hand it to the stream at once.
+  if (!binary) {
+    std::string text;
+    text.reserve(stream.words.size() * 9);
+    for (auto w : stream.words) {
+      for (int shift = 28; shift >= 0; shift -= 4)
+        text.push_back(llvm::hexdigit((w >> shift) & 0xf));
+      text.push_back('\n');
+    }
+    output << text;
+    return success();
+  }
+
+  SmallVector<uint32_t> header = {binaryMagic, binaryVersion,
+                                  binaryHeaderWords,
+                                  static_cast<uint32_t>(stream.words.size())};
+  header.append(std::begin(stream.opcodeCounts),
+                std::end(stream.opcodeCounts));
+  std::vector<char> bytes((header.size() + stream.words.size()) * 4);
+  char *p = bytes.data();
+  for (auto w : llvm::concat<uint32_t>(header, stream.words)) {
+    llvm::support::endian::write32le(p, w);
+    p += 4;
+  }
+  output.write(bytes.data(), bytes.size());
   return success();
 }
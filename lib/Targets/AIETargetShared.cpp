@@ -8,7 +8,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "AIETargetShared.h"
-#include "AIETargets.h"
+#include "aie/Targets/AIETargets.h"
 
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
 
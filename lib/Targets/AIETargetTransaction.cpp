@@ -0,0 +1,603 @@
+//===- AIETargetTransaction.cpp ---------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+//
+// Lower an AIE-ML device directly to a stream of register writes, bypassing
+// the libxaie C++ source produced by aie-generate-cdo. The stream starts with
+// a four word header (magic, version, record count, payload word count)
+// followed by records:
+//
+//   WRITE:     [0x00 << 24 | n] address value_0 ... value_{n-1}
+//   MASKWRITE: [0x01 << 24 | 1] address value mask
+//
+// A WRITE record covers n consecutive 32-bit registers, so contiguous
+// register blocks such as buffer descriptors become a single record. All
+// words are little endian. Addresses are relative to the start of the
+// partition: (col << 25) | (row << 20) | offset.
+//
+//===----------------------------------------------------------------------===//
+
+#include "aie/Targets/AIETargets.h"
+
+#include "aie/Dialect/AIE/IR/AIEDeviceIndex.h"
+#include "aie/Dialect/AIE/IR/AIEDialect.h"
+
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/Format.h"
+
+using namespace mlir;
+using namespace xilinx;
+using namespace xilinx::AIE;
+
+namespace {
+
+constexpr uint32_t transactionMagic = 0x54454941; // "AIET"
+constexpr uint32_t transactionVersion = 1;
+
+enum TransactionOpcode : uint32_t { Write = 0, MaskWrite = 1 };
+
+constexpr unsigned colShift = 25;
+constexpr unsigned rowShift = 20;
+
+// AIE-ML register offsets within a tile.
+constexpr uint32_t coreControl = 0x32000;
+constexpr uint32_t coreTileLockValue = 0x1F000;
+constexpr uint32_t coreTileBd = 0x1D000;
+constexpr uint32_t coreTileS2MMStartQueue = 0x1DE04;
+constexpr uint32_t coreTileMM2SStartQueue = 0x1DE14;
+constexpr uint32_t memTileLockValue = 0xC0000;
+constexpr uint32_t memTileBd = 0xA0000;
+constexpr uint32_t memTileS2MMStartQueue = 0xA0604;
+constexpr uint32_t memTileMM2SStartQueue = 0xA0634;
+constexpr uint32_t memTileStreamSwitch = 0xB0000;
+constexpr uint32_t shimDMAS2MMControl = 0x1D200;
+constexpr uint32_t shimMuxConfig = 0x1F000;
+constexpr uint32_t shimDemuxConfig = 0x1F004;
+constexpr uint32_t streamSwitch = 0x3F000;
+constexpr uint32_t lockStride = 0x10;
+constexpr uint32_t bdStride = 0x20;
+constexpr uint32_t dmaChannelStride = 0x8;
+
+// The stream switch master, slave and slave slot registers are laid out at
+// these offsets from the stream switch base.
+constexpr uint32_t streamSwitchSlave = 0x100;
+constexpr uint32_t streamSwitchSlot = 0x200;
+
+constexpr uint32_t coreControlEnable = 0x1;
+constexpr uint32_t coreControlReset = 0x2;
+constexpr uint32_t portEnable = 1u << 31;
+constexpr uint32_t portPacketEnable = 1u << 30;
+constexpr uint32_t shimMuxDMA = 0x1;
+
+// The index of each bundle's first port in the stream switch register
+// file. Tile control ports have no WireBundle and are handled separately.
+struct PortRange {
+  WireBundle bundle;
+  unsigned first;
+  unsigned count;
+};
+
+constexpr PortRange coreTileMasters[] = {
+    {WireBundle::Core, 0, 1},  {WireBundle::DMA, 1, 2},
+    {WireBundle::FIFO, 4, 1},  {WireBundle::South, 5, 4},
+    {WireBundle::West, 9, 4},  {WireBundle::North, 13, 6},
+    {WireBundle::East, 19, 4}};
+constexpr PortRange coreTileSlaves[] = {
+    {WireBundle::Core, 0, 1},   {WireBundle::DMA, 1, 2},
+    {WireBundle::FIFO, 4, 1},   {WireBundle::South, 5, 6},
+    {WireBundle::West, 11, 4},  {WireBundle::North, 15, 4},
+    {WireBundle::East, 19, 4},  {WireBundle::Trace, 23, 2}};
+constexpr PortRange memTileMasters[] = {{WireBundle::DMA, 0, 6},
+                                        {WireBundle::South, 7, 4},
+                                        {WireBundle::North, 11, 6}};
+constexpr PortRange memTileSlaves[] = {{WireBundle::DMA, 0, 6},
+                                       {WireBundle::South, 7, 6},
+                                       {WireBundle::North, 13, 4},
+                                       {WireBundle::Trace, 17, 1}};
+constexpr PortRange shimTileMasters[] = {
+    {WireBundle::FIFO, 1, 1},  {WireBundle::South, 2, 6},
+    {WireBundle::West, 8, 4},  {WireBundle::North, 12, 6},
+    {WireBundle::East, 18, 4}};
+constexpr PortRange shimTileSlaves[] = {
+    {WireBundle::FIFO, 1, 1},  {WireBundle::South, 2, 8},
+    {WireBundle::West, 10, 4}, {WireBundle::North, 14, 4},
+    {WireBundle::East, 18, 4}, {WireBundle::Trace, 22, 1}};
+constexpr unsigned shimTileControlPort = 0;
+
+// A run of register writes starting at address. Records with a full mask
+// may grow to cover consecutive registers.
+struct TransactionRecord {
+  uint32_t address;
+  uint32_t mask;
+  SmallVector<uint32_t, 8> values;
+};
+
+class TransactionBuilder {
+public:
+  explicit TransactionBuilder(const AIETargetModel &targetModel)
+      : targetModel(targetModel) {}
+
+  void write32(int col, int row, uint32_t offset, uint32_t value) {
+    uint32_t address = tileAddress(col, row) | offset;
+    if (!records.empty()) {
+      TransactionRecord &last = records.back();
+      if (last.mask == ~0u &&
+          last.address + 4 * last.values.size() == address) {
+        last.values.push_back(value);
+        return;
+      }
+    }
+    records.push_back({address, ~0u, {value}});
+  }
+
+  void maskWrite32(int col, int row, uint32_t offset, uint32_t value,
+                   uint32_t mask) {
+    records.push_back({tileAddress(col, row) | offset, mask, {value}});
+  }
+
+  std::optional<unsigned> getPortIndex(int col, int row, WireBundle bundle,
+                                       int channel, bool isMaster) const {
+    ArrayRef<PortRange> ports;
+    if (targetModel.isMemTile(col, row))
+      ports = isMaster ? ArrayRef(memTileMasters) : ArrayRef(memTileSlaves);
+    else if (targetModel.isShimNOCorPLTile(col, row))
+      ports = isMaster ? ArrayRef(shimTileMasters) : ArrayRef(shimTileSlaves);
+    else
+      ports = isMaster ? ArrayRef(coreTileMasters) : ArrayRef(coreTileSlaves);
+    for (const PortRange &range : ports)
+      if (range.bundle == bundle && channel >= 0 &&
+          static_cast<unsigned>(channel) < range.count)
+        return range.first + channel;
+    return std::nullopt;
+  }
+
+  uint32_t getStreamSwitchBase(int col, int row) const {
+    return targetModel.isMemTile(col, row) ? memTileStreamSwitch
+                                           : streamSwitch;
+  }
+
+  size_t getPayloadWords() const {
+    size_t words = 0;
+    for (const TransactionRecord &record : records)
+      words += 2 + record.values.size() + (record.mask == ~0u ? 0 : 1);
+    return words;
+  }
+
+  void emitBinary(raw_ostream &output) const {
+    writeWord(output, transactionMagic);
+    writeWord(output, transactionVersion);
+    writeWord(output, records.size());
+    writeWord(output, getPayloadWords());
+    for (const TransactionRecord &record : records) {
+      if (record.mask == ~0u) {
+        writeWord(output, (Write << 24) | record.values.size());
+        writeWord(output, record.address);
+        for (uint32_t value : record.values)
+          writeWord(output, value);
+      } else {
+        writeWord(output, (MaskWrite << 24) | 1);
+        writeWord(output, record.address);
+        writeWord(output, record.values.front());
+        writeWord(output, record.mask);
+      }
+    }
+  }
+
+  void emitText(raw_ostream &output) const {
+    output << "// " << records.size() << " records, " << getPayloadWords()
+           << " words\n";
+    for (const TransactionRecord &record : records) {
+      if (record.mask == ~0u) {
+        output << "WRITE " << llvm::format("0x%08X", record.address);
+        for (uint32_t value : record.values)
+          output << " " << llvm::format("0x%08X", value);
+      } else {
+        output << "MASKWRITE " << llvm::format("0x%08X", record.address) << " "
+               << llvm::format("0x%08X", record.values.front()) << " "
+               << llvm::format("0x%08X", record.mask);
+      }
+      output << "\n";
+    }
+  }
+
+private:
+  static uint32_t tileAddress(int col, int row) {
+    return (static_cast<uint32_t>(col) << colShift) |
+           (static_cast<uint32_t>(row) << rowShift);
+  }
+
+  static void writeWord(raw_ostream &output, uint32_t word) {
+    char bytes[4];
+    llvm::support::endian::write32le(bytes, word);
+    output.write(bytes, sizeof(bytes));
+  }
+
+  const AIETargetModel &targetModel;
+  std::vector<TransactionRecord> records;
+};
+
+// The fields of one buffer descriptor, gathered from a DMA block.
+struct BdFields {
+  uint32_t address = 0;
+  uint32_t lengthInWords = 0;
+  ArrayRef<DimTupleAttr> dims;
+  std::optional<DimTupleAttr> iteration;
+  bool enablePacket = false;
+  int packetType = 0;
+  int packetID = 0;
+  bool acquireEnable = false;
+  int acquireLockID = 0;
+  int acquireValue = 0;
+  int releaseLockID = 0;
+  int releaseValue = 0;
+  bool useNextBd = false;
+  int nextBd = 0;
+};
+
+// Step sizes are encoded minus one; a missing dimension has a step of one.
+uint32_t encodeStep(ArrayRef<DimTupleAttr> dims, unsigned dim, uint32_t mask) {
+  if (dim >= dims.size())
+    return 0;
+  return (dims[dims.size() - dim - 1].getStepsize() - 1) & mask;
+}
+
+uint32_t encodeWrap(ArrayRef<DimTupleAttr> dims, unsigned dim, uint32_t mask) {
+  if (dim >= dims.size())
+    return 0;
+  return dims[dims.size() - dim - 1].getWrap() & mask;
+}
+
+// The iteration stepsize and wrap are both encoded minus one.
+uint32_t encodeIteration(std::optional<DimTupleAttr> iteration,
+                         unsigned wrapShift, uint32_t stepMask) {
+  if (!iteration)
+    return 0;
+  return ((iteration->getWrap() - 1) & 0x3f) << wrapShift |
+         ((iteration->getStepsize() - 1) & stepMask);
+}
+
+SmallVector<uint32_t, 8> encodeCoreTileBd(const BdFields &bd) {
+  SmallVector<uint32_t, 8> words(6, 0);
+  words[0] = ((bd.address / 4) & 0x3fff) << 14 | (bd.lengthInWords & 0x3fff);
+  words[1] = bd.enablePacket << 30 | (bd.packetID & 0x1f) << 19 |
+             (bd.packetType & 0x7) << 16;
+  words[2] = encodeStep(bd.dims, 1, 0x1fff) << 13 |
+             encodeStep(bd.dims, 0, 0x1fff);
+  words[3] = encodeWrap(bd.dims, 1, 0xff) << 21 |
+             encodeWrap(bd.dims, 0, 0xff) << 13 |
+             encodeStep(bd.dims, 2, 0x1fff);
+  words[4] = encodeIteration(bd.iteration, 13, 0x1fff);
+  words[5] = (bd.nextBd & 0xf) << 27 | bd.useNextBd << 26 | 1 << 25 |
+             (bd.releaseValue & 0x7f) << 18 | (bd.releaseLockID & 0xf) << 13 |
+             bd.acquireEnable << 12 | (bd.acquireValue & 0x7f) << 5 |
+             (bd.acquireLockID & 0xf);
+  return words;
+}
+
+SmallVector<uint32_t, 8> encodeMemTileBd(const BdFields &bd) {
+  SmallVector<uint32_t, 8> words(8, 0);
+  words[0] = static_cast<uint32_t>(bd.enablePacket) << 31 |
+             (bd.packetType & 0x7) << 28 | (bd.packetID & 0x1f) << 23 |
+             (bd.lengthInWords & 0x1ffff);
+  words[1] = (bd.nextBd & 0x3f) << 20 | bd.useNextBd << 19 |
+             ((bd.address / 4) & 0x7ffff);
+  words[2] = encodeWrap(bd.dims, 0, 0x3ff) << 17 |
+             encodeStep(bd.dims, 0, 0x1ffff);
+  words[3] = encodeWrap(bd.dims, 1, 0x3ff) << 17 |
+             encodeStep(bd.dims, 1, 0x1ffff);
+  words[4] = encodeWrap(bd.dims, 2, 0x3ff) << 17 |
+             encodeStep(bd.dims, 2, 0x1ffff);
+  words[5] = encodeStep(bd.dims, 3, 0x1ffff);
+  words[6] = encodeIteration(bd.iteration, 17, 0x1ffff);
+  words[7] = 1u << 31 | (bd.releaseValue & 0x7f) << 24 |
+             (bd.releaseLockID & 0xff) << 16 | bd.acquireEnable << 15 |
+             (bd.acquireValue & 0x7f) << 8 | (bd.acquireLockID & 0xff);
+  return words;
+}
+
+// Write the buffer descriptors and start queues of a tile or memtile DMA.
+// BD numbering follows aie-generate-cdo.
+template <typename DMAOpTy>
+LogicalResult configureDMA(TransactionBuilder &builder, DMAOpTy memOp,
+                           bool isMemTile) {
+  int col = memOp.colIndex();
+  int row = memOp.rowIndex();
+
+  DenseMap<Block *, int> blockMap;
+  DenseMap<Block *, int> channelMap;
+  for (auto &block : memOp.getBody()) {
+    for (auto op : block.template getOps<DMAStartOp>()) {
+      int chNum = op.getChannelIndex();
+      channelMap[&block] = chNum;
+      auto dest = op.getDest();
+      while (dest) {
+        channelMap[dest] = chNum;
+        dest = dest->getSuccessors()[0];
+        if (channelMap.count(dest))
+          dest = nullptr;
+      }
+    }
+  }
+
+  int evenBdNum = 0;
+  int oddBdNum = 24;
+  for (auto &block : memOp.getBody()) {
+    if (block.template getOps<DMABDOp>().empty())
+      continue;
+    if (isMemTile && channelMap[&block] & 1)
+      blockMap[&block] = oddBdNum++;
+    else
+      blockMap[&block] = evenBdNum++;
+  }
+
+  for (auto &block : memOp.getBody()) {
+    if (!blockMap.count(&block))
+      continue;
+
+    BdFields bd;
+    for (auto op : block.template getOps<DMABDOp>()) {
+      if (!op.isA())
+        return op.emitOpError("only the A buffer of a BD is supported");
+      auto bufferType = op.getBuffer().getType().template cast<MemRefType>();
+      int bytes = bufferType.getElementTypeBitWidth() / 8;
+      auto buffer = cast<AIE::BufferOp>(op.getBuffer().getDefiningOp());
+      bd.address = buffer.address() + op.getOffsetValue();
+      bd.lengthInWords = op.getLenValue() * bytes / 4;
+      if (op.getDimensions())
+        bd.dims = *op.getDimensions();
+      bd.iteration = op.getIteration();
+    }
+
+    for (auto op : block.template getOps<UseLockOp>()) {
+      LockOp lock = dyn_cast<LockOp>(op.getLock().getDefiningOp());
+      if (op.acquire() || op.acquireGE()) {
+        bd.acquireEnable = true;
+        bd.acquireLockID = lock.getLockIDValue();
+        bd.acquireValue = op.getLockValue();
+        if (op.acquireGE())
+          bd.acquireValue = -bd.acquireValue;
+      } else if (op.release()) {
+        bd.releaseLockID = lock.getLockIDValue();
+        bd.releaseValue = op.getLockValue();
+      } else {
+        return op.emitOpError("unsupported lock action");
+      }
+    }
+
+    for (auto op : block.template getOps<DMABDPACKETOp>()) {
+      bd.enablePacket = true;
+      bd.packetType = op.getPacketType();
+      bd.packetID = op.getPacketID();
+    }
+
+    if (block.getNumSuccessors() > 0) {
+      Block *nextBlock = block.getSuccessors()[0];
+      if (blockMap.count(nextBlock)) {
+        bd.useNextBd = true;
+        bd.nextBd = blockMap[nextBlock];
+      }
+    }
+
+    if (isMemTile) {
+      bd.acquireLockID += 64;
+      bd.releaseLockID += 64;
+      bd.address += 0x80000;
+    }
+    SmallVector<uint32_t, 8> words =
+        isMemTile ? encodeMemTileBd(bd) : encodeCoreTileBd(bd);
+    uint32_t bdBase =
+        (isMemTile ? memTileBd : coreTileBd) + blockMap[&block] * bdStride;
+    for (unsigned i = 0; i < words.size(); i++)
+      builder.write32(col, row, bdBase + 4 * i, words[i]);
+  }
+
+  // AIE-ML channels start processing as soon as a BD is pushed onto their
+  // start queue, so there is no separate channel enable. A channel with no
+  // BDs is left idle.
+  for (auto &block : memOp.getBody()) {
+    for (auto op : block.template getOps<DMAStartOp>()) {
+      auto startBd = blockMap.find(op.getDest());
+      if (startBd == blockMap.end())
+        continue;
+      bool isMM2S = op.getChannelDir() == DMAChannelDir::MM2S;
+      uint32_t queue = isMemTile
+                           ? (isMM2S ? memTileMM2SStartQueue
+                                     : memTileS2MMStartQueue)
+                           : (isMM2S ? coreTileMM2SStartQueue
+                                     : coreTileS2MMStartQueue);
+      builder.write32(col, row,
+                      queue + op.getChannelIndex() * dmaChannelStride,
+                      startBd->second);
+    }
+  }
+  return success();
+}
+
+LogicalResult connectCircuit(TransactionBuilder &builder, int col, int row,
+                             ConnectOp connectOp) {
+  auto slave =
+      builder.getPortIndex(col, row, connectOp.getSourceBundle(),
+                           connectOp.sourceIndex(), /*isMaster=*/false);
+  auto master =
+      builder.getPortIndex(col, row, connectOp.getDestBundle(),
+                           connectOp.destIndex(), /*isMaster=*/true);
+  if (!slave || !master)
+    return connectOp.emitOpError("unsupported stream switch port");
+  uint32_t base = builder.getStreamSwitchBase(col, row);
+  builder.write32(col, row, base + 4 * *master, portEnable | *slave);
+  builder.write32(col, row, base + streamSwitchSlave + 4 * *slave, portEnable);
+  return success();
+}
+
+LogicalResult configureSwitchbox(TransactionBuilder &builder,
+                                 SwitchboxOp switchboxOp) {
+  if (!isa<TileOp>(switchboxOp.getTile().getDefiningOp()))
+    return switchboxOp.emitOpError(
+        "parameterized switchboxes are not supported");
+  int col = switchboxOp.colIndex();
+  int row = switchboxOp.rowIndex();
+  uint32_t base = builder.getStreamSwitchBase(col, row);
+  Block &b = switchboxOp.getConnections().front();
+
+  if (row == 0) {
+    // Route tile control traffic from the shim south port 0, matching
+    // aie-generate-cdo, and assign controller 0 to both S2MM channels.
+    auto south = builder.getPortIndex(col, row, WireBundle::South, 0,
+                                      /*isMaster=*/true);
+    builder.write32(col, row, base + 4 * *south,
+                    portEnable | shimTileControlPort);
+    builder.write32(col, row,
+                    base + streamSwitchSlave + 4 * shimTileControlPort,
+                    portEnable);
+    builder.write32(col, row, shimDMAS2MMControl, 0);
+    builder.write32(col, row, shimDMAS2MMControl + dmaChannelStride, 0);
+  }
+
+  for (auto connectOp : b.getOps<ConnectOp>())
+    if (failed(connectCircuit(builder, col, row, connectOp)))
+      return failure();
+
+  for (auto connectOp : b.getOps<MasterSetOp>()) {
+    int mask = 0;
+    int arbiter = -1;
+    for (auto val : connectOp.getAmsels()) {
+      AMSelOp amsel = dyn_cast<AMSelOp>(val.getDefiningOp());
+      arbiter = amsel.arbiterIndex();
+      int msel = amsel.getMselValue();
+      mask |= (1 << msel);
+    }
+    bool isdma = (connectOp.getDestBundle() == WireBundle::DMA);
+    // A connection going south from row zero is assumed to reach the shim
+    // DMA through the shim mux.
+    if (!isdma && row == 0)
+      isdma = (connectOp.getDestBundle() == WireBundle::South);
+    isdma &= !(connectOp->hasAttr("keep_pkt_header"));
+    auto master =
+        builder.getPortIndex(col, row, connectOp.getDestBundle(),
+                             connectOp.destIndex(), /*isMaster=*/true);
+    if (!master)
+      return connectOp.emitOpError("unsupported stream switch port");
+    builder.write32(col, row, base + 4 * *master,
+                    portEnable | portPacketEnable | isdma << 7 |
+                        (mask & 0xf) << 3 | (arbiter & 0x7));
+  }
+
+  for (auto connectOp : b.getOps<PacketRulesOp>()) {
+    auto slave =
+        builder.getPortIndex(col, row, connectOp.getSourceBundle(),
+                             connectOp.sourceIndex(), /*isMaster=*/false);
+    if (!slave)
+      return connectOp.emitOpError("unsupported stream switch port");
+    builder.write32(col, row, base + streamSwitchSlave + 4 * *slave,
+                    portEnable | portPacketEnable);
+    int slot = 0;
+    Block &block = connectOp.getRules().front();
+    for (auto slotOp : block.getOps<PacketRuleOp>()) {
+      AMSelOp amselOp = dyn_cast<AMSelOp>(slotOp.getAmsel().getDefiningOp());
+      builder.write32(col, row,
+                      base + streamSwitchSlot + 0x10 * *slave + 4 * slot,
+                      (slotOp.valueInt() & 0x1f) << 24 |
+                          (slotOp.maskInt() & 0x1f) << 16 | 1 << 8 |
+                          (amselOp.getMselValue() & 0x3) << 4 |
+                          (amselOp.arbiterIndex() & 0x7));
+      slot++;
+    }
+  }
+  return success();
+}
+
+void configureShimMux(TransactionBuilder &builder, ShimMuxOp op) {
+  int col = op.colIndex();
+  int row = op.rowIndex();
+  Block &b = op.getConnections().front();
+  for (auto connectOp : b.getOps<ConnectOp>()) {
+    if (connectOp.getSourceBundle() == WireBundle::North) {
+      // Demux fields for south ports 2 to 5 start at bit 4.
+      unsigned shift = 4 + 2 * (connectOp.sourceIndex() - 2);
+      builder.maskWrite32(col, row, shimDemuxConfig, shimMuxDMA << shift,
+                          0x3 << shift);
+    } else if (connectOp.getDestBundle() == WireBundle::North) {
+      // Mux fields for south ports 2, 3, 6 and 7 start at bit 8.
+      int port = connectOp.destIndex();
+      unsigned shift = 8 + 2 * (port < 6 ? port - 2 : port - 4);
+      builder.maskWrite32(col, row, shimMuxConfig, shimMuxDMA << shift,
+                          0x3 << shift);
+    }
+  }
+}
+
+} // namespace
+
+LogicalResult xilinx::AIE::AIETranslateToTransaction(ModuleOp module,
+                                                     raw_ostream &output,
+                                                     bool textual) {
+  if (module.getOps<DeviceOp>().empty())
+    return module.emitOpError("expected AIE.device operation at toplevel");
+  DeviceOp targetOp = *module.getOps<DeviceOp>().begin();
+  const auto &targetModel = targetOp.getTargetModel();
+  DeviceIndex index(targetOp);
+  if (targetModel.getTargetArch() != AIEArch::AIE2)
+    return targetOp.emitOpError(
+        "transaction output is only supported for AIE-ML devices");
+
+  TransactionBuilder builder(targetModel);
+
+  for (auto tileOp : targetOp.getOps<TileOp>()) {
+    int col = tileOp.colIndex();
+    int row = tileOp.rowIndex();
+    if (tileOp.isShimTile() || !index.getCore(tileOp))
+      continue;
+    builder.write32(col, row, coreControl, coreControlReset);
+    builder.write32(col, row, coreControl, 0);
+    for (unsigned l = 0; l < targetModel.getNumLocks(col, row); l++)
+      builder.write32(col, row, coreTileLockValue + l * lockStride, 0);
+  }
+
+  for (auto lockOp : targetOp.getOps<LockOp>()) {
+    auto tileOp = lockOp.getTileOp();
+    int col = tileOp.colIndex();
+    int row = tileOp.rowIndex();
+    auto id = lockOp.getLockID();
+    if (!id)
+      continue;
+    // Locks of tiles with a core were all cleared above. Any other lock may
+    // still hold a value from an earlier configuration.
+    int init = lockOp.getInit().value_or(0);
+    if (init == 0 && !tileOp.isShimTile() && index.getCore(tileOp))
+      continue;
+    uint32_t base = targetModel.isMemTile(col, row) ? memTileLockValue
+                                                    : coreTileLockValue;
+    builder.write32(col, row, base + *id * lockStride, init);
+  }
+
+  for (auto memOp : targetOp.getOps<MemOp>())
+    if (failed(configureDMA(builder, memOp, /*isMemTile=*/false)))
+      return failure();
+  for (auto memOp : targetOp.getOps<MemTileDMAOp>())
+    if (failed(configureDMA(builder, memOp, /*isMemTile=*/true)))
+      return failure();
+
+  for (auto switchboxOp : targetOp.getOps<SwitchboxOp>())
+    if (failed(configureSwitchbox(builder, switchboxOp)))
+      return failure();
+  for (auto op : targetOp.getOps<ShimMuxOp>())
+    configureShimMux(builder, op);
+
+  // Cores are enabled last, once everything they talk to is configured.
+  for (auto tileOp : targetOp.getOps<TileOp>())
+    if (!tileOp.isShimTile() && index.getCore(tileOp))
+      builder.write32(tileOp.colIndex(), tileOp.rowIndex(), coreControl,
+                      coreControlEnable);
+
+  if (textual)
+    builder.emitText(output);
+  else
+    builder.emitBinary(output);
+  return success();
+}
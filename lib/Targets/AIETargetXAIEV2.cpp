@@ -9,7 +9,7 @@
 //
 //===----------------------------------------------------------------------===//
 #include "AIETargetShared.h"
-#include "AIETargets.h"
+#include "aie/Targets/AIETargets.h"
 
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
 #include "aie/Dialect/AIEX/IR/AIEXDialect.h"
@@ -102,6 +102,7 @@ mlir::LogicalResult generateDMAConfig(OpType memOp, raw_ostream &output,
     StringRef AbMode = disable;
     int ndims = 0;
     ArrayRef<DimTupleAttr> dims;
+    std::optional<DimTupleAttr> iteration;
     //      StringRef FifoMode = disable; // FIXME: when to enable FIFO mode?
     for (auto op : block.template getOps<DMABDOp>()) {
       foundBd = true;
@@ -140,6 +141,7 @@ mlir::LogicalResult generateDMAConfig(OpType memOp, raw_ostream &output,
         dims = *op.getDimensions();
         ndims = dims.size();
       }
+      iteration = op.getIteration();
     }
 
     if (0 != ndims && AIEArch::AIE2 != targetModel.getTargetArch()) {
@@ -244,6 +246,13 @@ mlir::LogicalResult generateDMAConfig(OpType memOp, raw_ostream &output,
         generateXAieDmaSetMultiDimAddr(output, ndims, dims, col, row, bdNum,
                                        BaseAddrA, offsetA, lenA, bytesA, "1");
       }
+      if (iteration) {
+        output << "__mlir_aie_try(XAie_DmaSetBdIteration("
+               << tileDMAInstRefStr(col, row, bdNum) << ", "
+               << " /* stepsize */ " << iteration->getStepsize() << ", "
+               << " /* wrap */ " << iteration->getWrap() << ", "
+               << " /* current */ 0));\n";
+      }
 
       if (block.getNumSuccessors() > 0) {
         Block *nextBlock = block.getSuccessors()[0]; // should have only one
@@ -8,9 +8,10 @@
 //
 //===----------------------------------------------------------------------===//
 
-#include "AIETargets.h"
+#include "aie/Targets/AIETargets.h"
 
 #include "aie/Dialect/ADF/ADFDialect.h"
+#include "aie/Dialect/AIE/IR/AIEDeviceIndex.h"
 #include "aie/Dialect/AIE/IR/AIEDialect.h"
 #include "aie/Dialect/AIEX/IR/AIEXDialect.h"
 
@@ -118,6 +119,206 @@ void writeLDScriptMap(raw_ostream &output, BufferOp buf, int offset) {
   output << ". += 0x" << llvm::utohexstr(numBytes) << ";\n";
 }
 
+LogicalResult AIETranslateToLdScript(ModuleOp module, raw_ostream &output,
+                                     int tileCol, int tileRow) {
+  if (module.getOps<DeviceOp>().empty()) {
+    module.emitOpError("expected AIE.device operation at toplevel");
+  }
+  DeviceOp targetOp = *(module.getOps<DeviceOp>().begin());
+
+  DeviceIndex index(targetOp);
+
+  for (auto tile : targetOp.getOps<TileOp>())
+    if (tile.colIndex() == tileCol && tile.rowIndex() == tileRow) {
+      TileID srcCoord = {tile.colIndex(), tile.rowIndex()};
+      const auto &targetModel = getTargetModel(tile);
+
+      // Figure out how much memory we have left for random allocations
+      auto core = index.getCore(tile);
+      int max = core.getStackSize();
+      for (auto buf : index.getBuffers(tile)) {
+        int bufferBaseAddr = getBufferBaseAddress(buf);
+        int numBytes = buf.getAllocationSize();
+        max = std::max(max, bufferBaseAddr + numBytes);
+      }
+      int origin = targetModel.getMemInternalBaseAddress(srcCoord) + max;
+      int length = targetModel.getLocalMemorySize() - max;
+      output << R"THESCRIPT(
+MEMORY
+{
+   program (RX) : ORIGIN = 0, LENGTH = 0x0020000
+)THESCRIPT";
+      output << "   data (!RX) : ORIGIN = 0x" << llvm::utohexstr(origin)
+             << ", LENGTH = 0x" << llvm::utohexstr(length);
+      output << R"THESCRIPT(
+}
+ENTRY(_main_init)
+SECTIONS
+{
+  . = 0x0;
+  .text : { 
+     /* the _main_init symbol from me_basic.o has to come at address zero. */
+     *me_basic.o(.text)
+     . = 0x200;
+     _ctors_start = .;
+     _init_array_start = .;
+     KEEP(SORT(*.init_array))
+     _ctors_end = .;
+     _init_array_end = .;
+     _dtors_start = .;
+     _dtors_end = .;
+     *(.text)
+  } > program
+  .data : { 
+     *(.data*);
+     *(.rodata*)
+  } > data
+)THESCRIPT";
+      auto doBuffer = [&](std::optional<TileID> tile, int offset,
+                          std::string dir) {
+        if (tile) {
+          if (TileOp neighbour = index.getTile(*tile))
+            for (auto buf : index.getBuffers(neighbour))
+              writeLDScriptMap(output, buf, offset);
+        } else {
+          output << "/* No tile with memory exists to the " << dir << ". */\n";
+          output << ". = 0x" << llvm::utohexstr(offset) << ";\n";
+          uint32_t localMemSize = targetModel.getLocalMemorySize();
+          output << ". += 0x" << llvm::utohexstr(localMemSize) << ";\n";
+        }
+      };
+
+      // Stack
+      output << ". = 0x"
+             << llvm::utohexstr(targetModel.getMemInternalBaseAddress(srcCoord))
+             << ";\n";
+      output << "_sp_start_value_DM_stack = .;\n";
+
+      if (auto core = index.getCore(tile))
+        output << ". += 0x" << llvm::utohexstr(core.getStackSize())
+               << "; /* stack */\n";
+      else
+        output << "/* no stack allocated */\n";
+
+      doBuffer(targetModel.getMemSouth(srcCoord),
+               targetModel.getMemSouthBaseAddress(), std::string("south"));
+      doBuffer(targetModel.getMemWest(srcCoord),
+               targetModel.getMemWestBaseAddress(), std::string("west"));
+      doBuffer(targetModel.getMemNorth(srcCoord),
+               targetModel.getMemNorthBaseAddress(), std::string("north"));
+      doBuffer(targetModel.getMemEast(srcCoord),
+               targetModel.getMemEastBaseAddress(), std::string("east"));
+
+      output << "  .bss : { *(.bss) } > data\n";
+      output << "  .bss.DMb.4 : { *(.bss.DMb.4) } > data\n";
+      output << "}\n";
+      if (auto coreOp = index.getCore(tile)) {
+        if (auto fileAttr = coreOp->getAttrOfType<StringAttr>("link_with")) {
+          auto fileName = std::string(fileAttr.getValue());
+          output << "INPUT(" << fileName << ")\n";
+        }
+        output << "PROVIDE(_main = core_" << tile.getCol() << "_"
+               << tile.getRow() << ");\n";
+      }
+    }
+  return success();
+}
+
+LogicalResult AIETranslateToBCF(ModuleOp module, raw_ostream &output,
+                                int tileCol, int tileRow) {
+  if (module.getOps<DeviceOp>().empty()) {
+    module.emitOpError("expected AIE.device operation at toplevel");
+  }
+  DeviceOp targetOp = *(module.getOps<DeviceOp>().begin());
+
+  DeviceIndex index(targetOp);
+
+  // _entry_point _main_init
+  // _symbol      _main _after _main_init
+  // _symbol      _main_init 0
+  // _reserved DMb      0x00000 0x20000
+  // _symbol   a        0x38000 0x2000
+  // _extern   a
+  // _stack    DM_stack 0x20000  0x400 //stack for core
+  // _reserved DMb 0x40000 0xc0000 // And everything else the core can't
+  // see
+  // // Include all symbols from rom.c
+  // _include _file rom.o
+  for (auto tile : targetOp.getOps<TileOp>())
+    if (tile.colIndex() == tileCol && tile.rowIndex() == tileRow) {
+      const auto &targetModel = getTargetModel(tile);
+
+      std::string corefunc = std::string("core_") +
+                             std::to_string(tile.getCol()) + "_" +
+                             std::to_string(tile.getRow());
+      output << "_entry_point _main_init\n";
+      output << "_symbol " << corefunc << " _after _main_init\n";
+      output << "_symbol      _main_init 0\n";
+      std::string initReserved =
+          (targetModel.getTargetArch() == AIEArch::AIE2) ? "0x40000"
+                                                         : "0x20000";
+      output << "_reserved DMb      0x00000 " << initReserved
+             << " //Don't put data in code memory\n";
+
+      TileID srcCoord = {tile.colIndex(), tile.rowIndex()};
+      auto doBuffer = [&](std::optional<TileID> tile, int offset,
+                          const std::string &dir) {
+        if (tile) {
+          if (TileOp neighbour = index.getTile(*tile))
+            for (auto buf : index.getBuffers(neighbour))
+              writeBCFMap(output, buf, offset);
+          uint32_t localMemSize = targetModel.getLocalMemorySize();
+          if (tile != srcCoord)
+            output << "_reserved DMb 0x" << llvm::utohexstr(offset) << " "
+                   << "0x" << llvm::utohexstr(localMemSize) << " "
+                   << " // Don't allocate variables outside of local "
+                      "memory.\n";
+          // TODO How to set as reserved if no buffer exists (or reserve
+          // remaining buffer)
+        } else {
+          uint32_t localMemSize = targetModel.getLocalMemorySize();
+          output << "_reserved DMb 0x" << llvm::utohexstr(offset) << " "
+                 << "0x" << llvm::utohexstr(localMemSize) << " "
+                 << " // No tile with memory exists to the " << dir
+                 << ".\n";
+        }
+      };
+
+      doBuffer(targetModel.getMemSouth(srcCoord),
+               targetModel.getMemSouthBaseAddress(), std::string("south"));
+      doBuffer(targetModel.getMemWest(srcCoord),
+               targetModel.getMemWestBaseAddress(), std::string("west"));
+      doBuffer(targetModel.getMemNorth(srcCoord),
+               targetModel.getMemNorthBaseAddress(), std::string("north"));
+      doBuffer(targetModel.getMemEast(srcCoord),
+               targetModel.getMemEastBaseAddress(), std::string("east"));
+
+      int stacksize = 0;
+      if (auto core = index.getCore(tile))
+        stacksize = core.getStackSize();
+      output << "_stack    DM_stack 0x"
+             << llvm::utohexstr(targetModel.getMemInternalBaseAddress(srcCoord))
+             << "  0x" << llvm::utohexstr(stacksize) << " //stack for core\n";
+
+      if (targetModel.getTargetArch() == AIEArch::AIE2) {
+        output << "_reserved DMb 0x80000 0x80000 // And everything else "
+                  "the core can't see\n";
+      } else {
+        output << "_reserved DMb 0x40000 0xc0000 // And everything else "
+                  "the core can't see\n";
+      }
+      if (auto coreOp = index.getCore(tile)) {
+        if (auto fileAttr = coreOp->getAttrOfType<StringAttr>("link_with")) {
+          auto fileName = std::string(fileAttr.getValue());
+          output << "_include _file " << fileName << "\n";
+        }
+      }
+      output << "_resolve _main core_" << tile.getCol() << "_"
+             << tile.getRow() << "\n";
+    }
+  return success();
+}
+
 void registerAIETranslations() {
   TranslateFromMLIRRegistration registrationMMap(
       "aie-generate-mmap", "Generate AIE memory map",
@@ -230,120 +431,7 @@ void registerAIETranslations() {
   TranslateFromMLIRRegistration registrationLDScript(
       "aie-generate-ldscript", "Generate AIE loader script",
       [](ModuleOp module, raw_ostream &output) {
-        DenseMap<TileID, Operation *> tiles;
-        DenseMap<Operation *, CoreOp> cores;
-        DenseMap<Operation *, MemOp> mems;
-        DenseMap<std::pair<Operation *, int>, LockOp> locks;
-        DenseMap<Operation *, SmallVector<BufferOp, 4>> buffers;
-        DenseMap<Operation *, SwitchboxOp> switchboxes;
-
-        if (module.getOps<DeviceOp>().empty()) {
-          module.emitOpError("expected AIE.device operation at toplevel");
-        }
-        DeviceOp targetOp = *(module.getOps<DeviceOp>().begin());
-
-        collectTiles(targetOp, tiles);
-        collectBuffers(targetOp, buffers);
-
-        for (auto tile : targetOp.getOps<TileOp>())
-          if (tile.colIndex() == tileCol && tile.rowIndex() == tileRow) {
-            TileID srcCoord = {tile.colIndex(), tile.rowIndex()};
-            const auto &targetModel = getTargetModel(tile);
-
-            // Figure out how much memory we have left for random allocations
-            auto core = tile.getCoreOp();
-            int max = core.getStackSize();
-            for (auto buf : buffers[tiles[srcCoord]]) {
-              int bufferBaseAddr = getBufferBaseAddress(buf);
-              int numBytes = buf.getAllocationSize();
-              max = std::max(max, bufferBaseAddr + numBytes);
-            }
-            int origin = targetModel.getMemInternalBaseAddress(srcCoord) + max;
-            int length = targetModel.getLocalMemorySize() - max;
-            output << R"THESCRIPT(
-MEMORY
-{
-   program (RX) : ORIGIN = 0, LENGTH = 0x0020000
-)THESCRIPT";
-            output << "   data (!RX) : ORIGIN = 0x" << llvm::utohexstr(origin)
-                   << ", LENGTH = 0x" << llvm::utohexstr(length);
-            output << R"THESCRIPT(
-}
-ENTRY(_main_init)
-SECTIONS
-{
-  . = 0x0;
-  .text : { 
-     /* the _main_init symbol from me_basic.o has to come at address zero. */
-     *me_basic.o(.text)
-     . = 0x200;
-     _ctors_start = .;
-     _init_array_start = .;
-     KEEP(SORT(*.init_array))
-     _ctors_end = .;
-     _init_array_end = .;
-     _dtors_start = .;
-     _dtors_end = .;
-     *(.text)
-  } > program
-  .data : { 
-     *(.data*);
-     *(.rodata*)
-  } > data
-)THESCRIPT";
-            auto doBuffer = [&](std::optional<TileID> tile, int offset,
-                                std::string dir) {
-              if (tile) {
-                if (tiles.count(*tile))
-                  for (auto buf : buffers[tiles[*tile]])
-                    writeLDScriptMap(output, buf, offset);
-              } else {
-                output << "/* No tile with memory exists to the " << dir
-                       << ". */\n";
-                output << ". = 0x" << llvm::utohexstr(offset) << ";\n";
-                uint32_t localMemSize = targetModel.getLocalMemorySize();
-                output << ". += 0x" << llvm::utohexstr(localMemSize) << ";\n";
-              }
-            };
-
-            // Stack
-            output << ". = 0x"
-                   << llvm::utohexstr(
-                          targetModel.getMemInternalBaseAddress(srcCoord))
-                   << ";\n";
-            output << "_sp_start_value_DM_stack = .;\n";
-
-            if (auto core = tile.getCoreOp())
-              output << ". += 0x" << llvm::utohexstr(core.getStackSize())
-                     << "; /* stack */\n";
-            else
-              output << "/* no stack allocated */\n";
-
-            doBuffer(targetModel.getMemSouth(srcCoord),
-                     targetModel.getMemSouthBaseAddress(),
-                     std::string("south"));
-            doBuffer(targetModel.getMemWest(srcCoord),
-                     targetModel.getMemWestBaseAddress(), std::string("west"));
-            doBuffer(targetModel.getMemNorth(srcCoord),
-                     targetModel.getMemNorthBaseAddress(),
-                     std::string("north"));
-            doBuffer(targetModel.getMemEast(srcCoord),
-                     targetModel.getMemEastBaseAddress(), std::string("east"));
-
-            output << "  .bss : { *(.bss) } > data\n";
-            output << "  .bss.DMb.4 : { *(.bss.DMb.4) } > data\n";
-            output << "}\n";
-            if (auto coreOp = tile.getCoreOp()) {
-              if (auto fileAttr =
-                      coreOp->getAttrOfType<StringAttr>("link_with")) {
-                auto fileName = std::string(fileAttr.getValue());
-                output << "INPUT(" << fileName << ")\n";
-              }
-              output << "PROVIDE(_main = core_" << tile.getCol() << "_"
-                     << tile.getRow() << ");\n";
-            }
-          }
-        return success();
+        return AIETranslateToLdScript(module, output, tileCol, tileRow);
       },
       registerDialects);
 
@@ -359,110 +447,7 @@ SECTIONS
   TranslateFromMLIRRegistration registrationBCF(
       "aie-generate-bcf", "Generate AIE bcf",
       [](ModuleOp module, raw_ostream &output) {
-        DenseMap<TileID, Operation *> tiles;
-        DenseMap<Operation *, CoreOp> cores;
-        DenseMap<Operation *, MemOp> mems;
-        DenseMap<std::pair<Operation *, int>, LockOp> locks;
-        DenseMap<Operation *, SmallVector<BufferOp, 4>> buffers;
-        DenseMap<Operation *, SwitchboxOp> switchboxes;
-
-        if (module.getOps<DeviceOp>().empty()) {
-          module.emitOpError("expected AIE.device operation at toplevel");
-        }
-        DeviceOp targetOp = *(module.getOps<DeviceOp>().begin());
-
-        collectTiles(targetOp, tiles);
-        collectBuffers(targetOp, buffers);
-
-        // _entry_point _main_init
-        // _symbol      _main _after _main_init
-        // _symbol      _main_init 0
-        // _reserved DMb      0x00000 0x20000
-        // _symbol   a        0x38000 0x2000
-        // _extern   a
-        // _stack    DM_stack 0x20000  0x400 //stack for core
-        // _reserved DMb 0x40000 0xc0000 // And everything else the core can't
-        // see
-        // // Include all symbols from rom.c
-        // _include _file rom.o
-        for (auto tile : targetOp.getOps<TileOp>())
-          if (tile.colIndex() == tileCol && tile.rowIndex() == tileRow) {
-            const auto &targetModel = getTargetModel(tile);
-
-            std::string corefunc = std::string("core_") +
-                                   std::to_string(tile.getCol()) + "_" +
-                                   std::to_string(tile.getRow());
-            output << "_entry_point _main_init\n";
-            output << "_symbol " << corefunc << " _after _main_init\n";
-            output << "_symbol      _main_init 0\n";
-            std::string initReserved =
-                (targetModel.getTargetArch() == AIEArch::AIE2) ? "0x40000"
-                                                               : "0x20000";
-            output << "_reserved DMb      0x00000 " << initReserved
-                   << " //Don't put data in code memory\n";
-
-            TileID srcCoord = {tile.colIndex(), tile.rowIndex()};
-            auto doBuffer = [&](std::optional<TileID> tile, int offset,
-                                const std::string &dir) {
-              if (tile) {
-                if (tiles.count(*tile))
-                  for (auto buf : buffers[tiles[*tile]])
-                    writeBCFMap(output, buf, offset);
-                uint32_t localMemSize = targetModel.getLocalMemorySize();
-                if (tile != srcCoord)
-                  output << "_reserved DMb 0x" << llvm::utohexstr(offset) << " "
-                         << "0x" << llvm::utohexstr(localMemSize) << " "
-                         << " // Don't allocate variables outside of local "
-                            "memory.\n";
-                // TODO How to set as reserved if no buffer exists (or reserve
-                // remaining buffer)
-              } else {
-                uint32_t localMemSize = targetModel.getLocalMemorySize();
-                output << "_reserved DMb 0x" << llvm::utohexstr(offset) << " "
-                       << "0x" << llvm::utohexstr(localMemSize) << " "
-                       << " // No tile with memory exists to the " << dir
-                       << ".\n";
-              }
-            };
-
-            doBuffer(targetModel.getMemSouth(srcCoord),
-                     targetModel.getMemSouthBaseAddress(),
-                     std::string("south"));
-            doBuffer(targetModel.getMemWest(srcCoord),
-                     targetModel.getMemWestBaseAddress(), std::string("west"));
-            doBuffer(targetModel.getMemNorth(srcCoord),
-                     targetModel.getMemNorthBaseAddress(),
-                     std::string("north"));
-            doBuffer(targetModel.getMemEast(srcCoord),
-                     targetModel.getMemEastBaseAddress(), std::string("east"));
-
-            int stacksize = 0;
-            if (auto core = tile.getCoreOp())
-              stacksize = core.getStackSize();
-            output << "_stack    DM_stack 0x"
-                   << llvm::utohexstr(
-                          targetModel.getMemInternalBaseAddress(srcCoord))
-                   << "  0x" << llvm::utohexstr(stacksize)
-                   << " //stack for core\n";
-
-            if (targetModel.getTargetArch() == AIEArch::AIE2) {
-              output << "_reserved DMb 0x80000 0x80000 // And everything else "
-                        "the core can't see\n";
-            } else {
-              output << "_reserved DMb 0x40000 0xc0000 // And everything else "
-                        "the core can't see\n";
-            }
-            if (auto coreOp = tile.getCoreOp()) {
-              if (auto fileAttr =
-                      coreOp->getAttrOfType<StringAttr>("link_with")) {
-                auto fileName = std::string(fileAttr.getValue());
-                output << "_include _file " << fileName << "\n";
-              }
-            }
-            output << "_resolve _main core_" << tile.getCol() << "_"
-                   << tile.getRow() << "\n";
-          }
-        return success();
+        return AIETranslateToBCF(module, output, tileCol, tileRow);
       },
       registerDialects);
 
@@ -489,12 +474,13 @@ SECTIONS
           module.emitOpError("expected AIE.device operation at toplevel");
         }
         DeviceOp targetOp = *(module.getOps<DeviceOp>().begin());
+        DeviceIndex index(targetOp);
 
         output << "[";
         for (auto tileOp : targetOp.getOps<TileOp>()) {
           int col = tileOp.colIndex();
           int row = tileOp.rowIndex();
-          if (auto coreOp = tileOp.getCoreOp()) {
+          if (auto coreOp = index.getCore(tileOp)) {
             std::string elfFile = "None";
             if (auto fileAttr = coreOp->getAttrOfType<StringAttr>("elf_file"))
               elfFile = "\"" + std::string(fileAttr.getValue()) + "\"";
@@ -539,10 +525,31 @@ SECTIONS
         return AIETranslateToCDO(module, output);
       },
       registerDialects);
+  TranslateFromMLIRRegistration registrationTransaction(
+      "aie-generate-transaction",
+      "Generate a binary register write stream for AIE-ML configuration",
+      [](ModuleOp module, raw_ostream &output) {
+        return AIETranslateToTransaction(module, output, /*textual=*/false);
+      },
+      registerDialects);
+  TranslateFromMLIRRegistration registrationTransactionText(
+      "aie-generate-transaction-text",
+      "Print the AIE-ML register write stream in readable form",
+      [](ModuleOp module, raw_ostream &output) {
+        return AIETranslateToTransaction(module, output, /*textual=*/true);
+      },
+      registerDialects);
   TranslateFromMLIRRegistration registrationIPU(
       "aie-ipu-instgen", "Generate instructions for IPU",
       [](ModuleOp module, raw_ostream &output) {
-        return AIETranslateToIPU(module, output);
+        return AIETranslateToIPU(module, output, /*binary=*/false);
+      },
+      registerDialects);
+  TranslateFromMLIRRegistration registrationIPUBinary(
+      "aie-ipu-instgen-binary",
+      "Generate instructions for IPU as a little endian binary file",
+      [](ModuleOp module, raw_ostream &output) {
+        return AIETranslateToIPU(module, output, /*binary=*/true);
       },
       registerDialects);
 }
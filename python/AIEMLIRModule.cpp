@@ -9,6 +9,9 @@
 
 #include "aie-c/Dialects.h"
 #include "aie-c/Registration.h"
+#include "aie-c/Translation.h"
+
+#include <pybind11/stl.h>
 
 namespace py = pybind11;
 using namespace mlir::python::adaptors;
@@ -44,6 +47,37 @@ PYBIND11_MODULE(_aieMlir, m) {
       },
       py::arg("context"), py::arg("load") = true);
 
+  m.def(
+      "translate_cores",
+      [](MlirOperation module, const std::vector<std::pair<int, int>> &cores,
+         const std::string &passPipeline, bool bcf) {
+        using CoreArtifacts =
+            std::vector<std::tuple<int, int, std::string, std::string>>;
+        std::vector<int> cols, rows;
+        for (auto [col, row] : cores) {
+          cols.push_back(col);
+          rows.push_back(row);
+        }
+        CoreArtifacts artifacts;
+        MlirLogicalResult result = aieTranslateCores(
+            module, cols.data(), rows.data(), cores.size(),
+            mlirStringRefCreate(passPipeline.data(), passPipeline.size()), bcf,
+            [](int col, int row, MlirStringRef llvmIR,
+               MlirStringRef linkerScript, void *userData) {
+              static_cast<CoreArtifacts *>(userData)->emplace_back(
+                  col, row, std::string(llvmIR.data, llvmIR.length),
+                  std::string(linkerScript.data, linkerScript.length));
+            },
+            &artifacts);
+        if (mlirLogicalResultIsFailure(result))
+          throw py::value_error("failed to lower cores");
+        return artifacts;
+      },
+      "Lower the given (col, row) cores of a placed module in parallel and "
+      "return a list of (col, row, llvm_ir, linker_script) tuples.",
+      py::arg("module"), py::arg("cores"), py::arg("pass_pipeline"),
+      py::arg("bcf") = false);
+
   // AIE types bindings
   mlir_type_subclass(m, "ObjectFifoType", aieTypeIsObjectFifoType)
       .def_classmethod(
@@ -30,6 +30,14 @@ def parse_args(args=None):
             metavar="tmpdir",
             default=None,
             help='directory used for temporary file storage')
+    parser.add_argument('--routing-cache-dir',
+            metavar="routing_cache_dir",
+            default=None,
+            help='directory used to cache the routing of aie.flow operations across invocations')
+    parser.add_argument('--cache-dir',
+            metavar="cache_dir",
+            default=None,
+            help='directory used to cache generated files across invocations, keyed by the hash of the inputs of each step')
     parser.add_argument('-v',
             dest="verbose",
             default=False,
@@ -132,6 +140,26 @@ def parse_args(args=None):
             default=not aie_unified_compile,
             action='store_false',
             help='Compile cores independently in separate processes')
+    parser.add_argument('--inprocess',
+            dest="inprocess",
+            default=True,
+            action='store_true',
+            help='Lower cores to LLVM IR and generate their linker scripts in parallel inside aiecc (with --no-unified)')
+    parser.add_argument('--no-inprocess',
+            dest="inprocess",
+            default=False,
+            action='store_false',
+            help='Lower each core with separate aie-opt and aie-translate invocations (with --no-unified)')
+    parser.add_argument('--dedupe-cores',
+            dest="dedupe_cores",
+            default=False,
+            action='store_true',
+            help='Compile cores with identical code once and link the object for each of their tiles (with --inprocess)')
+    parser.add_argument('--no-dedupe-cores',
+            dest="dedupe_cores",
+            default=False,
+            action='store_false',
+            help='Compile every core separately')
     parser.add_argument('-n',
             dest="execute",
             default=True,
@@ -152,6 +180,11 @@ def parse_args(args=None):
             default=False,
             action='store_const', const=True,
             help='Generate ipu instruction stream only')
+    parser.add_argument('--aie-ipu-optimize',
+            dest="ipu_optimize",
+            default=False,
+            action='store_const', const=True,
+            help='Remove redundant writes, syncs and BD writes from the ipu instruction stream')
     parser.add_argument('--ipu-insts-name',
             dest="insts_name",
             default="ipu_insts.txt",
@@ -22,6 +22,7 @@ import glob
 import random
 import json
 import tempfile
+import hashlib
 
 from aie.passmanager import PassManager
 from aie.ir import Module, Context, Location
@@ -47,6 +48,40 @@ aie_opt_passes = ['--aie-normalize-address-spaces',
                   '--canonicalize',
                   '--cse']
 
+# Turn aie-opt style arguments ('--pass=options') into a textual pass pipeline.
+def to_pass_pipeline(args):
+  def to_pass(arg):
+    name, _, options = arg[2:].partition('=')
+    return name + ('{' + options + '}' if options else '')
+  return ','.join(map(to_pass, args))
+
+llvm_symbol = r'[-a-zA-Z$._0-9]+'
+
+# Rename the core function and the buffers of a core's LLVM IR to names derived
+# from prefix. Every core declares all the buffers of the design, so only the
+# buffers the core refers to are kept, numbered in order of first use. Cores
+# that stamp the same code on different tiles then only differ in those names:
+# buffer addresses are resolved by the linker script, and locks are addressed
+# relative to the core. Lock IDs are still part of the code, so cores that use
+# different locks of their tile do not share a kernel. Returns the renamed IR
+# and the original names of the buffers the core refers to.
+def canonicalize_core_llvmir(llvmir, corecol, corerow, prefix):
+  symbol_ref = r'@(%s)(?![-a-zA-Z$._0-9])' % llvm_symbol
+  declaration = re.compile(r'^@(%s) = external (?:\w+ )*global.*\n' % llvm_symbol, re.MULTILINE)
+  declarations = {m.group(1): m.group(0) for m in declaration.finditer(llvmir)}
+  first = declaration.search(llvmir)
+  code = declaration.sub('', llvmir)
+  buffers = []
+  for name in re.findall(symbol_ref, code):
+    if(name in declarations and name not in buffers):
+      buffers.append(name)
+  if(first):
+    code = code[:first.start()] + ''.join(declarations[name] for name in buffers) + code[first.start():]
+  renames = {name: '%s_buf%d' % (prefix, i) for i, name in enumerate(buffers)}
+  renames['core_%d_%d' % (corecol, corerow)] = prefix
+  llvmir = re.sub(symbol_ref, lambda m: '@' + renames.get(m.group(1), m.group(1)), code)
+  return llvmir, buffers
+
 class flow_runner:
   def __init__(self, mlir_module_str, opts, tmpdirname):
       self.mlir_module_str = mlir_module_str
@@ -56,6 +91,12 @@ class flow_runner:
       self.progress_bar = None
       self.maxtasks = 5
       self.stopall = False
+      self.inprocess_cores = set()
+      self.core_kernels = dict()
+      self.kernel_objects = dict()
+      self.digests = dict()
+      self.cache_hits = 0
+      self.cache_misses = 0
 
   async def do_call(self, task, command, force=False):
       if(self.stopall):
@@ -94,6 +135,142 @@ class flow_runner:
       ret = subprocess.run(command, stdout=m, stderr=m, universal_newlines=True)
       return ret
 
+  # Digest of the contents of a file, remembered for as long as the file is
+  # not modified.
+  def file_digest(self, path):
+      st = os.stat(path)
+      key = (os.path.abspath(path), st.st_mtime_ns, st.st_size)
+      if(key not in self.digests):
+        with open(path, 'rb') as f:
+          self.digests[key] = hashlib.sha256(f.read()).hexdigest()
+      return self.digests[key]
+
+  # Identify an installed tool or library by where it is and when it was
+  # built, which is much cheaper than asking it for its version.
+  def file_identity(self, path):
+      st = os.stat(path)
+      return '%s %d %d' % (os.path.realpath(path), st.st_size, st.st_mtime_ns)
+
+  # Key of a step in the artifact cache: the hash of everything the step
+  # depends on. The temporary directory is abstracted away so that the same
+  # step of another build shares the key, but the contents of every file the
+  # command refers to are part of it, including the objects its linker script
+  # pulls in and the libraries it links with -l. Returns None if the step can't
+  # be cached.
+  def cache_key(self, *parts, command=[], outputs=[]):
+      h = hashlib.sha256()
+      for part in [*parts, os.environ.get('AIETOOLS', '')]:
+        h.update(str(part).encode() + b'\0')
+      if(command):
+        tool = shutil.which(command[0])
+        if(tool):
+          h.update(self.file_identity(tool).encode() + b'\0')
+      for (i, arg) in enumerate(command):
+        h.update(arg.replace(self.tmpdirname, '<tmp>').encode() + b'\0')
+        for path in re.split(r'[,=\s]', arg):
+          if(path and path not in outputs and os.path.isfile(path)):
+            h.update(self.file_digest(path).encode() + b'\0')
+        script = None
+        if(arg.startswith('-Wl,-T,')):
+          script = arg[len('-Wl,-T,'):]
+        elif(i > 0 and command[i - 1] == '+l'):
+          script = arg
+        if(script):
+          for path in self.linker_script_inputs(script):
+            # The linker may find it somewhere we don't know to look.
+            if(not os.path.isfile(path)):
+              return None
+            h.update(path.encode() + b'\0' + self.file_digest(path).encode() + b'\0')
+      libraries = self.linked_libraries(command)
+      if(libraries is None):
+        return None
+      for path in libraries:
+        h.update(path.encode() + b'\0' + self.file_digest(path).encode() + b'\0')
+      return h.hexdigest()
+
+  # Libraries a command links with -l, looked up in its -L directories the way
+  # the linker does. Returns None if one of them isn't there, since the linker
+  # may then find it in a default directory. Libraries that the toolchain links
+  # implicitly are only covered by the identity of the tool.
+  def linked_libraries(self, command):
+      dirs = []
+      names = []
+      for (i, arg) in enumerate(command):
+        for (flag, found) in [('-L', dirs), ('-l', names)]:
+          if(arg == flag and i + 1 < len(command)):
+            found.append(command[i + 1])
+          elif(arg.startswith(flag) and arg != flag):
+            found.append(arg[len(flag):])
+      libraries = []
+      for name in names:
+        if(name.startswith(':')):
+          candidates = [name[1:]]
+        else:
+          candidates = ['lib%s.so' % name, 'lib%s.a' % name]
+        paths = [os.path.join(d, c) for d in dirs for c in candidates]
+        path = next((p for p in paths if os.path.isfile(p)), None)
+        if(path is None):
+          return None
+        libraries.append(path)
+      return libraries
+
+  # Files a linker script adds to the link without naming them on the command
+  # line: INPUT() in a GNU ld script and _include _file in a Chess BCF.
+  def linker_script_inputs(self, script):
+      with open(script, 'r') as f:
+        text = f.read()
+      return (re.findall(r'^\s*INPUT\((.*)\)\s*$', text, re.MULTILINE) +
+              re.findall(r'^\s*_include _file (\S+)', text, re.MULTILINE))
+
+  def cache_entry(self, key):
+      return os.path.join(self.opts.cache_dir, key[0:2], key)
+
+  # Copy the outputs of a step out of the cache, if it holds all of them.
+  def cache_lookup(self, key, outputs):
+      entry = self.cache_entry(key)
+      cached = [os.path.join(entry, str(i)) for i in range(len(outputs))]
+      if(not all(os.path.isfile(c) for c in cached)):
+        self.cache_misses += 1
+        return False
+      for (c, output) in zip(cached, outputs):
+        shutil.copy(c, output)
+      self.cache_hits += 1
+      return True
+
+  # Store the outputs of a step. The entry is staged next to its final place
+  # and renamed into it, so that concurrent builds never see half an entry.
+  def cache_store(self, key, outputs):
+      entry = self.cache_entry(key)
+      os.makedirs(os.path.dirname(entry), exist_ok=True)
+      staging = tempfile.mkdtemp(dir=os.path.dirname(entry))
+      for (i, output) in enumerate(outputs):
+        shutil.copy(output, os.path.join(staging, str(i)))
+      try:
+        os.rename(staging, entry)
+      except OSError:
+        # Another build stored the same step first.
+        shutil.rmtree(staging)
+
+  # Run a command whose only effect is to write outputs, reusing the outputs
+  # of an earlier run with the same inputs when the artifact cache has them.
+  async def do_cached_call(self, task, command, outputs):
+      if(self.stopall or not self.opts.cache_dir or not self.opts.execute):
+        await self.do_call(task, command)
+        return
+      key = self.cache_key(command=command, outputs=outputs)
+      if(key is None):
+        await self.do_call(task, command)
+        return
+      if(self.cache_lookup(key, outputs)):
+        if(self.opts.verbose):
+          print("Cached: " + " ".join(command))
+        if(task):
+          self.progress_bar.update(task, advance=1, command="")
+        return
+      await self.do_call(task, command)
+      if(not self.stopall):
+        self.cache_store(key, outputs)
+
   def run_passes(self, pass_pipeline, mlir_module_str, outputfile=None):
       if self.opts.verbose:
         print("Running:", pass_pipeline)
@@ -107,6 +284,122 @@ class flow_runner:
             g.write(mlir_module_str)
       return mlir_module_str
 
+  # Lower all cores to LLVM IR and generate their linker scripts in parallel,
+  # parsing the design once, instead of invoking aie-opt and aie-translate on
+  # the whole design for every core.
+  def lower_cores_inprocess(self, cores):
+      start = time.time()
+      coords = [core[0:2] for core in cores]
+      pipeline = to_pass_pipeline(aie_opt_passes)
+      script_ext = "bcf" if self.opts.xbridge else "ld.script"
+      outputs = [self.tmpcorefile((corecol, corerow, None), ext)
+                 for (corecol, corerow) in coords for ext in ["ll", script_ext]]
+      if(self.opts.cache_dir):
+        library = sys.modules[aiedialect.translate_cores.__module__].__file__
+        key = self.cache_key(self.file_digest(self.file_with_addresses),
+                             coords, pipeline, self.opts.xbridge,
+                             self.file_identity(library))
+      if(self.opts.cache_dir and self.cache_lookup(key, outputs)):
+        if(self.opts.verbose):
+          print("Cached: in-process lowering of %d cores" % len(cores))
+      else:
+        with Context() as ctx, Location.unknown():
+          aiedialect.register_dialect(ctx)
+          with open(self.file_with_addresses, 'r') as f:
+            module = Module.parse(f.read())
+          artifacts = aiedialect.translate_cores(module.operation, coords,
+                                                 pipeline, self.opts.xbridge)
+        for (corecol, corerow, llvmir, linker_script) in artifacts:
+          core = (corecol, corerow, None)
+          with open(self.tmpcorefile(core, "ll"), 'w') as f:
+            f.write(llvmir)
+          with open(self.tmpcorefile(core, script_ext), 'w') as f:
+            f.write(linker_script)
+        if(self.opts.cache_dir):
+          self.cache_store(key, outputs)
+      self.inprocess_cores.update(coords)
+      end = time.time()
+      if(self.opts.verbose):
+        print("Lowered %d cores in process in %.3f sec" % (len(cores), end-start))
+      self.runtimes["in-process lowering of %d cores" % len(cores)] = end-start
+
+  # Group the cores lowered in process by their code, ignoring the names of
+  # the core function and of the buffers, and give every group of two or more
+  # cores a single kernel to compile. Each core of a group is then linked from
+  # the kernel object with its own linker script, which maps the kernel's
+  # symbols onto the core's buffers.
+  def find_identical_cores(self, cores):
+      groups = dict()
+      for core in cores:
+        (corecol, corerow, elf_file) = core
+        if(elf_file or (corecol, corerow) not in self.inprocess_cores):
+          continue
+        with open(self.tmpcorefile(core, "ll"), 'r') as f:
+          llvmir, buffers = canonicalize_core_llvmir(f.read(), corecol, corerow, '__aie_kernel')
+        key = hashlib.sha256(llvmir.encode()).hexdigest()[0:16]
+        groups.setdefault(key, (llvmir, []))[1].append(((corecol, corerow), buffers))
+      for key, (llvmir, members) in groups.items():
+        if(len(members) < 2):
+          continue
+        kernel = 'kernel_' + key
+        with open(os.path.join(self.tmpdirname, kernel + '.ll'), 'w') as f:
+          f.write(llvmir.replace('__aie_kernel', kernel))
+        for (coord, buffers) in members:
+          self.core_kernels[coord] = (kernel, buffers)
+      if(self.opts.verbose):
+        print("%d cores share %d kernels" % (len(self.core_kernels),
+              len(set(k for (k, _) in self.core_kernels.values()))))
+
+  async def compile_kernel(self, task, kernel):
+      file_kernel_llvmir = os.path.join(self.tmpdirname, kernel + '.ll')
+      file_kernel_obj = os.path.join(self.tmpdirname, kernel + '.o')
+      if(opts.xchesscc):
+        file_kernel_llvmir_chesslinked = await self.chesshack(task, file_kernel_llvmir)
+        await self.do_cached_call(task, ['xchesscc_wrapper', self.aie_target.lower(), '+w', os.path.join(self.tmpdirname, 'work'), '-c', '-d', '-f', '+P', '4', file_kernel_llvmir_chesslinked, '-o', file_kernel_obj], [file_kernel_obj])
+      else:
+        file_kernel_llvmir_stripped = os.path.join(self.tmpdirname, kernel + '.stripped.ll')
+        await self.do_cached_call(task, ['opt', '--passes=default<O2>,strip', '-S', file_kernel_llvmir, '-o', file_kernel_llvmir_stripped], [file_kernel_llvmir_stripped])
+        await self.do_cached_call(task, ['llc', file_kernel_llvmir_stripped, '-O2', '--march=%s' % self.aie_target.lower(), '--function-sections', '--filetype=obj', '-o', file_kernel_obj], [file_kernel_obj])
+      return file_kernel_obj
+
+  # Link a core from the object of the kernel it shares with other cores. The
+  # first core to get here compiles the kernel.
+  async def link_kernel_core(self, task, core, clang_link_args):
+      (corecol, corerow, _) = core
+      (kernel, buffers) = self.core_kernels[(corecol, corerow)]
+      if(kernel not in self.kernel_objects):
+        self.kernel_objects[kernel] = asyncio.ensure_future(self.compile_kernel(task, kernel))
+      file_kernel_obj = await self.kernel_objects[kernel]
+      if(not opts.link):
+        return
+
+      core_main = 'core_%d_%d' % (corecol, corerow)
+      file_core_elf = self.corefile(".", core, "elf")
+      if(opts.xbridge):
+        with open(self.tmpcorefile(core, "bcf"), 'r') as f:
+          bcf = f.read()
+        bcf = re.sub(r'\b%s\b' % core_main, kernel, bcf)
+        for i, name in enumerate(buffers):
+          m = re.search(r'^_symbol %s (\S+) (\S+)$' % re.escape(name), bcf, re.MULTILINE)
+          if(m):
+            bcf += '_symbol %s_buf%d %s %s\n_extern %s_buf%d\n' % (kernel, i, m.group(1), m.group(2), kernel, i)
+        file_core_bcf = self.tmpcorefile(core, "kernel.bcf")
+        with open(file_core_bcf, 'w') as f:
+          f.write(bcf)
+        link_with_obj = self.extract_input_files(file_core_bcf)
+        await self.do_cached_call(task, ['xchesscc_wrapper', self.aie_target.lower(), '+w', os.path.join(self.tmpdirname, 'work'), '-d', '-f', file_kernel_obj, link_with_obj, '+l', file_core_bcf, '-o', file_core_elf], [file_core_elf])
+      else:
+        with open(self.tmpcorefile(core, "ld.script"), 'r') as f:
+          ldscript = f.read()
+        ldscript = ldscript.replace('PROVIDE(_main = %s);' % core_main, 'PROVIDE(_main = %s);' % kernel)
+        for i, name in enumerate(buffers):
+          ldscript += '%s_buf%d = %s;\n' % (kernel, i, name)
+        file_core_ldscript = self.tmpcorefile(core, "kernel.ld.script")
+        with open(file_core_ldscript, 'w') as f:
+          f.write(ldscript)
+        await self.do_cached_call(task, ['clang', '-O2', '--target=' + self.aie_peano_target, file_kernel_obj, *clang_link_args,
+                                  '-Wl,-T,'+file_core_ldscript, '-o', file_core_elf], [file_core_elf])
+
   def corefile(self, dirname, core, ext):
       (corecol, corerow, _) = core
       return os.path.join(dirname, 'core_%d_%d.%s' % (corecol, corerow, ext))
@@ -202,23 +495,34 @@ class flow_runner:
         task = None
 
       (corecol, corerow, elf_file) = core
-      if(not opts.unified):
+      if((corecol, corerow) in self.core_kernels and opts.compile):
+        await self.link_kernel_core(task, core, clang_link_args)
+        self.progress_bar.update(self.progress_bar.task_completed,advance=1)
+        if(task):
+          self.progress_bar.update(task,advance=0,visible=False)
+        return
+
+      inprocess = (corecol, corerow) in self.inprocess_cores
+      if(not opts.unified and not inprocess):
         file_core = self.tmpcorefile(core, "mlir")
-        await self.do_call(task, ['aie-opt', '--aie-localize-locks',
+        await self.do_cached_call(task, ['aie-opt', '--aie-localize-locks',
                             '--aie-standard-lowering=tilecol=%d tilerow=%d' % core[0:2],
                             '--aiex-standard-lowering',
-                            self.file_with_addresses, '-o', file_core])
+                            self.file_with_addresses, '-o', file_core], [file_core])
         file_opt_core = self.tmpcorefile(core, "opt.mlir")
-        await self.do_call(task, ['aie-opt', *aie_opt_passes, file_core, '-o', file_opt_core])
+        await self.do_cached_call(task, ['aie-opt', *aie_opt_passes, file_core, '-o', file_opt_core], [file_opt_core])
       if(self.opts.xbridge):
         file_core_bcf = self.tmpcorefile(core, "bcf")
-        await self.do_call(task, ['aie-translate', self.file_with_addresses, '--aie-generate-bcf', '--tilecol=%d' % corecol, '--tilerow=%d' % corerow, '-o', file_core_bcf])
+        if(not inprocess):
+          await self.do_cached_call(task, ['aie-translate', self.file_with_addresses, '--aie-generate-bcf', '--tilecol=%d' % corecol, '--tilerow=%d' % corerow, '-o', file_core_bcf], [file_core_bcf])
       else:
         file_core_ldscript = self.tmpcorefile(core, "ld.script")
-        await self.do_call(task, ['aie-translate', self.file_with_addresses, '--aie-generate-ldscript', '--tilecol=%d' % corecol, '--tilerow=%d' % corerow, '-o', file_core_ldscript])
+        if(not inprocess):
+          await self.do_cached_call(task, ['aie-translate', self.file_with_addresses, '--aie-generate-ldscript', '--tilecol=%d' % corecol, '--tilerow=%d' % corerow, '-o', file_core_ldscript], [file_core_ldscript])
       if(not self.opts.unified):
         file_core_llvmir = self.tmpcorefile(core, "ll")
-        await self.do_call(task, ['aie-translate', '--mlir-to-llvmir', file_opt_core, '-o', file_core_llvmir])
+        if(not inprocess):
+          await self.do_cached_call(task, ['aie-translate', '--mlir-to-llvmir', file_opt_core, '-o', file_core_llvmir], [file_core_llvmir])
         file_core_obj = self.tmpcorefile(core, "o")
 
       file_core_elf = elf_file if elf_file else self.corefile(".", core, "elf")
@@ -228,33 +532,33 @@ class flow_runner:
           file_core_llvmir_chesslinked = await self.chesshack(task, file_core_llvmir)
           if(self.opts.link and self.opts.xbridge):
             link_with_obj = self.extract_input_files(file_core_bcf)
-            await self.do_call(task, ['xchesscc_wrapper', self.aie_target.lower(), '+w', os.path.join(self.tmpdirname, 'work'), '-d', '-f', '+P', '4', file_core_llvmir_chesslinked, link_with_obj, '+l', file_core_bcf, '-o', file_core_elf])
+            await self.do_cached_call(task, ['xchesscc_wrapper', self.aie_target.lower(), '+w', os.path.join(self.tmpdirname, 'work'), '-d', '-f', '+P', '4', file_core_llvmir_chesslinked, link_with_obj, '+l', file_core_bcf, '-o', file_core_elf], [file_core_elf])
           elif(self.opts.link):
-            await self.do_call(task, ['xchesscc_wrapper', self.aie_target.lower(), '+w', os.path.join(self.tmpdirname, 'work'), '-c', '-d', '-f', '+P', '4', file_core_llvmir_chesslinked, '-o', file_core_obj])
-            await self.do_call(task, ['clang', '-O2', '--target=' + self.aie_peano_target, file_core_obj, *clang_link_args,
-                                      '-Wl,-T,'+file_core_ldscript, '-o', file_core_elf])
+            await self.do_cached_call(task, ['xchesscc_wrapper', self.aie_target.lower(), '+w', os.path.join(self.tmpdirname, 'work'), '-c', '-d', '-f', '+P', '4', file_core_llvmir_chesslinked, '-o', file_core_obj], [file_core_obj])
+            await self.do_cached_call(task, ['clang', '-O2', '--target=' + self.aie_peano_target, file_core_obj, *clang_link_args,
+                                      '-Wl,-T,'+file_core_ldscript, '-o', file_core_elf], [file_core_elf])
         else:
           file_core_obj = self.file_obj
           if(opts.link and opts.xbridge):
             link_with_obj = self.extract_input_files(file_core_bcf)
-            await self.do_call(task, ['xchesscc_wrapper', self.aie_target.lower(), '+w', os.path.join(self.tmpdirname, 'work'), '-d', '-f', file_core_obj, link_with_obj, '+l', file_core_bcf, '-o', file_core_elf])
+            await self.do_cached_call(task, ['xchesscc_wrapper', self.aie_target.lower(), '+w', os.path.join(self.tmpdirname, 'work'), '-d', '-f', file_core_obj, link_with_obj, '+l', file_core_bcf, '-o', file_core_elf], [file_core_elf])
           elif(opts.link):
-            await self.do_call(task, ['clang', '-O2', '--target=' + self.aie_peano_target, file_core_obj, *clang_link_args,
-                                      '-Wl,-T,'+file_core_ldscript, '-o', file_core_elf])
+            await self.do_cached_call(task, ['clang', '-O2', '--target=' + self.aie_peano_target, file_core_obj, *clang_link_args,
+                                      '-Wl,-T,'+file_core_ldscript, '-o', file_core_elf], [file_core_elf])
 
       elif(opts.compile):
         if(not opts.unified):
           file_core_llvmir_stripped = self.tmpcorefile(core, "stripped.ll")
-          await self.do_call(task, ['opt', '--passes=default<O2>,strip', '-S', file_core_llvmir, '-o', file_core_llvmir_stripped])
-          await self.do_call(task, ['llc', file_core_llvmir_stripped, '-O2', '--march=%s' % self.aie_target.lower(), '--function-sections', '--filetype=obj', '-o', file_core_obj])
+          await self.do_cached_call(task, ['opt', '--passes=default<O2>,strip', '-S', file_core_llvmir, '-o', file_core_llvmir_stripped], [file_core_llvmir_stripped])
+          await self.do_cached_call(task, ['llc', file_core_llvmir_stripped, '-O2', '--march=%s' % self.aie_target.lower(), '--function-sections', '--filetype=obj', '-o', file_core_obj], [file_core_obj])
         else:
           file_core_obj = self.file_obj
         if(opts.link and opts.xbridge):
           link_with_obj = self.extract_input_files(file_core_bcf)
-          await self.do_call(task, ['xchesscc_wrapper', self.aie_target.lower(), '+w', os.path.join(self.tmpdirname, 'work'), '-d', '-f', file_core_obj, link_with_obj, '+l', file_core_bcf, '-o', file_core_elf])
+          await self.do_cached_call(task, ['xchesscc_wrapper', self.aie_target.lower(), '+w', os.path.join(self.tmpdirname, 'work'), '-d', '-f', file_core_obj, link_with_obj, '+l', file_core_bcf, '-o', file_core_elf], [file_core_elf])
         elif(opts.link):
-          await self.do_call(task, ['clang', '-O2', '--target=' + self.aie_peano_target, file_core_obj, *clang_link_args,
-                                    '-Wl,-T,'+file_core_ldscript, '-o', file_core_elf])
+          await self.do_cached_call(task, ['clang', '-O2', '--target=' + self.aie_peano_target, file_core_obj, *clang_link_args,
+                                    '-Wl,-T,'+file_core_ldscript, '-o', file_core_elf], [file_core_elf])
 
       self.progress_bar.update(self.progress_bar.task_completed,advance=1)
       if(task):
@@ -480,14 +784,17 @@ all:
 
       # Generate the included host interface
       file_physical = os.path.join(self.tmpdirname, 'input_physical.mlir')
-      await self.do_call(task, ['aie-opt', '--aie-create-pathfinder-flows', '--aie-lower-broadcast-packet', '--aie-create-packet-flows', '--aie-lower-multicast', self.file_with_addresses, '-o', file_physical])
+      pathfinder_flows = '--aie-create-pathfinder-flows'
+      if(self.opts.routing_cache_dir):
+        pathfinder_flows += '=cache-dir=%s' % os.path.abspath(self.opts.routing_cache_dir)
+      await self.do_cached_call(task, ['aie-opt', pathfinder_flows, '--aie-lower-broadcast-packet', '--aie-create-packet-flows', '--aie-lower-multicast', self.file_with_addresses, '-o', file_physical], [file_physical])
       file_inc_cpp = os.path.join(self.tmpdirname, 'aie_inc.cpp')
-      await self.do_call(task, ['aie-translate', '--aie-generate-xaie', file_physical, '-o', file_inc_cpp])
+      await self.do_cached_call(task, ['aie-translate', '--aie-generate-xaie', file_physical, '-o', file_inc_cpp], [file_inc_cpp])
 
       # Optionally generate aie_control.cpp for CDO to XCLBIN backend
       file_control_cpp = os.path.join(self.tmpdirname, 'aie_control.cpp')
       if (opts.cdo):
-        await self.do_call(task, ['aie-translate', '--aie-generate-cdo', file_physical, '-o', file_control_cpp])
+        await self.do_cached_call(task, ['aie-translate', '--aie-generate-cdo', file_physical, '-o', file_control_cpp], [file_control_cpp])
 
       cmd = ['clang++','-std=c++11']
       if(opts.host_target):
@@ -678,9 +985,10 @@ aiesimulator --pkg-dir=${prj_name}/sim --dump-vcd ${vcd_filename}
         # Optionally generate insts.txt for IPU instruction stream
         if (opts.ipu or opts.only_ipu):
           generated_insts_mlir = os.path.join(self.tmpdirname, 'generated_ipu_insts.mlir')
-          await self.do_call(progress_bar.task, ['aie-opt',
-                                    '--aie-dma-to-ipu', self.file_with_addresses, '-o', generated_insts_mlir])
-          await self.do_call(progress_bar.task, ['aie-translate', '--aie-ipu-instgen', generated_insts_mlir, '-o', opts.insts_name])
+          ipu_passes = ['--aie-dma-to-ipu'] + (['--aie-ipu-optimize'] if opts.ipu_optimize else [])
+          await self.do_cached_call(progress_bar.task, ['aie-opt'] + ipu_passes +
+                                    [self.file_with_addresses, '-o', generated_insts_mlir], [generated_insts_mlir])
+          await self.do_cached_call(progress_bar.task, ['aie-translate', '--aie-ipu-instgen', generated_insts_mlir, '-o', opts.insts_name], [opts.insts_name])
           if (opts.only_ipu):
             return
 
@@ -688,28 +996,33 @@ aiesimulator --pkg-dir=${prj_name}/sim --dump-vcd ${vcd_filename}
 
         if(opts.unified):
           self.file_opt_with_addresses = os.path.join(self.tmpdirname, 'input_opt_with_addresses.mlir')
-          await self.do_call(progress_bar.task, ['aie-opt', '--aie-localize-locks',
+          await self.do_cached_call(progress_bar.task, ['aie-opt', '--aie-localize-locks',
                               '--aie-standard-lowering',
                               '--aiex-standard-lowering',
                               *aie_opt_passes,
-                              self.file_with_addresses, '-o', self.file_opt_with_addresses])
+                              self.file_with_addresses, '-o', self.file_opt_with_addresses], [self.file_opt_with_addresses])
 
           self.file_llvmir = os.path.join(self.tmpdirname, 'input.ll')
-          await self.do_call(progress_bar.task, ['aie-translate', '--mlir-to-llvmir', self.file_opt_with_addresses, '-o', self.file_llvmir])
+          await self.do_cached_call(progress_bar.task, ['aie-translate', '--mlir-to-llvmir', self.file_opt_with_addresses, '-o', self.file_llvmir], [self.file_llvmir])
 
           self.file_obj = os.path.join(self.tmpdirname, 'input.o')
           if(opts.compile and opts.xchesscc):
             file_llvmir_hacked = await self.chesshack(progress_bar.task, self.file_llvmir)
-            await self.do_call(progress_bar.task, ['xchesscc_wrapper', self.aie_target.lower(), '+w', os.path.join(self.tmpdirname, 'work'), '-c', '-d', '-f', '+P', '4', file_llvmir_hacked, '-o', self.file_obj])
+            await self.do_cached_call(progress_bar.task, ['xchesscc_wrapper', self.aie_target.lower(), '+w', os.path.join(self.tmpdirname, 'work'), '-c', '-d', '-f', '+P', '4', file_llvmir_hacked, '-o', self.file_obj], [self.file_obj])
           elif(opts.compile):
             self.file_llvmir_opt= os.path.join(self.tmpdirname, 'input.opt.ll')
-            await self.do_call(progress_bar.task, ['opt', '--passes=default<O2>', '-inline-threshold=10', '-S', self.file_llvmir, '-o', self.file_llvmir_opt])
+            await self.do_cached_call(progress_bar.task, ['opt', '--passes=default<O2>', '-inline-threshold=10', '-S', self.file_llvmir, '-o', self.file_llvmir_opt], [self.file_llvmir_opt])
 
-            await self.do_call(progress_bar.task, ['llc', self.file_llvmir_opt, '-O2', '--march=%s' % self.aie_target.lower(), '--function-sections', '--filetype=obj', '-o', self.file_obj])
+            await self.do_cached_call(progress_bar.task, ['llc', self.file_llvmir_opt, '-O2', '--march=%s' % self.aie_target.lower(), '--function-sections', '--filetype=obj', '-o', self.file_obj], [self.file_obj])
 
         progress_bar.update(progress_bar.task,advance=0,visible=False)
         progress_bar.task_completed = progress_bar.add_task("[green] AIE Compilation:", total=len(cores)+1, command="%d Workers" % nworkers)
 
+        if(not opts.unified and opts.inprocess and opts.execute):
+          self.lower_cores_inprocess(cores)
+          if(opts.dedupe_cores):
+            self.find_identical_cores(cores)
+
         processes = [self.process_host_cgen()]
         await asyncio.gather(*processes) # ensure that process_host_cgen finishes before running gen_sim
         processes = []
@@ -729,6 +1042,8 @@ aiesimulator --pkg-dir=${prj_name}/sim --dump-vcd ${vcd_filename}
       for i in range(50):
         if(i < len(sortedruntimes)):
           print("%.4f sec: %s" % (sortedruntimes[i][1], sortedruntimes[i][0]))
+      if(self.opts.cache_dir):
+        print("Artifact cache: %d hits, %d misses" % (self.cache_hits, self.cache_misses))
 
 def run(mlir_module, args=None):
     global opts
@@ -0,0 +1,88 @@
+//===- ipu_instructions.h ---------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+//
+// Zero-copy access to the binary instruction files produced by
+// aie-translate --aie-ipu-instgen-binary. The file is memory mapped and the
+// instruction words are handed out in place, so loading a sequence costs a
+// single mmap and a header check. The words are little endian, matching the
+// hosts the IPU runs on.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef AIE_IPU_INSTRUCTIONS_H
+#define AIE_IPU_INSTRUCTIONS_H
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define MLIR_AIE_IPU_INSTR_MAGIC 0x55504941 // "AIPU"
+#define MLIR_AIE_IPU_INSTR_VERSION 1
+#define MLIR_AIE_IPU_INSTR_NUM_OPCODES 8
+
+typedef struct {
+  void *map;
+  size_t map_size;
+  // The instruction words, ready to be copied into the instruction buffer.
+  const uint32_t *instr;
+  uint32_t instr_count;
+  // Number of operations of each opcode in the sequence.
+  const uint32_t *opcode_counts;
+} mlir_aie_ipu_instr_t;
+
+// Map the instruction file at path. Returns 0 on success and -1 if the file
+// cannot be mapped or is not a well-formed instruction file.
+static inline int mlir_aie_ipu_instr_open(const char *path,
+                                          mlir_aie_ipu_instr_t *seq) {
+  seq->map = NULL;
+  seq->map_size = 0;
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return -1;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < 16) {
+    close(fd);
+    return -1;
+  }
+  void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+    return -1;
+
+  const uint32_t *words = (const uint32_t *)map;
+  size_t num_words = st.st_size / sizeof(uint32_t);
+  uint32_t header_words = words[2];
+  if (words[0] != MLIR_AIE_IPU_INSTR_MAGIC ||
+      words[1] != MLIR_AIE_IPU_INSTR_VERSION ||
+      header_words != 4 + MLIR_AIE_IPU_INSTR_NUM_OPCODES ||
+      header_words > num_words || words[3] != num_words - header_words) {
+    munmap(map, st.st_size);
+    return -1;
+  }
+
+  seq->map = map;
+  seq->map_size = st.st_size;
+  seq->instr = words + header_words;
+  seq->instr_count = words[3];
+  seq->opcode_counts = words + 4;
+  return 0;
+}
+
+static inline void mlir_aie_ipu_instr_close(mlir_aie_ipu_instr_t *seq) {
+  if (seq->map)
+    munmap(seq->map, seq->map_size);
+  seq->map = NULL;
+  seq->map_size = 0;
+}
+
+#endif
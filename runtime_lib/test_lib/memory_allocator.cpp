@@ -12,34 +12,61 @@
 #include "memory_allocator.h"
 #include "xioutils.h"
 #include <assert.h>
+#include <cstdlib>
 #include <iostream>
 
+// The physical space in the SystemC DDR memory controller is not reclaimed.
+static void release_block(aie_libxaie_ctx_t *_xaie, ext_mem_model_t &handle) {
+  std::free(handle.virtualAddr);
+}
+
 int *mlir_aie_mem_alloc(aie_libxaie_ctx_t *_xaie, ext_mem_model_t &handle,
                         int size) {
-  int size_bytes = size * sizeof(int);
-  handle.virtualAddr = std::malloc(size_bytes);
-  if (handle.virtualAddr) {
-    handle.size = size_bytes;
-    // assign physical space in SystemC DDR memory controller
-    handle.physicalAddr = nextAlignedAddr;
-    // adjust nextAlignedAddr to the next 128-bit aligned address
-    nextAlignedAddr = nextAlignedAddr + size_bytes;
-    uint64_t gapToAligned = nextAlignedAddr % 16; // 16byte (128bit)
-    if (gapToAligned > 0)
-      nextAlignedAddr += (16 - gapToAligned);
-  } else {
-    printf("ExtMemModel: Failed to allocate %d memory.\n", size_bytes);
-  }
+  ext_mem_pool_t &pool = _xaie->pool;
+  size_t size_bytes = size * sizeof(int);
+  size_t allocated_size = ext_mem_round_to_pages(size_bytes);
 
-  _xaie->allocations.push_back(handle);
+  if (!ext_mem_reuse_block(pool, allocated_size, handle)) {
+    handle.virtualAddr = std::aligned_alloc(EXT_MEM_PAGE_SIZE, allocated_size);
+    if (!handle.virtualAddr) {
+      printf("ExtMemModel: Failed to allocate %zu memory.\n", size_bytes);
+      return nullptr;
+    }
+    // assign physical space in SystemC DDR memory controller.  Allocations
+    // are whole pages, so this stays page aligned.
+    handle.physicalAddr = pool.nextPhysicalAddr;
+    handle.allocatedSize = allocated_size;
+    pool.nextPhysicalAddr += allocated_size;
+    pool.releaseBlock = release_block;
+  }
+  handle.size = size_bytes;
+  pool.live[(uintptr_t)handle.virtualAddr] = handle;
 
-  std::cout << "ExtMemModel constructor: " << _xaie << " virtual address "
-            << std::hex << handle.virtualAddr << ", physical address "
-            << handle.physicalAddr << ", size " << std::dec << handle.size
-            << std::endl;
+  if (pool.logging)
+    std::cout << "ExtMemModel constructor: " << _xaie << " virtual address "
+              << std::hex << handle.virtualAddr << ", physical address "
+              << handle.physicalAddr << ", size " << std::dec << handle.size
+              << std::endl;
   return (int *)handle.virtualAddr;
 }
 
+void mlir_aie_mem_free(aie_libxaie_ctx_t *_xaie, ext_mem_model_t &handle) {
+  ext_mem_pool_t &pool = _xaie->pool;
+  auto it = pool.live.find((uintptr_t)handle.virtualAddr);
+  if (it == pool.live.end()) {
+    printf("ERROR: freeing a buffer that is not allocated!\n");
+    assert(false);
+    return;
+  }
+  pool.freeBlocks.emplace(it->second.allocatedSize, it->second);
+  pool.live.erase(it);
+  handle.virtualAddr = nullptr;
+}
+
+void mlir_aie_set_mem_logging(aie_libxaie_ctx_t *_xaie, bool enable) {
+  _xaie->pool.logging = enable;
+}
+
 void mlir_aie_sync_mem_cpu(ext_mem_model_t &handle) {
   aiesim_ReadGM(handle.physicalAddr, handle.virtualAddr, handle.size);
 }
@@ -49,17 +76,28 @@ void mlir_aie_sync_mem_dev(ext_mem_model_t &handle) {
 }
 
 u64 mlir_aie_get_device_address(aie_libxaie_ctx_t *_xaie, void *VA) {
-  std::cout << "get_device_address: " << _xaie << " VA " << std::hex << VA
-            << std::dec << "\n";
-  for (auto i : _xaie->allocations) {
-    std::cout << "get_device_address: virtual address " << std::hex
-              << i.virtualAddr << ", physical address " << i.physicalAddr
-              << ", size " << std::dec << i.size << std::endl;
+  ext_mem_pool_t &pool = _xaie->pool;
+  if (pool.logging)
+    std::cout << "get_device_address: " << _xaie << " VA " << std::hex << VA
+              << std::dec << "\n";
 
-    if (i.virtualAddr == VA)
-      return i.physicalAddr;
+  // Find the last buffer starting at or before VA and check that VA is
+  // inside it.
+  uintptr_t addr = (uintptr_t)VA;
+  auto it = pool.live.upper_bound(addr);
+  if (it != pool.live.begin()) {
+    const ext_mem_model_t &buffer = (--it)->second;
+    uintptr_t offset = addr - it->first;
+    if (offset < buffer.size) {
+      if (pool.logging)
+        std::cout << "get_device_address: virtual address " << std::hex
+                  << buffer.virtualAddr << ", physical address "
+                  << buffer.physicalAddr << ", size " << std::dec
+                  << buffer.size << std::endl;
+      return buffer.physicalAddr + offset;
+    }
   }
   printf("ERROR: cannot get device address for allocation!\n");
   assert(false);
   return 0;
-}
\ No newline at end of file
+}
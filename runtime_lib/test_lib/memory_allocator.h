@@ -37,17 +37,27 @@ extern "C" {
 /// combinations are also possible, largely representing different tradeoffs
 /// between efficiency of host data access vs. efficiency of accelerator access.
 
-// static variable for tracking current DDR physical addr during AIESIM
-static uint16_t nextAlignedAddr;
-
 /// @brief Allocate a buffer in device memory
+/// The buffer is page aligned and is the smallest of the buffers previously
+/// released with mlir_aie_mem_free that is large enough, if there is one, so
+/// that host loops can recycle buffers without allocating new device memory
+/// every time.
 /// @param bufIdx The index of the buffer to allocate.
 /// @param size The number of 32-bit words to allocate
 /// @return A host-side pointer that can write into the given buffer.
-/// @todo This is at best a quick hack and should be replaced
 int *mlir_aie_mem_alloc(aie_libxaie_ctx_t *_xaie, ext_mem_model_t &handle,
                         int size);
 
+/// @brief Release a buffer allocated with mlir_aie_mem_alloc.
+/// The device memory is kept for reuse by later allocations and returned to
+/// the system by mlir_aie_deinit_libxaie.  The host-side pointer must not be
+/// used anymore.
+void mlir_aie_mem_free(aie_libxaie_ctx_t *_xaie, ext_mem_model_t &handle);
+
+/// @brief Enable or disable printing every allocation and every device
+/// address lookup.  Disabled by default.
+void mlir_aie_set_mem_logging(aie_libxaie_ctx_t *_xaie, bool enable);
+
 /// @brief Synchronize the buffer from the device to the host CPU.
 /// This is expected to be called after the device writes data into
 /// device memory, so that the data can be read by the CPU.  In
@@ -65,7 +75,8 @@ void mlir_aie_sync_mem_cpu(ext_mem_model_t &handle);
 void mlir_aie_sync_mem_dev(ext_mem_model_t &handle);
 
 /// @brief Return a device address corresponding to the given host address.
-/// @param host_address A host-side pointer returned from mlir_aie_mem_alloc
+/// @param host_address A host-side pointer returned from mlir_aie_mem_alloc,
+/// or a pointer into the buffer it refers to.
 u64 mlir_aie_get_device_address(aie_libxaie_ctx_t *_xaie, void *host_address);
 
 } // extern "C"
@@ -35,15 +35,15 @@
 #define XAIE_128BIT_ALIGN_MASK 0xFF
 
 /**
- * This is the memory function to allocate a memory
+ * This is the memory function to allocate new memory from ion
  *
  * @param	handle: Device Instance
- * @param	size: Size of the memory
+ * @param	size: Size of the memory in bytes
  *
  * @return	Pointer to the allocated memory instance.
  *******************************************************************************/
-int *mlir_aie_mem_alloc(struct aie_libxaie_ctx_t *ctx, ext_mem_model_t &handle,
-                        int size) {
+static int *ion_mem_alloc(struct aie_libxaie_ctx_t *ctx,
+                          ext_mem_model_t &handle, size_t size) {
   int RC;
   int Fd, Ret;
   uint32_t HeapNum;
@@ -119,6 +119,7 @@ int *mlir_aie_mem_alloc(struct aie_libxaie_ctx_t *ctx, ext_mem_model_t &handle,
   handle.fd = AllocArgs.fd;
   handle.virtualAddr = VAddr;
   handle.size = size;
+  handle.allocatedSize = size;
 
   // Map the memory
   if (XAie_MemAttach(&(ctx->DevInst), &(handle.MemInst), DevAddr, (u64)VAddr,
@@ -139,6 +140,72 @@ error_ion:
   return NULL;
 }
 
+/**
+ * This is the memory function to return memory allocated from ion to the
+ * system
+ *
+ * @param	handle: The memory to release
+ *******************************************************************************/
+static void ion_mem_release(struct aie_libxaie_ctx_t *ctx,
+                            ext_mem_model_t &handle) {
+  if (XAie_MemDetach(&(handle.MemInst)) != XAIE_OK)
+    XAIE_ERROR("dmabuf unmap failed\n");
+  munmap(handle.virtualAddr, handle.allocatedSize);
+  close(handle.fd);
+}
+
+/**
+ * This is the memory function to allocate a memory, reusing the smallest
+ * large enough memory released with mlir_aie_mem_free when possible
+ *
+ * @param	handle: Device Instance
+ * @param	size: Number of 32-bit words of the memory
+ *
+ * @return	Pointer to the allocated memory instance.
+ *******************************************************************************/
+int *mlir_aie_mem_alloc(struct aie_libxaie_ctx_t *ctx, ext_mem_model_t &handle,
+                        int size) {
+  ext_mem_pool_t &pool = ctx->pool;
+  size_t SizeBytes = size * sizeof(int);
+  size_t AllocatedSize = ext_mem_round_to_pages(SizeBytes);
+
+  if (!ext_mem_reuse_block(pool, AllocatedSize, handle)) {
+    if (!ion_mem_alloc(ctx, handle, AllocatedSize))
+      return NULL;
+    pool.releaseBlock = ion_mem_release;
+  }
+  handle.size = SizeBytes;
+  pool.live[(uintptr_t)handle.virtualAddr] = handle;
+
+  if (pool.logging)
+    printf("ExtMemModel: virtual address %p, size %zu, fd %d\n",
+           handle.virtualAddr, handle.size, handle.fd);
+  return (int *)handle.virtualAddr;
+}
+
+/**
+ * This is the memory function to release a memory for reuse by later
+ * allocations.  The memory stays mapped and attached to the device until
+ * mlir_aie_deinit_libxaie.
+ *
+ * @param	handle: The memory to release
+ *******************************************************************************/
+void mlir_aie_mem_free(struct aie_libxaie_ctx_t *ctx, ext_mem_model_t &handle) {
+  ext_mem_pool_t &pool = ctx->pool;
+  auto It = pool.live.find((uintptr_t)handle.virtualAddr);
+  if (It == pool.live.end()) {
+    XAIE_ERROR("Freeing memory that is not allocated\n");
+    return;
+  }
+  pool.freeBlocks.emplace(It->second.allocatedSize, It->second);
+  pool.live.erase(It);
+  handle.virtualAddr = NULL;
+}
+
+void mlir_aie_set_mem_logging(struct aie_libxaie_ctx_t *ctx, bool enable) {
+  ctx->pool.logging = enable;
+}
+
 /*****************************************************************************/
 /**
  *
@@ -11,22 +11,63 @@
 #ifndef AIE_TARGET_H
 #define AIE_TARGET_H
 
-#include <list>
+#include <map>
+#include <vector>
 #include <xaiengine.h>
 
+struct aie_libxaie_ctx_t;
+
 struct ext_mem_model_t {
   void *virtualAddr;
   uint64_t physicalAddr;
   size_t size;
+  size_t allocatedSize; // The size of the allocation, in whole pages
   int fd;               // The file descriptor used during allocation
   XAie_MemInst MemInst; // LibXAIE handle if necessary.  This should go away.
 };
 
+// Device memory is allocated in whole pages.  A buffer handed back with
+// mlir_aie_mem_free is reused by a later allocation it is the smallest freed
+// buffer large enough for.
+#define EXT_MEM_PAGE_SIZE 4096
+
+static inline size_t ext_mem_round_to_pages(size_t size) {
+  return (size + EXT_MEM_PAGE_SIZE - 1) / EXT_MEM_PAGE_SIZE * EXT_MEM_PAGE_SIZE;
+}
+
+struct ext_mem_pool_t {
+  // Freed buffers, by the size of their allocation, waiting to be reused.
+  std::multimap<size_t, ext_mem_model_t> freeBlocks;
+  // Live buffers, by host virtual address.  Some device memory allocators need
+  // this to keep track of VA->PA mappings, including for pointers into the
+  // middle of a buffer.
+  std::map<uintptr_t, ext_mem_model_t> live;
+  // The next unused device address, for allocators that model it themselves.
+  uint64_t nextPhysicalAddr = 0;
+  // Whether to print every allocation and address translation.
+  bool logging = false;
+  // Returns a freed buffer to the system, set by the allocator that fills the
+  // pool.  Called by mlir_aie_deinit_libxaie.
+  void (*releaseBlock)(aie_libxaie_ctx_t *, ext_mem_model_t &) = nullptr;
+};
+
+// Take the smallest freed buffer of at least allocatedSize bytes out of the
+// pool, if there is one.
+static inline bool ext_mem_reuse_block(ext_mem_pool_t &pool,
+                                       size_t allocatedSize,
+                                       ext_mem_model_t &handle) {
+  auto it = pool.freeBlocks.lower_bound(allocatedSize);
+  if (it == pool.freeBlocks.end())
+    return false;
+  handle = it->second;
+  pool.freeBlocks.erase(it);
+  return true;
+}
+
 struct aie_libxaie_ctx_t {
   XAie_Config AieConfigPtr;
   XAie_DevInst DevInst;
-  // Some device memory allocators need this to keep track of VA->PA mappings
-  std::list<ext_mem_model_t> allocations;
+  ext_mem_pool_t pool;
 };
 
 #endif
\ No newline at end of file
@@ -17,9 +17,11 @@
 #include "test_library.h"
 #include "math.h"
 #include <assert.h>
+#include <chrono>
 #include <fcntl.h>
 #include <stdio.h>
 #include <sys/mman.h>
+#include <vector>
 
 // extern "C" {
 // extern aie_libxaie_ctx_t *ctx /* = nullptr*/;
@@ -28,14 +30,21 @@
 // namespace aie_device {
 //}
 
-/// @brief  Release access to the libXAIE context.
+/// @brief  Release access to the libXAIE context, and the device memory freed
+/// with mlir_aie_mem_free and kept for reuse.
 /// @param ctx The context
 void mlir_aie_deinit_libxaie(aie_libxaie_ctx_t *ctx) {
+  ext_mem_pool_t &pool = ctx->pool;
+  if (pool.releaseBlock)
+    for (auto &it : pool.freeBlocks)
+      pool.releaseBlock(ctx, it.second);
+  pool.freeBlocks.clear();
+
   AieRC RC = XAie_Finish(&(ctx->DevInst));
   if (RC != XAIE_OK) {
     printf("Failed to finish tiles.\n");
   }
-  free(ctx);
+  delete ctx;
 }
 
 /// @brief Initialize the device represented by the context.
@@ -114,6 +123,95 @@ int mlir_aie_release_lock(aie_libxaie_ctx_t *ctx, int col, int row, int lockid,
                            XAie_LockInit(lockid, lockval), timeout) == XAIE_OK);
 }
 
+/// @brief Acquire a list of physical locks, possibly in different tiles.
+/// All the locks share a single timeout: locks that cannot be acquired
+/// immediately are retried in turn until every lock is held or the timeout
+/// expires, so that a lock that becomes available late does not hold up the
+/// others. If the timeout expires, the locks acquired so far are released
+/// again with the value they were acquired with, so that none is left held.
+/// @param ctx The context
+/// @param locks The locks to acquire, with the value to acquire each with.
+/// @param n The number of locks
+/// @param timeout The number of microseconds to wait for all the locks
+/// @return Return non-zero on success, i.e. every lock is held.
+int mlir_aie_acquire_locks(aie_libxaie_ctx_t *ctx, const mlir_aie_lock_t *locks,
+                           int n, int timeout) {
+  std::vector<bool> held(n, false);
+  int acquired = 0;
+  auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::microseconds(timeout);
+  while (true) {
+    for (int i = 0; i < n; i++) {
+      if (held[i])
+        continue;
+      // A timeout of zero never polls the lock in libXAIE, so try each lock
+      // for the shortest time possible instead.
+      if (XAie_LockAcquire(&(ctx->DevInst),
+                           XAie_TileLoc(locks[i].col, locks[i].row),
+                           XAie_LockInit(locks[i].lockid, locks[i].lockval),
+                           1) == XAIE_OK) {
+        held[i] = true;
+        acquired++;
+      }
+    }
+    if (acquired == n)
+      return 1;
+    if (std::chrono::steady_clock::now() >= deadline)
+      break;
+  }
+  // Releasing with the acquire value restores the value the lock had.
+  for (int i = 0; i < n; i++)
+    if (held[i])
+      XAie_LockRelease(&(ctx->DevInst),
+                       XAie_TileLoc(locks[i].col, locks[i].row),
+                       XAie_LockInit(locks[i].lockid, locks[i].lockval), 1);
+  return 0;
+}
+
+/// @brief Release a list of physical locks, possibly in different tiles.
+/// Every lock is released, even if releasing an earlier one timed out.
+/// @param ctx The context
+/// @param locks The locks to release, with the value to release each with.
+/// @param n The number of locks
+/// @param timeout The number of microseconds to wait for each lock
+/// @return Return non-zero on success, i.e. every lock was released.
+int mlir_aie_release_locks(aie_libxaie_ctx_t *ctx, const mlir_aie_lock_t *locks,
+                           int n, int timeout) {
+  bool released = true;
+  for (int i = 0; i < n; i++)
+    if (XAie_LockRelease(&(ctx->DevInst),
+                         XAie_TileLoc(locks[i].col, locks[i].row),
+                         XAie_LockInit(locks[i].lockid, locks[i].lockval),
+                         timeout) != XAIE_OK)
+      released = false;
+  return released;
+}
+
+/// @brief Wait for the first of several physical locks to become available.
+/// The locks are polled in turn with a single timeout and the first one that
+/// can be acquired is acquired; the others are left untouched.
+/// @param ctx The context
+/// @param locks The locks to poll, with the value to acquire each with.
+/// @param n The number of locks
+/// @param timeout The number of microseconds to wait
+/// @return The index of the acquired lock, or -1 if the operation timed out.
+int mlir_aie_acquire_any_lock(aie_libxaie_ctx_t *ctx,
+                              const mlir_aie_lock_t *locks, int n,
+                              int timeout) {
+  auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::microseconds(timeout);
+  while (true) {
+    for (int i = 0; i < n; i++)
+      if (XAie_LockAcquire(&(ctx->DevInst),
+                           XAie_TileLoc(locks[i].col, locks[i].row),
+                           XAie_LockInit(locks[i].lockid, locks[i].lockval),
+                           1) == XAIE_OK)
+        return i;
+    if (std::chrono::steady_clock::now() >= deadline)
+      return -1;
+  }
+}
+
 /// @brief Read the AIE configuration memory at the given physical address.
 u32 mlir_aie_read32(aie_libxaie_ctx_t *ctx, u64 addr) {
   u32 val;
@@ -146,6 +244,32 @@ void mlir_aie_data_mem_wr_word(aie_libxaie_ctx_t *ctx, int col, int row,
   XAie_DataMemWrWord(&(ctx->DevInst), XAie_TileLoc(col, row), addr, data);
 }
 
+/// @brief Read a contiguous range of words from the data memory of a
+/// particular tile memory with a single block transfer.
+/// @param addr The address of the first word in the given tile.
+/// @param data The buffer to read into, which holds at least count words.
+/// @param count The number of words to read
+/// @return Zero on success
+int mlir_aie_data_mem_rd_words(aie_libxaie_ctx_t *ctx, int col, int row,
+                               u64 addr, u32 *data, u32 count) {
+  AieRC RC = XAie_DataMemBlockRead(&(ctx->DevInst), XAie_TileLoc(col, row),
+                                   addr, data, count * sizeof(u32));
+  return RC == XAIE_OK ? 0 : -1;
+}
+
+/// @brief Write a contiguous range of words to the data memory of a
+/// particular tile memory with a single block transfer.
+/// @param addr The address of the first word in the given tile.
+/// @param data The words to write, which holds at least count words.
+/// @param count The number of words to write
+/// @return Zero on success
+int mlir_aie_data_mem_wr_words(aie_libxaie_ctx_t *ctx, int col, int row,
+                               u64 addr, const u32 *data, u32 count) {
+  AieRC RC = XAie_DataMemBlockWrite(&(ctx->DevInst), XAie_TileLoc(col, row),
+                                    addr, data, count * sizeof(u32));
+  return RC == XAIE_OK ? 0 : -1;
+}
+
 /// @brief Return the base address of the given tile.
 /// The configuration address space of most tiles is very similar,
 /// relative to this base address.
@@ -156,21 +280,20 @@ u64 mlir_aie_get_tile_addr(aie_libxaie_ctx_t *ctx, int col, int row) {
 /// @brief Dump the tile memory of the given tile
 /// Values that are zero are not shown
 void mlir_aie_dump_tile_memory(aie_libxaie_ctx_t *ctx, int col, int row) {
+  std::vector<u32> mem(0x2000);
+  if (mlir_aie_data_mem_rd_words(ctx, col, row, 0, mem.data(), mem.size()))
+    return;
   for (int i = 0; i < 0x2000; i++) {
-    uint32_t d;
-    AieRC rc = XAie_DataMemRdWord(&(ctx->DevInst), XAie_TileLoc(col, row),
-                                  (i * 4), &d);
-    if (rc == XAIE_OK && d != 0)
-      printf("Tile[%d][%d]: mem[%d] = %d\n", col, row, i, d);
+    if (mem[i] != 0)
+      printf("Tile[%d][%d]: mem[%d] = %d\n", col, row, i, mem[i]);
   }
 }
 
 /// @brief Fill the tile memory of the given tile with zeros.
 /// Values that are zero are not shown
 void mlir_aie_clear_tile_memory(aie_libxaie_ctx_t *ctx, int col, int row) {
-  for (int i = 0; i < 0x2000; i++) {
-    XAie_DataMemWrWord(&(ctx->DevInst), XAie_TileLoc(col, row), (i * 4), 0);
-  }
+  std::vector<u32> zeros(0x2000, 0);
+  mlir_aie_data_mem_wr_words(ctx, col, row, 0, zeros.data(), zeros.size());
 }
 
 static void print_aie1_dmachannel_status(aie_libxaie_ctx_t *ctx, int col,
@@ -120,12 +120,42 @@ int mlir_aie_acquire_lock(aie_libxaie_ctx_t *ctx, int col, int row, int lockid,
                           int lockval, int timeout);
 int mlir_aie_release_lock(aie_libxaie_ctx_t *ctx, int col, int row, int lockid,
                           int lockval, int timeout);
+
+/// A lock in a particular tile, together with the value to acquire or release
+/// it with, as used by the functions operating on several locks at once.
+struct mlir_aie_lock_t {
+  int col;
+  int row;
+  int lockid;
+  int lockval;
+};
+
+/// Acquire all the given locks, with a single timeout for all of them, or
+/// none of them. Like mlir_aie_acquire_lock, return non-zero on success.
+int mlir_aie_acquire_locks(aie_libxaie_ctx_t *ctx, const mlir_aie_lock_t *locks,
+                           int n, int timeout);
+/// Release all the given locks. Like mlir_aie_release_lock, return non-zero
+/// on success, i.e. if every lock was released.
+int mlir_aie_release_locks(aie_libxaie_ctx_t *ctx, const mlir_aie_lock_t *locks,
+                           int n, int timeout);
+/// Acquire whichever of the given locks becomes available first. Return the
+/// index of that lock in locks, or -1 if none could be acquired in time.
+int mlir_aie_acquire_any_lock(aie_libxaie_ctx_t *ctx,
+                              const mlir_aie_lock_t *locks, int n, int timeout);
 u32 mlir_aie_read32(aie_libxaie_ctx_t *ctx, u64 addr);
 void mlir_aie_write32(aie_libxaie_ctx_t *ctx, u64 addr, u32 val);
 u32 mlir_aie_data_mem_rd_word(aie_libxaie_ctx_t *ctx, int col, int row,
                               u64 addr);
 void mlir_aie_data_mem_wr_word(aie_libxaie_ctx_t *ctx, int col, int row,
                                u64 addr, u32 data);
+/// Read count consecutive words of data memory with a single block transfer.
+/// Return zero on success.
+int mlir_aie_data_mem_rd_words(aie_libxaie_ctx_t *ctx, int col, int row,
+                               u64 addr, u32 *data, u32 count);
+/// Write count consecutive words of data memory with a single block transfer.
+/// Return zero on success.
+int mlir_aie_data_mem_wr_words(aie_libxaie_ctx_t *ctx, int col, int row,
+                               u64 addr, const u32 *data, u32 count);
 
 u64 mlir_aie_get_tile_addr(aie_libxaie_ctx_t *ctx, int col, int row);
 
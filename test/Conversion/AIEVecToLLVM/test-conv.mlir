@@ -0,0 +1,49 @@
+// RUN: aie-opt %s -split-input-file -convert-aievec-to-llvm | FileCheck %s
+
+// The convolutions the MAC unit has a mode for are a single intrinsic call.
+
+// CHECK: llvm.func @llvm.aie2.i512.i512.acc1024.acc64.mul.conf(vector<32xi16>, vector<32xi16>, i32) -> vector<16xi64>
+// CHECK-LABEL: @mul_conv_i16
+// CHECK-SAME: %[[LHS:.*]]: vector<32xi16>, %[[RHS:.*]]: vector<32xi16>
+// CHECK: %[[CONF:.*]] = llvm.mlir.constant(858 : i32) : i32
+// CHECK: %[[RES:.*]] = llvm.call @llvm.aie2.i512.i512.acc1024.acc64.mul.conf(%[[LHS]], %[[RHS]], %[[CONF]])
+// CHECK: return %[[RES]] : vector<16xi64>
+func.func @mul_conv_i16(%lhs : vector<32xi16>, %rhs : vector<32xi16>) -> vector<16xi64> {
+  %0 = aievec.mul_conv %lhs, %rhs {M = 16 : i32, N = 4 : i32} : vector<32xi16>, vector<32xi16>, vector<16xi64>
+  return %0 : vector<16xi64>
+}
+
+// -----
+
+// CHECK: llvm.func @llvm.aie2.i512.i512.acc1024.acc32.mac.conf(vector<64xi8>, vector<64xi8>, vector<32xi32>, i32) -> vector<32xi32>
+// CHECK-LABEL: @fma_conv_i8
+// CHECK-SAME: %[[LHS:.*]]: vector<64xi8>, %[[RHS:.*]]: vector<64xi8>, %[[ACC:.*]]: vector<32xi32>
+// CHECK: %[[CONF:.*]] = llvm.mlir.constant(2888 : i32) : i32
+// CHECK: %[[RES:.*]] = llvm.call @llvm.aie2.i512.i512.acc1024.acc32.mac.conf(%[[LHS]], %[[RHS]], %[[ACC]], %[[CONF]])
+// CHECK: return %[[RES]] : vector<32xi32>
+func.func @fma_conv_i8(%lhs : vector<64xi8>, %rhs : vector<64xi8>, %acc : vector<32xi32>) -> vector<32xi32> {
+  %0 = aievec.fma_conv %lhs, %rhs, %acc {M = 32 : i32, N = 8 : i32, fmsub = true} : vector<64xi8>, vector<64xi8>, vector<32xi32>
+  return %0 : vector<32xi32>
+}
+
+// -----
+
+// Other convolutions multiply a window of the signal starting at each tap's
+// index.
+
+// CHECK-LABEL: @mul_conv_i32
+// CHECK-SAME: %[[LHS:.*]]: vector<16xi32>, %[[RHS:.*]]: vector<16xi32>
+// CHECK: %[[W0:.*]] = llvm.shufflevector %[[LHS]], %[[LHS]] [0, 1, 2, 3, 4, 5, 6, 7] : vector<16xi32>
+// CHECK: %[[T0:.*]] = llvm.shufflevector %[[RHS]], %[[RHS]] [0, 0, 0, 0, 0, 0, 0, 0] : vector<16xi32>
+// CHECK: %[[S0:.*]] = llvm.sext %[[W0]] : vector<8xi32> to vector<8xi64>
+// CHECK: %[[F0:.*]] = llvm.sext %[[T0]] : vector<8xi32> to vector<8xi64>
+// CHECK: %[[P0:.*]] = llvm.mul %[[S0]], %[[F0]] : vector<8xi64>
+// CHECK: %[[W1:.*]] = llvm.shufflevector %[[LHS]], %[[LHS]] [1, 2, 3, 4, 5, 6, 7, 8] : vector<16xi32>
+// CHECK: %[[T1:.*]] = llvm.shufflevector %[[RHS]], %[[RHS]] [1, 1, 1, 1, 1, 1, 1, 1] : vector<16xi32>
+// CHECK: %[[P1:.*]] = llvm.mul
+// CHECK: %[[A1:.*]] = llvm.add %[[P0]], %[[P1]] : vector<8xi64>
+// CHECK: return %[[A1]] : vector<8xi64>
+func.func @mul_conv_i32(%lhs : vector<16xi32>, %rhs : vector<16xi32>) -> vector<8xi64> {
+  %0 = aievec.mul_conv %lhs, %rhs {M = 8 : i32, N = 2 : i32} : vector<16xi32>, vector<16xi32>, vector<8xi64>
+  return %0 : vector<8xi64>
+}
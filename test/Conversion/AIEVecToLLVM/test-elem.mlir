@@ -0,0 +1,121 @@
+// RUN: aie-opt %s -split-input-file -convert-aievec-to-llvm | FileCheck %s
+
+// CHECK-LABEL: @add_elem_i32
+// CHECK-SAME: %[[LHS:.*]]: vector<16xi32>, %[[RHS:.*]]: vector<16xi32>
+// CHECK: %[[RES:.*]] = llvm.add %[[LHS]], %[[RHS]] : vector<16xi32>
+// CHECK: return %[[RES]] : vector<16xi32>
+func.func @add_elem_i32(%lhs : vector<16xi32>, %rhs : vector<16xi32>) -> vector<16xi32> {
+  %0 = aievec.add_elem %lhs, %rhs : vector<16xi32>
+  return %0 : vector<16xi32>
+}
+
+// CHECK: llvm.func @llvm.aie2.sub.accfloat(vector<8xi64>, vector<8xi64>, i32) -> vector<8xi64>
+// CHECK-LABEL: @sub_elem_f32
+// CHECK-SAME: %[[LHS:.*]]: vector<16xf32>, %[[RHS:.*]]: vector<16xf32>
+// CHECK-DAG: %[[L:.*]] = llvm.bitcast %[[LHS]] : vector<16xf32> to vector<8xi64>
+// CHECK-DAG: %[[R:.*]] = llvm.bitcast %[[RHS]] : vector<16xf32> to vector<8xi64>
+// CHECK-DAG: %[[CONF:.*]] = llvm.mlir.constant(0 : i32) : i32
+// CHECK: %[[RES:.*]] = llvm.call @llvm.aie2.sub.accfloat(%[[L]], %[[R]], %[[CONF]])
+// CHECK: %[[CAST:.*]] = llvm.bitcast %[[RES]] : vector<8xi64> to vector<16xf32>
+// CHECK: return %[[CAST]] : vector<16xf32>
+func.func @sub_elem_f32(%lhs : vector<16xf32>, %rhs : vector<16xf32>) -> vector<16xf32> {
+  %0 = aievec.sub_elem %lhs, %rhs : vector<16xf32>
+  return %0 : vector<16xf32>
+}
+
+// -----
+
+// CHECK-DAG: llvm.func @llvm.aie2.i512.i512.acc1024.acc32.mul.conf(vector<32xi16>, vector<32xi16>, i32) -> vector<32xi32>
+// CHECK-DAG: llvm.func @llvm.aie2.bf.mac16.conf(vector<32xbf16>, vector<32xbf16>, vector<16xf32>, i32) -> vector<16xf32>
+// CHECK-DAG: llvm.func @llvm.aie2.bf.mul16.conf(vector<32xbf16>, vector<32xbf16>, i32) -> vector<16xf32>
+
+// CHECK-LABEL: @mul_elem_i16
+// CHECK-SAME: %[[LHS:.*]]: vector<32xi16>, %[[RHS:.*]]: vector<32xi16>
+// CHECK: %[[CONF:.*]] = llvm.mlir.constant(824 : i32) : i32
+// CHECK: %[[RES:.*]] = llvm.call @llvm.aie2.i512.i512.acc1024.acc32.mul.conf(%[[LHS]], %[[RHS]], %[[CONF]])
+// CHECK: return %[[RES]] : vector<32xi32>
+func.func @mul_elem_i16(%lhs : vector<32xi16>, %rhs : vector<32xi16>) -> vector<32xi32> {
+  %0 = aievec.mul_elem %lhs, %rhs : vector<32xi16>, vector<32xi16>, vector<32xi32>
+  return %0 : vector<32xi32>
+}
+
+// CHECK-LABEL: @mac_elem_bf16
+// CHECK-SAME: %[[LHS:.*]]: vector<32xbf16>, %[[RHS:.*]]: vector<32xbf16>, %[[ACC:.*]]: vector<16xf32>
+// CHECK: %[[ZERO:.*]] = llvm.mlir.constant(dense<0.000000e+00> : vector<32xbf16>) : vector<32xbf16>
+// CHECK: %[[L:.*]] = llvm.shufflevector %[[LHS]], %[[ZERO]] [0, 32, 1, 33, 2, 34, 3, 35, 4, 36, 5, 37, 6, 38, 7, 39, 8, 40, 9, 41, 10, 42, 11, 43, 12, 44, 13, 45, 14, 46, 15, 47] : vector<32xbf16>
+// CHECK: %[[R:.*]] = llvm.shufflevector %[[RHS]], %[[ZERO]] [0, 32, 1, 33, 2, 34, 3, 35, 4, 36, 5, 37, 6, 38, 7, 39, 8, 40, 9, 41, 10, 42, 11, 43, 12, 44, 13, 45, 14, 46, 15, 47] : vector<32xbf16>
+// CHECK: %[[CONF:.*]] = llvm.mlir.constant(60 : i32) : i32
+// CHECK: %[[RES:.*]] = llvm.call @llvm.aie2.bf.mac16.conf(%[[L]], %[[R]], %[[ACC]], %[[CONF]])
+// CHECK: return %[[RES]] : vector<16xf32>
+func.func @mac_elem_bf16(%lhs : vector<32xbf16>, %rhs : vector<32xbf16>, %acc : vector<16xf32>) -> vector<16xf32> {
+  %0 = aievec.mac_elem %lhs, %rhs, %acc : vector<32xbf16>, vector<32xbf16>, vector<16xf32>
+  return %0 : vector<16xf32>
+}
+
+// CHECK-LABEL: @mul_elem_bf16
+// CHECK-SAME: %[[LHS:.*]]: vector<32xbf16>, %[[RHS:.*]]: vector<32xbf16>
+// CHECK: %[[L:.*]] = llvm.shufflevector %[[LHS]]
+// CHECK: %[[R:.*]] = llvm.shufflevector %[[RHS]]
+// CHECK: %[[CONF:.*]] = llvm.mlir.constant(60 : i32) : i32
+// CHECK: %[[RES:.*]] = llvm.call @llvm.aie2.bf.mul16.conf(%[[L]], %[[R]], %[[CONF]])
+// CHECK: return %[[RES]] : vector<16xf32>
+func.func @mul_elem_bf16(%lhs : vector<32xbf16>, %rhs : vector<32xbf16>) -> vector<16xf32> {
+  %0 = aievec.mul_elem %lhs, %rhs : vector<32xbf16>, vector<32xbf16>, vector<16xf32>
+  return %0 : vector<16xf32>
+}
+
+// -----
+
+// CHECK-LABEL: @neg_i16
+// CHECK-SAME: %[[SRC:.*]]: vector<32xi16>
+// CHECK: %[[ZERO:.*]] = llvm.mlir.constant(dense<0> : vector<32xi16>) : vector<32xi16>
+// CHECK: %[[RES:.*]] = llvm.sub %[[ZERO]], %[[SRC]] : vector<32xi16>
+// CHECK: return %[[RES]] : vector<32xi16>
+func.func @neg_i16(%src : vector<32xi16>) -> vector<32xi16> {
+  %0 = aievec.neg %src : vector<32xi16>
+  return %0 : vector<32xi16>
+}
+
+// CHECK-LABEL: @neg_bf16
+// CHECK-SAME: %[[SRC:.*]]: vector<32xbf16>
+// CHECK-DAG: %[[SIGN:.*]] = llvm.mlir.constant(dense<-32768> : vector<32xi16>) : vector<32xi16>
+// CHECK-DAG: %[[S:.*]] = llvm.bitcast %[[SRC]] : vector<32xbf16> to vector<32xi16>
+// CHECK: %[[XOR:.*]] = llvm.xor %[[S]], %[[SIGN]] : vector<32xi16>
+// CHECK: %[[RES:.*]] = llvm.bitcast %[[XOR]] : vector<32xi16> to vector<32xbf16>
+// CHECK: return %[[RES]] : vector<32xbf16>
+func.func @neg_bf16(%src : vector<32xbf16>) -> vector<32xbf16> {
+  %0 = aievec.neg %src : vector<32xbf16>
+  return %0 : vector<32xbf16>
+}
+
+// -----
+
+// CHECK-LABEL: @bitwise_i32
+// CHECK-SAME: %[[LHS:.*]]: vector<16xi32>, %[[RHS:.*]]: vector<16xi32>
+// CHECK: %[[AND:.*]] = llvm.and %[[LHS]], %[[RHS]] : vector<16xi32>
+// CHECK: %[[OR:.*]] = llvm.or %[[AND]], %[[RHS]] : vector<16xi32>
+// CHECK: %[[XOR:.*]] = llvm.xor %[[OR]], %[[LHS]] : vector<16xi32>
+// CHECK: %[[ONES:.*]] = llvm.mlir.constant(dense<-1> : vector<16xi32>) : vector<16xi32>
+// CHECK: %[[NOT:.*]] = llvm.xor %[[XOR]], %[[ONES]] : vector<16xi32>
+// CHECK: return %[[NOT]] : vector<16xi32>
+func.func @bitwise_i32(%lhs : vector<16xi32>, %rhs : vector<16xi32>) -> vector<16xi32> {
+  %0 = aievec.band %lhs, %rhs : vector<16xi32>, vector<16xi32>, vector<16xi32>
+  %1 = aievec.bor %0, %rhs : vector<16xi32>, vector<16xi32>, vector<16xi32>
+  %2 = aievec.bxor %1, %lhs : vector<16xi32>, vector<16xi32>, vector<16xi32>
+  %3 = aievec.bneg %2 : vector<16xi32>
+  return %3 : vector<16xi32>
+}
+
+// -----
+
+// CHECK: llvm.func @llvm.aie2.vextract.elem16.I512(vector<32xi16>, i32, i32) -> i32
+// CHECK-LABEL: @ext_elem_i16
+// CHECK-SAME: %[[SRC:.*]]: vector<32xi16>, %[[IDX:.*]]: i32
+// CHECK: %[[SIGN:.*]] = llvm.mlir.constant(1 : i32) : i32
+// CHECK: %[[ELEM:.*]] = llvm.call @llvm.aie2.vextract.elem16.I512(%[[SRC]], %[[IDX]], %[[SIGN]])
+// CHECK: %[[RES:.*]] = llvm.trunc %[[ELEM]] : i32 to i16
+// CHECK: return %[[RES]] : i16
+func.func @ext_elem_i16(%src : vector<32xi16>, %idx : i32) -> i16 {
+  %0 = aievec.ext_elem %src, %idx : vector<32xi16>, i32, i16
+  return %0 : i16
+}
@@ -0,0 +1,98 @@
+// RUN: aie-opt %s -split-input-file -convert-aievec-to-llvm | FileCheck %s
+
+// CHECK-DAG: llvm.func @llvm.aie2.vmax.lt8(vector<64xi8>, vector<64xi8>, i32) -> !llvm.struct<(vector<64xi8>, vector<2xi32>)>
+// CHECK-DAG: llvm.func @llvm.aie2.vmin.ge16(vector<32xi16>, vector<32xi16>, i32) -> !llvm.struct<(vector<32xi16>, i32)>
+// CHECK-DAG: llvm.func @llvm.aie2.vmax.ltbf16(vector<32xbf16>, vector<32xbf16>) -> !llvm.struct<(vector<32xbf16>, i32)>
+// CHECK-LABEL: @max_i8
+// CHECK-SAME: %[[LHS:.*]]: vector<64xi8>, %[[RHS:.*]]: vector<64xi8>
+// CHECK: %[[SIGN:.*]] = llvm.mlir.constant(1 : i32) : i32
+// CHECK: %[[RES:.*]] = llvm.call @llvm.aie2.vmax.lt8(%[[LHS]], %[[RHS]], %[[SIGN]])
+// CHECK: %[[MAX:.*]] = llvm.extractvalue %[[RES]][0]
+// CHECK: return %[[MAX]] : vector<64xi8>
+func.func @max_i8(%lhs : vector<64xi8>, %rhs : vector<64xi8>) -> vector<64xi8> {
+  %0 = aievec.max %lhs, %rhs : vector<64xi8>
+  return %0 : vector<64xi8>
+}
+
+// CHECK-LABEL: @min_i16
+// CHECK-SAME: %[[LHS:.*]]: vector<32xi16>, %[[RHS:.*]]: vector<32xi16>
+// CHECK: %[[SIGN:.*]] = llvm.mlir.constant(1 : i32) : i32
+// CHECK: %[[RES:.*]] = llvm.call @llvm.aie2.vmin.ge16(%[[LHS]], %[[RHS]], %[[SIGN]])
+// CHECK: %[[MIN:.*]] = llvm.extractvalue %[[RES]][0]
+// CHECK: return %[[MIN]] : vector<32xi16>
+func.func @min_i16(%lhs : vector<32xi16>, %rhs : vector<32xi16>) -> vector<32xi16> {
+  %0 = aievec.min %lhs, %rhs : vector<32xi16>
+  return %0 : vector<32xi16>
+}
+
+// CHECK-LABEL: @max_bf16
+// CHECK-SAME: %[[LHS:.*]]: vector<32xbf16>, %[[RHS:.*]]: vector<32xbf16>
+// CHECK: %[[RES:.*]] = llvm.call @llvm.aie2.vmax.ltbf16(%[[LHS]], %[[RHS]])
+// CHECK: %[[MAX:.*]] = llvm.extractvalue %[[RES]][0]
+// CHECK: return %[[MAX]] : vector<32xbf16>
+func.func @max_bf16(%lhs : vector<32xbf16>, %rhs : vector<32xbf16>) -> vector<32xbf16> {
+  %0 = aievec.max %lhs, %rhs : vector<32xbf16>
+  return %0 : vector<32xbf16>
+}
+
+// -----
+
+// CHECK-LABEL: @cmp_sgt_i32
+// CHECK-SAME: %[[LHS:.*]]: vector<16xi32>, %[[RHS:.*]]: vector<16xi32>
+// CHECK: %[[SIGN:.*]] = llvm.mlir.constant(1 : i32) : i32
+// CHECK: %[[RES:.*]] = llvm.call @llvm.aie2.vmax.lt32(%[[RHS]], %[[LHS]], %[[SIGN]])
+// CHECK: %[[MASK:.*]] = llvm.extractvalue %[[RES]][1]
+func.func @cmp_sgt_i32(%lhs : vector<16xi32>, %rhs : vector<16xi32>) -> ui32 {
+  %0 = aievec.cmp %lhs, %rhs {pred = "sgt"} : vector<16xi32>, vector<16xi32>, ui32
+  return %0 : ui32
+}
+
+// CHECK-LABEL: @cmp_uge_i8
+// CHECK-SAME: %[[LHS:.*]]: vector<64xi8>, %[[RHS:.*]]: vector<64xi8>
+// CHECK: %[[SIGN:.*]] = llvm.mlir.constant(0 : i32) : i32
+// CHECK: %[[RES:.*]] = llvm.call @llvm.aie2.vmin.ge8(%[[LHS]], %[[RHS]], %[[SIGN]])
+// CHECK: %[[MASK:.*]] = llvm.extractvalue %[[RES]][1]
+// CHECK: llvm.bitcast %[[MASK]] : vector<2xi32> to i64
+func.func @cmp_uge_i8(%lhs : vector<64xi8>, %rhs : vector<64xi8>) -> ui64 {
+  %0 = aievec.cmp %lhs, %rhs {pred = "uge"} : vector<64xi8>, vector<64xi8>, ui64
+  return %0 : ui64
+}
+
+// CHECK-LABEL: @cmp_eq_i16
+// CHECK: %[[GE0:.*]] = llvm.call @llvm.aie2.vmin.ge16
+// CHECK: %[[M0:.*]] = llvm.extractvalue %[[GE0]][1]
+// CHECK: %[[GE1:.*]] = llvm.call @llvm.aie2.vmin.ge16
+// CHECK: %[[M1:.*]] = llvm.extractvalue %[[GE1]][1]
+// CHECK: llvm.and %[[M0]], %[[M1]] : i32
+func.func @cmp_eq_i16(%lhs : vector<32xi16>, %rhs : vector<32xi16>) -> ui32 {
+  %0 = aievec.cmp %lhs, %rhs {pred = "eq"} : vector<32xi16>, vector<32xi16>, ui32
+  return %0 : ui32
+}
+
+// -----
+
+// CHECK: llvm.func @llvm.aie2.vsel8(vector<64xi8>, vector<64xi8>, vector<2xi32>) -> vector<64xi8>
+// CHECK-LABEL: @sel_i8
+// CHECK-SAME: %[[LHS:.*]]: vector<64xi8>, %[[RHS:.*]]: vector<64xi8>
+// CHECK: %[[MASK:.*]] = llvm.bitcast %{{.*}} : i64 to vector<2xi32>
+// CHECK: %[[RES:.*]] = llvm.call @llvm.aie2.vsel8(%[[LHS]], %[[RHS]], %[[MASK]])
+// CHECK: return %[[RES]] : vector<64xi8>
+func.func @sel_i8(%lhs : vector<64xi8>, %rhs : vector<64xi8>, %sel : ui64) -> vector<64xi8> {
+  %0 = aievec.sel %lhs, %rhs, %sel : vector<64xi8>, vector<64xi8>, ui64, vector<64xi8>
+  return %0 : vector<64xi8>
+}
+
+// -----
+
+// CHECK: llvm.func @llvm.aie2.vsel16(vector<32xi16>, vector<32xi16>, i32) -> vector<32xi16>
+// CHECK-LABEL: @sel_bf16
+// CHECK-SAME: %[[LHS:.*]]: vector<32xbf16>, %[[RHS:.*]]: vector<32xbf16>
+// CHECK-DAG: %[[L:.*]] = llvm.bitcast %[[LHS]] : vector<32xbf16> to vector<32xi16>
+// CHECK-DAG: %[[R:.*]] = llvm.bitcast %[[RHS]] : vector<32xbf16> to vector<32xi16>
+// CHECK: %[[RES:.*]] = llvm.call @llvm.aie2.vsel16(%[[L]], %[[R]], %{{.*}})
+// CHECK: %[[CAST:.*]] = llvm.bitcast %[[RES]] : vector<32xi16> to vector<32xbf16>
+// CHECK: return %[[CAST]] : vector<32xbf16>
+func.func @sel_bf16(%lhs : vector<32xbf16>, %rhs : vector<32xbf16>, %sel : ui32) -> vector<32xbf16> {
+  %0 = aievec.sel %lhs, %rhs, %sel : vector<32xbf16>, vector<32xbf16>, ui32, vector<32xbf16>
+  return %0 : vector<32xbf16>
+}
@@ -0,0 +1,31 @@
+// RUN: aie-opt %s -split-input-file -convert-aievec-to-llvm | FileCheck %s
+
+// CHECK: llvm.func @llvm.aie2.vshift.I512.I512(vector<16xi32>, vector<16xi32>, i32, i32) -> vector<16xi32>
+// CHECK-LABEL: @shift_i8
+// CHECK-SAME: %[[LHS:.*]]: vector<64xi8>, %[[RHS:.*]]: vector<64xi8>, %[[SHIFT:.*]]: i32
+// CHECK-DAG: %[[L:.*]] = llvm.bitcast %[[LHS]] : vector<64xi8> to vector<16xi32>
+// CHECK-DAG: %[[R:.*]] = llvm.bitcast %[[RHS]] : vector<64xi8> to vector<16xi32>
+// CHECK-DAG: %[[STEP:.*]] = llvm.mlir.constant(0 : i32) : i32
+// CHECK: %[[RES:.*]] = llvm.call @llvm.aie2.vshift.I512.I512(%[[L]], %[[R]], %[[STEP]], %[[SHIFT]])
+// CHECK: %[[CAST:.*]] = llvm.bitcast %[[RES]] : vector<16xi32> to vector<64xi8>
+// CHECK: return %[[CAST]] : vector<64xi8>
+func.func @shift_i8(%lhs : vector<64xi8>, %rhs : vector<64xi8>, %shift : i32) -> vector<64xi8> {
+  %0 = aievec.shift %lhs, %rhs, %shift {isAcc = false} : vector<64xi8>, vector<64xi8>, i32, vector<64xi8>
+  return %0 : vector<64xi8>
+}
+
+// -----
+
+// CHECK: llvm.func @llvm.aie2.vshuffle(vector<16xi32>, vector<16xi32>, i32) -> vector<16xi32>
+// CHECK-LABEL: @shuffle_i8
+// CHECK-SAME: %[[SRC:.*]]: vector<64xi8>
+// CHECK-DAG: %[[S:.*]] = llvm.bitcast %[[SRC]] : vector<64xi8> to vector<16xi32>
+// CHECK-DAG: %[[UNDEF:.*]] = llvm.mlir.undef : vector<16xi32>
+// CHECK-DAG: %[[MODE:.*]] = llvm.mlir.constant(0 : i32) : i32
+// CHECK: %[[RES:.*]] = llvm.call @llvm.aie2.vshuffle(%[[S]], %[[UNDEF]], %[[MODE]])
+// CHECK: %[[CAST:.*]] = llvm.bitcast %[[RES]] : vector<16xi32> to vector<64xi8>
+// CHECK: return %[[CAST]] : vector<64xi8>
+func.func @shuffle_i8(%src : vector<64xi8>) -> vector<64xi8> {
+  %0 = aievec.shuffle %src {mode = 0 : i32} : vector<64xi8>, vector<64xi8>
+  return %0 : vector<64xi8>
+}
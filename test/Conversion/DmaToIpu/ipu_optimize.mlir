@@ -0,0 +1,191 @@
+//===- ipu_optimize.mlir ---------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-ipu-optimize -split-input-file %s | FileCheck %s
+
+// CHECK-LABEL: func.func @sequence
+// CHECK-NEXT: AIEX.ipu.write32 {address = 258048 : ui32, column = 0 : i32, row = 2 : i32, value = 2 : ui32}
+// CHECK-NEXT: AIEX.ipu.writebd_shimtile
+// CHECK-SAME: bd_id = 0 : i32
+// CHECK-SAME: buffer_offset = 0 : i32
+// CHECK-NEXT: AIEX.ipu.write32 {address = 119300 : ui32, column = 0 : i32, row = 0 : i32, value = 2147483648 : ui32}
+// CHECK-NEXT: AIEX.ipu.sync {channel = 0 : i32, column = 0 : i32, column_num = 1 : i32, direction = 0 : i32, row = 0 : i32, row_num = 1 : i32}
+// CHECK-NEXT: AIEX.ipu.writebd_shimtile
+// CHECK-SAME: bd_id = 1 : i32
+// CHECK-SAME: buffer_offset = 0 : i32
+// CHECK-NEXT: AIEX.ipu.write32 {address = 119316 : ui32, column = 0 : i32, row = 0 : i32, value = 1 : ui32}
+// CHECK-NEXT: AIEX.ipu.writebd_shimtile
+// CHECK-SAME: bd_id = 0 : i32
+// CHECK-SAME: buffer_offset = 64 : i32
+// CHECK-NEXT: AIEX.ipu.write32 {address = 119316 : ui32, column = 0 : i32, row = 0 : i32, value = 1 : ui32}
+// CHECK-NEXT: return
+
+module {
+  AIE.device(ipu) {
+    func.func @sequence(%arg0: memref<16xi32>) {
+      // Overwritten before any sync, then rewritten with the same value.
+      AIEX.ipu.write32 { column = 0 : i32, row = 2 : i32, address = 258048 : ui32, value = 1 : ui32 }
+      AIEX.ipu.write32 { column = 0 : i32, row = 2 : i32, address = 258048 : ui32, value = 2 : ui32 }
+      AIEX.ipu.write32 { column = 0 : i32, row = 2 : i32, address = 258048 : ui32, value = 2 : ui32 }
+      AIEX.ipu.writebd_shimtile { bd_id = 0 : i32, buffer_length = 16 : i32, buffer_offset = 0 : i32, column = 0 : i32, column_num = 1 : i32, ddr_id = 0 : i32, d0_stepsize = 0 : i32, d0_wrap = 0 : i32, d1_stepsize = 0 : i32, d1_wrap = 0 : i32, d2_stepsize = 0 : i32, enable_packet = 0 : i32, iteration_current = 0 : i32, iteration_stepsize = 0 : i32, iteration_wrap = 0 : i32, lock_acq_enable = 0 : i32, lock_acq_id = 0 : i32, lock_acq_val = 0 : i32, lock_rel_id = 0 : i32, lock_rel_val = 0 : i32, next_bd = 0 : i32, out_of_order_id = 0 : i32, packet_id = 0 : i32, packet_type = 0 : i32, use_next_bd = 0 : i32, valid_bd = 1 : i32 }
+      AIEX.ipu.write32 { column = 0 : i32, row = 0 : i32, address = 119300 : ui32, value = 2147483648 : ui32 }
+      AIEX.ipu.sync { column = 0 : i32, row = 0 : i32, direction = 0 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      // No token was issued since the previous sync.
+      AIEX.ipu.sync { column = 0 : i32, row = 0 : i32, direction = 0 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      // BD 0 already holds this configuration.
+      AIEX.ipu.writebd_shimtile { bd_id = 0 : i32, buffer_length = 16 : i32, buffer_offset = 0 : i32, column = 0 : i32, column_num = 1 : i32, ddr_id = 0 : i32, d0_stepsize = 0 : i32, d0_wrap = 0 : i32, d1_stepsize = 0 : i32, d1_wrap = 0 : i32, d2_stepsize = 0 : i32, enable_packet = 0 : i32, iteration_current = 0 : i32, iteration_stepsize = 0 : i32, iteration_wrap = 0 : i32, lock_acq_enable = 0 : i32, lock_acq_id = 0 : i32, lock_acq_val = 0 : i32, lock_rel_id = 0 : i32, lock_rel_val = 0 : i32, next_bd = 0 : i32, out_of_order_id = 0 : i32, packet_id = 0 : i32, packet_type = 0 : i32, use_next_bd = 0 : i32, valid_bd = 1 : i32 }
+      // BD 0 holds this configuration too, but it is written again while the
+      // task may still be running, so the push keeps BD 1.
+      AIEX.ipu.writebd_shimtile { bd_id = 1 : i32, buffer_length = 16 : i32, buffer_offset = 0 : i32, column = 0 : i32, column_num = 1 : i32, ddr_id = 0 : i32, d0_stepsize = 0 : i32, d0_wrap = 0 : i32, d1_stepsize = 0 : i32, d1_wrap = 0 : i32, d2_stepsize = 0 : i32, enable_packet = 0 : i32, iteration_current = 0 : i32, iteration_stepsize = 0 : i32, iteration_wrap = 0 : i32, lock_acq_enable = 0 : i32, lock_acq_id = 0 : i32, lock_acq_val = 0 : i32, lock_rel_id = 0 : i32, lock_rel_val = 0 : i32, next_bd = 0 : i32, out_of_order_id = 0 : i32, packet_id = 0 : i32, packet_type = 0 : i32, use_next_bd = 0 : i32, valid_bd = 1 : i32 }
+      AIEX.ipu.write32 { column = 0 : i32, row = 0 : i32, address = 119316 : ui32, value = 1 : ui32 }
+      // BD 1 already holds its configuration for the next push.
+      AIEX.ipu.writebd_shimtile { bd_id = 0 : i32, buffer_length = 16 : i32, buffer_offset = 64 : i32, column = 0 : i32, column_num = 1 : i32, ddr_id = 0 : i32, d0_stepsize = 0 : i32, d0_wrap = 0 : i32, d1_stepsize = 0 : i32, d1_wrap = 0 : i32, d2_stepsize = 0 : i32, enable_packet = 0 : i32, iteration_current = 0 : i32, iteration_stepsize = 0 : i32, iteration_wrap = 0 : i32, lock_acq_enable = 0 : i32, lock_acq_id = 0 : i32, lock_acq_val = 0 : i32, lock_rel_id = 0 : i32, lock_rel_val = 0 : i32, next_bd = 0 : i32, out_of_order_id = 0 : i32, packet_id = 0 : i32, packet_type = 0 : i32, use_next_bd = 0 : i32, valid_bd = 1 : i32 }
+      AIEX.ipu.write32 { column = 0 : i32, row = 0 : i32, address = 119316 : ui32, value = 1 : ui32 }
+      return
+    }
+  }
+}
+
+// -----
+
+// Locks, queues and memory are changed by the hardware, so writing the same
+// value again is not redundant. Configuration registers are known again only
+// until the next push.
+
+// CHECK-LABEL: func.func @hardware_registers
+// CHECK-NEXT: AIEX.ipu.write32 {address = 126976 : ui32, column = 0 : i32, row = 2 : i32, value = 1 : ui32}
+// CHECK-NEXT: AIEX.ipu.write32 {address = 126976 : ui32, column = 0 : i32, row = 2 : i32, value = 1 : ui32}
+// CHECK-NEXT: AIEX.ipu.write32 {address = 258048 : ui32, column = 0 : i32, row = 2 : i32, value = 3 : ui32}
+// CHECK-NEXT: AIEX.ipu.write32 {address = 119316 : ui32, column = 0 : i32, row = 0 : i32, value = 0 : ui32}
+// CHECK-NEXT: AIEX.ipu.write32 {address = 258048 : ui32, column = 0 : i32, row = 2 : i32, value = 3 : ui32}
+// CHECK-NEXT: return
+
+module {
+  AIE.device(ipu) {
+    func.func @hardware_registers() {
+      AIEX.ipu.write32 { column = 0 : i32, row = 2 : i32, address = 126976 : ui32, value = 1 : ui32 }
+      AIEX.ipu.write32 { column = 0 : i32, row = 2 : i32, address = 126976 : ui32, value = 1 : ui32 }
+      AIEX.ipu.write32 { column = 0 : i32, row = 2 : i32, address = 258048 : ui32, value = 3 : ui32 }
+      AIEX.ipu.write32 { column = 0 : i32, row = 0 : i32, address = 119316 : ui32, value = 0 : ui32 }
+      AIEX.ipu.write32 { column = 0 : i32, row = 2 : i32, address = 258048 : ui32, value = 3 : ui32 }
+      return
+    }
+  }
+}
+
+// -----
+
+// A deferred BD write is emitted before an op the pass does not know, which
+// may push the BD.
+
+// CHECK-LABEL: func.func @unknown_op
+// CHECK-NEXT: AIEX.ipu.writebd_shimtile
+// CHECK-SAME: bd_id = 0 : i32
+// CHECK-NEXT: AIEX.ipu.writebd_shimtile
+// CHECK-SAME: bd_id = 1 : i32
+// CHECK-NEXT: call @external()
+// CHECK-NEXT: AIEX.ipu.write32 {address = 119316 : ui32, column = 0 : i32, row = 0 : i32, value = 1 : ui32}
+// CHECK-NEXT: return
+
+module {
+  AIE.device(ipu) {
+    func.func private @external()
+    func.func @unknown_op() {
+      AIEX.ipu.writebd_shimtile { bd_id = 0 : i32, buffer_length = 16 : i32, buffer_offset = 0 : i32, column = 0 : i32, column_num = 1 : i32, ddr_id = 0 : i32, d0_stepsize = 0 : i32, d0_wrap = 0 : i32, d1_stepsize = 0 : i32, d1_wrap = 0 : i32, d2_stepsize = 0 : i32, enable_packet = 0 : i32, iteration_current = 0 : i32, iteration_stepsize = 0 : i32, iteration_wrap = 0 : i32, lock_acq_enable = 0 : i32, lock_acq_id = 0 : i32, lock_acq_val = 0 : i32, lock_rel_id = 0 : i32, lock_rel_val = 0 : i32, next_bd = 0 : i32, out_of_order_id = 0 : i32, packet_id = 0 : i32, packet_type = 0 : i32, use_next_bd = 0 : i32, valid_bd = 1 : i32 }
+      AIEX.ipu.writebd_shimtile { bd_id = 1 : i32, buffer_length = 16 : i32, buffer_offset = 0 : i32, column = 0 : i32, column_num = 1 : i32, ddr_id = 0 : i32, d0_stepsize = 0 : i32, d0_wrap = 0 : i32, d1_stepsize = 0 : i32, d1_wrap = 0 : i32, d2_stepsize = 0 : i32, enable_packet = 0 : i32, iteration_current = 0 : i32, iteration_stepsize = 0 : i32, iteration_wrap = 0 : i32, lock_acq_enable = 0 : i32, lock_acq_id = 0 : i32, lock_acq_val = 0 : i32, lock_rel_id = 0 : i32, lock_rel_val = 0 : i32, next_bd = 0 : i32, out_of_order_id = 0 : i32, packet_id = 0 : i32, packet_type = 0 : i32, use_next_bd = 0 : i32, valid_bd = 1 : i32 }
+      func.call @external() : () -> ()
+      AIEX.ipu.write32 { column = 0 : i32, row = 0 : i32, address = 119316 : ui32, value = 1 : ui32 }
+      return
+    }
+  }
+}
+
+// -----
+
+// A deferred BD write is emitted before a write32 that patches the BD, so
+// that it does not overwrite it.
+
+// CHECK-LABEL: func.func @patched_bd
+// CHECK-NEXT: AIEX.ipu.writebd_shimtile
+// CHECK-SAME: bd_id = 0 : i32
+// CHECK-NEXT: AIEX.ipu.writebd_shimtile
+// CHECK-SAME: bd_id = 1 : i32
+// CHECK-NEXT: AIEX.ipu.write32 {address = 118816 : ui32, column = 0 : i32, row = 0 : i32, value = 32 : ui32}
+// CHECK-NEXT: AIEX.ipu.write32 {address = 119316 : ui32, column = 0 : i32, row = 0 : i32, value = 1 : ui32}
+// CHECK-NEXT: return
+
+module {
+  AIE.device(ipu) {
+    func.func @patched_bd() {
+      AIEX.ipu.writebd_shimtile { bd_id = 0 : i32, buffer_length = 16 : i32, buffer_offset = 0 : i32, column = 0 : i32, column_num = 1 : i32, ddr_id = 0 : i32, d0_stepsize = 0 : i32, d0_wrap = 0 : i32, d1_stepsize = 0 : i32, d1_wrap = 0 : i32, d2_stepsize = 0 : i32, enable_packet = 0 : i32, iteration_current = 0 : i32, iteration_stepsize = 0 : i32, iteration_wrap = 0 : i32, lock_acq_enable = 0 : i32, lock_acq_id = 0 : i32, lock_acq_val = 0 : i32, lock_rel_id = 0 : i32, lock_rel_val = 0 : i32, next_bd = 0 : i32, out_of_order_id = 0 : i32, packet_id = 0 : i32, packet_type = 0 : i32, use_next_bd = 0 : i32, valid_bd = 1 : i32 }
+      AIEX.ipu.writebd_shimtile { bd_id = 1 : i32, buffer_length = 16 : i32, buffer_offset = 0 : i32, column = 0 : i32, column_num = 1 : i32, ddr_id = 0 : i32, d0_stepsize = 0 : i32, d0_wrap = 0 : i32, d1_stepsize = 0 : i32, d1_wrap = 0 : i32, d2_stepsize = 0 : i32, enable_packet = 0 : i32, iteration_current = 0 : i32, iteration_stepsize = 0 : i32, iteration_wrap = 0 : i32, lock_acq_enable = 0 : i32, lock_acq_id = 0 : i32, lock_acq_val = 0 : i32, lock_rel_id = 0 : i32, lock_rel_val = 0 : i32, next_bd = 0 : i32, out_of_order_id = 0 : i32, packet_id = 0 : i32, packet_type = 0 : i32, use_next_bd = 0 : i32, valid_bd = 1 : i32 }
+      AIEX.ipu.write32 { column = 0 : i32, row = 0 : i32, address = 118816 : ui32, value = 32 : ui32 }
+      AIEX.ipu.write32 { column = 0 : i32, row = 0 : i32, address = 119316 : ui32, value = 1 : ui32 }
+      return
+    }
+  }
+}
+
+// -----
+
+// A sync retires the task before BD 0 is written again, so the push of BD 1
+// can use BD 0 instead, and BD 1 is never written.
+
+// CHECK-LABEL: func.func @aliased_bd
+// CHECK-NEXT: AIEX.ipu.writebd_shimtile
+// CHECK-SAME: bd_id = 0 : i32
+// CHECK-SAME: buffer_offset = 0 : i32
+// CHECK-NEXT: AIEX.ipu.write32 {address = 119316 : ui32, column = 0 : i32, row = 0 : i32, value = 2147483648 : ui32}
+// CHECK-NEXT: AIEX.ipu.sync {channel = 0 : i32, column = 0 : i32, column_num = 1 : i32, direction = 1 : i32, row = 0 : i32, row_num = 1 : i32}
+// CHECK-NEXT: AIEX.ipu.write32 {address = 119316 : ui32, column = 0 : i32, row = 0 : i32, value = 2147483648 : ui32}
+// CHECK-NEXT: AIEX.ipu.sync {channel = 0 : i32, column = 0 : i32, column_num = 1 : i32, direction = 1 : i32, row = 0 : i32, row_num = 1 : i32}
+// CHECK-NEXT: AIEX.ipu.writebd_shimtile
+// CHECK-SAME: bd_id = 0 : i32
+// CHECK-SAME: buffer_offset = 64 : i32
+// CHECK-NEXT: return
+
+module {
+  AIE.device(ipu) {
+    func.func @aliased_bd() {
+      AIEX.ipu.writebd_shimtile { bd_id = 0 : i32, buffer_length = 16 : i32, buffer_offset = 0 : i32, column = 0 : i32, column_num = 1 : i32, ddr_id = 0 : i32, d0_stepsize = 0 : i32, d0_wrap = 0 : i32, d1_stepsize = 0 : i32, d1_wrap = 0 : i32, d2_stepsize = 0 : i32, enable_packet = 0 : i32, iteration_current = 0 : i32, iteration_stepsize = 0 : i32, iteration_wrap = 0 : i32, lock_acq_enable = 0 : i32, lock_acq_id = 0 : i32, lock_acq_val = 0 : i32, lock_rel_id = 0 : i32, lock_rel_val = 0 : i32, next_bd = 0 : i32, out_of_order_id = 0 : i32, packet_id = 0 : i32, packet_type = 0 : i32, use_next_bd = 0 : i32, valid_bd = 1 : i32 }
+      AIEX.ipu.write32 { column = 0 : i32, row = 0 : i32, address = 119316 : ui32, value = 2147483648 : ui32 }
+      AIEX.ipu.sync { column = 0 : i32, row = 0 : i32, direction = 1 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      AIEX.ipu.writebd_shimtile { bd_id = 1 : i32, buffer_length = 16 : i32, buffer_offset = 0 : i32, column = 0 : i32, column_num = 1 : i32, ddr_id = 0 : i32, d0_stepsize = 0 : i32, d0_wrap = 0 : i32, d1_stepsize = 0 : i32, d1_wrap = 0 : i32, d2_stepsize = 0 : i32, enable_packet = 0 : i32, iteration_current = 0 : i32, iteration_stepsize = 0 : i32, iteration_wrap = 0 : i32, lock_acq_enable = 0 : i32, lock_acq_id = 0 : i32, lock_acq_val = 0 : i32, lock_rel_id = 0 : i32, lock_rel_val = 0 : i32, next_bd = 0 : i32, out_of_order_id = 0 : i32, packet_id = 0 : i32, packet_type = 0 : i32, use_next_bd = 0 : i32, valid_bd = 1 : i32 }
+      AIEX.ipu.write32 { column = 0 : i32, row = 0 : i32, address = 119316 : ui32, value = 2147483649 : ui32 }
+      AIEX.ipu.sync { column = 0 : i32, row = 0 : i32, direction = 1 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      AIEX.ipu.writebd_shimtile { bd_id = 0 : i32, buffer_length = 16 : i32, buffer_offset = 64 : i32, column = 0 : i32, column_num = 1 : i32, ddr_id = 0 : i32, d0_stepsize = 0 : i32, d0_wrap = 0 : i32, d1_stepsize = 0 : i32, d1_wrap = 0 : i32, d2_stepsize = 0 : i32, enable_packet = 0 : i32, iteration_current = 0 : i32, iteration_stepsize = 0 : i32, iteration_wrap = 0 : i32, lock_acq_enable = 0 : i32, lock_acq_id = 0 : i32, lock_acq_val = 0 : i32, lock_rel_id = 0 : i32, lock_rel_val = 0 : i32, next_bd = 0 : i32, out_of_order_id = 0 : i32, packet_id = 0 : i32, packet_type = 0 : i32, use_next_bd = 0 : i32, valid_bd = 1 : i32 }
+      return
+    }
+  }
+}
+
+// -----
+
+// Pushes onto the queues of other tiles are not recognized, so syncs on their
+// channels are always kept.
+
+// CHECK-LABEL: func.func @memtile_sync
+// CHECK-NEXT: AIEX.ipu.write32 {address = 656948 : ui32, column = 0 : i32, row = 1 : i32, value = 2147483648 : ui32}
+// CHECK-NEXT: AIEX.ipu.sync {channel = 0 : i32, column = 0 : i32, column_num = 1 : i32, direction = 1 : i32, row = 1 : i32, row_num = 1 : i32}
+// CHECK-NEXT: AIEX.ipu.write32 {address = 656948 : ui32, column = 0 : i32, row = 1 : i32, value = 2147483648 : ui32}
+// CHECK-NEXT: AIEX.ipu.sync {channel = 0 : i32, column = 0 : i32, column_num = 1 : i32, direction = 1 : i32, row = 1 : i32, row_num = 1 : i32}
+// CHECK-NEXT: return
+
+module {
+  AIE.device(ipu) {
+    func.func @memtile_sync() {
+      AIEX.ipu.write32 { column = 0 : i32, row = 1 : i32, address = 656948 : ui32, value = 2147483648 : ui32 }
+      AIEX.ipu.sync { column = 0 : i32, row = 1 : i32, direction = 1 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      AIEX.ipu.write32 { column = 0 : i32, row = 1 : i32, address = 656948 : ui32, value = 2147483648 : ui32 }
+      AIEX.ipu.sync { column = 0 : i32, row = 1 : i32, direction = 1 : i32, channel = 0 : i32, column_num = 1 : i32, row_num = 1 : i32 }
+      return
+    }
+  }
+}
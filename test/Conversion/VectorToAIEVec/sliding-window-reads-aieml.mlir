@@ -0,0 +1,136 @@
+// RUN: aie-opt %s --canonicalize-vector-for-aievec="aie-target=aieml" -split-input-file | FileCheck %s
+
+#map_m2 = affine_map<(d0) -> (d0 - 2)>
+#map_m1 = affine_map<(d0) -> (d0 - 1)>
+#map_p1 = affine_map<(d0) -> (d0 + 1)>
+#map_p2 = affine_map<(d0) -> (d0 + 2)>
+
+// A 5-point row stencil: the window spans three vectors, two of which are
+// carried over from the previous iteration.
+
+// CHECK-LABEL: func @row_stencil
+//  CHECK-SAME: %[[IN:[A-Za-z0-9]+]]: memref<4x256xi32>
+//   CHECK-DAG:   %[[C0:.*]] = arith.constant 0 : index
+//   CHECK-DAG:   %[[C8:.*]] = arith.constant 8 : index
+//   CHECK-DAG:   %[[S24:.*]] = arith.constant 24 : i32
+//   CHECK-DAG:   %[[S28:.*]] = arith.constant 28 : i32
+//   CHECK-DAG:   %[[S4:.*]] = arith.constant 4 : i32
+//   CHECK-DAG:   %[[S8:.*]] = arith.constant 8 : i32
+//       CHECK:   affine.for %[[I:.*]] = 0 to 4 {
+//       CHECK:     %[[W0:.*]] = vector.transfer_read %[[IN]][%[[I]], %[[C0]]]
+//       CHECK:     %[[W1:.*]] = vector.transfer_read %[[IN]][%[[I]], %[[C8]]]
+//       CHECK:     affine.for %[[J:.*]] = 8 to 248 step 8 iter_args(%[[A:[A-Za-z0-9_]+]] = %[[W0]], %[[B:[A-Za-z0-9_]+]] = %[[W1]]) -> (vector<8xi32>, vector<8xi32>) {
+//       CHECK:       %[[N:.*]] = affine.apply #{{.*}}(%[[J]])
+//       CHECK:       %[[W2:.*]] = vector.transfer_read %[[IN]][%[[I]], %[[N]]]
+//   CHECK-NOT:       vector.transfer_read
+//       CHECK:       %[[R0:.*]] = aievec.shift %[[A]], %[[B]], %[[S24]] {isAcc = false} : vector<8xi32>, vector<8xi32>, i32, vector<8xi32>
+//       CHECK:       %[[R1:.*]] = aievec.shift %[[A]], %[[B]], %[[S28]] {isAcc = false} : vector<8xi32>, vector<8xi32>, i32, vector<8xi32>
+//       CHECK:       %[[R3:.*]] = aievec.shift %[[B]], %[[W2]], %[[S4]] {isAcc = false} : vector<8xi32>, vector<8xi32>, i32, vector<8xi32>
+//       CHECK:       %[[R4:.*]] = aievec.shift %[[B]], %[[W2]], %[[S8]] {isAcc = false} : vector<8xi32>, vector<8xi32>, i32, vector<8xi32>
+//       CHECK:       %[[S0:.*]] = arith.addi %[[R0]], %[[R1]] : vector<8xi32>
+//       CHECK:       %[[S1:.*]] = arith.addi %[[S0]], %[[B]] : vector<8xi32>
+//       CHECK:       %[[S2:.*]] = arith.addi %[[S1]], %[[R3]] : vector<8xi32>
+//       CHECK:       %[[S3:.*]] = arith.addi %[[S2]], %[[R4]] : vector<8xi32>
+//       CHECK:       vector.transfer_write %[[S3]]
+//       CHECK:       affine.yield %[[B]], %[[W2]] : vector<8xi32>, vector<8xi32>
+func.func @row_stencil(%in: memref<4x256xi32>, %out: memref<4x256xi32>) {
+  %c0_i32 = arith.constant 0 : i32
+  affine.for %i = 0 to 4 {
+    affine.for %j = 8 to 248 step 8 {
+      %jm2 = affine.apply #map_m2(%j)
+      %jm1 = affine.apply #map_m1(%j)
+      %jp1 = affine.apply #map_p1(%j)
+      %jp2 = affine.apply #map_p2(%j)
+      %0 = vector.transfer_read %in[%i, %jm2], %c0_i32 : memref<4x256xi32>, vector<8xi32>
+      %1 = vector.transfer_read %in[%i, %jm1], %c0_i32 : memref<4x256xi32>, vector<8xi32>
+      %2 = vector.transfer_read %in[%i, %j], %c0_i32 : memref<4x256xi32>, vector<8xi32>
+      %3 = vector.transfer_read %in[%i, %jp1], %c0_i32 : memref<4x256xi32>, vector<8xi32>
+      %4 = vector.transfer_read %in[%i, %jp2], %c0_i32 : memref<4x256xi32>, vector<8xi32>
+      %5 = arith.addi %0, %1 : vector<8xi32>
+      %6 = arith.addi %5, %2 : vector<8xi32>
+      %7 = arith.addi %6, %3 : vector<8xi32>
+      %8 = arith.addi %7, %4 : vector<8xi32>
+      vector.transfer_write %8, %out[%i, %j] : vector<8xi32>, memref<4x256xi32>
+    }
+  }
+  return
+}
+
+// -----
+
+#map_p1 = affine_map<(d0) -> (d0 + 1)>
+
+// Reads of different rows do not share a window, and each one carries its
+// own vector.
+
+// CHECK-LABEL: func @two_rows
+//  CHECK-SAME: %[[IN:[A-Za-z0-9]+]]: memref<2x64xi16>
+//   CHECK-DAG:   %[[C0:.*]] = arith.constant 0 : index
+//   CHECK-DAG:   %[[C1:.*]] = arith.constant 1 : index
+//   CHECK-DAG:   %[[S2:.*]] = arith.constant 2 : i32
+//   CHECK-DAG:   %[[W0:.*]] = vector.transfer_read %[[IN]][%[[C0]], %[[C0]]]
+//   CHECK-DAG:   %[[V0:.*]] = vector.transfer_read %[[IN]][%[[C1]], %[[C0]]]
+//       CHECK:   affine.for %[[J:.*]] = 0 to 48 step 16 iter_args(%{{.*}} = %[[W0]], %{{.*}} = %[[V0]]) -> (vector<16xi16>, vector<16xi16>) {
+//   CHECK-DAG:     aievec.shift {{.*}}, %[[S2]] {isAcc = false} : vector<16xi16>, vector<16xi16>, i32, vector<16xi16>
+//   CHECK-DAG:     aievec.shift {{.*}}, %[[S2]] {isAcc = false} : vector<16xi16>, vector<16xi16>, i32, vector<16xi16>
+//       CHECK:     affine.yield
+func.func @two_rows(%in: memref<2x64xi16>, %out: memref<64xi16>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c0_i16 = arith.constant 0 : i16
+  affine.for %j = 0 to 48 step 16 {
+    %jp1 = affine.apply #map_p1(%j)
+    %0 = vector.transfer_read %in[%c0, %jp1], %c0_i16 : memref<2x64xi16>, vector<16xi16>
+    %1 = vector.transfer_read %in[%c1, %jp1], %c0_i16 : memref<2x64xi16>, vector<16xi16>
+    %2 = arith.addi %0, %1 : vector<16xi16>
+    vector.transfer_write %2, %out[%j] : vector<16xi16>, memref<64xi16>
+  }
+  return
+}
+
+// -----
+
+#map_p1 = affine_map<(d0) -> (d0 + 1)>
+
+// Reads that feed a multiplication are left for the convolution folding.
+
+// CHECK-LABEL: func @conv_row
+//   CHECK-NOT:   iter_args
+//   CHECK-NOT:   aievec.shift
+//       CHECK:   vector.extract_strided_slice
+func.func @conv_row(%in: memref<256xi16>, %k: vector<16xi16>, %out: memref<256xi16>) {
+  %c0_i16 = arith.constant 0 : i16
+  affine.for %j = 0 to 240 step 16 {
+    %jp1 = affine.apply #map_p1(%j)
+    %0 = vector.transfer_read %in[%j], %c0_i16 : memref<256xi16>, vector<16xi16>
+    %1 = vector.transfer_read %in[%jp1], %c0_i16 : memref<256xi16>, vector<16xi16>
+    %2 = arith.muli %0, %k : vector<16xi16>
+    %3 = arith.muli %1, %k : vector<16xi16>
+    %4 = arith.addi %2, %3 : vector<16xi16>
+    vector.transfer_write %4, %out[%j] : vector<16xi16>, memref<256xi16>
+  }
+  return
+}
+
+// -----
+
+#map_p1 = affine_map<(d0) -> (d0 + 1)>
+
+// Data of an array written in the loop can't be carried over to the next
+// iteration.
+
+// CHECK-LABEL: func @in_place
+//   CHECK-NOT:   iter_args
+//   CHECK-NOT:   aievec.shift
+//       CHECK:   vector.extract_strided_slice
+func.func @in_place(%buf: memref<256xi32>) {
+  %c0_i32 = arith.constant 0 : i32
+  affine.for %j = 0 to 240 step 8 {
+    %jp1 = affine.apply #map_p1(%j)
+    %0 = vector.transfer_read %buf[%j], %c0_i32 : memref<256xi32>, vector<8xi32>
+    %1 = vector.transfer_read %buf[%jp1], %c0_i32 : memref<256xi32>, vector<8xi32>
+    %2 = arith.addi %0, %1 : vector<8xi32>
+    vector.transfer_write %2, %buf[%j] : vector<8xi32>, memref<256xi32>
+  }
+  return
+}
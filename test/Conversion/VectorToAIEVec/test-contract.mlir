@@ -0,0 +1,114 @@
+// RUN: aie-opt %s --convert-vector-to-aievec="aie-target=aieml" -split-input-file | FileCheck %s
+
+#map = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// CHECK-LABEL: func @contract_i8
+// CHECK-SAME: %[[A:[A-Za-z0-9]+]]: vector<4x8xi8>
+// CHECK-SAME: %[[B:[A-Za-z0-9]+]]: vector<8x8xi8>
+// CHECK-SAME: %[[C:[A-Za-z0-9]+]]: vector<4x8xi32>
+func.func @contract_i8(%A : vector<4x8xi8>, %B : vector<8x8xi8>,
+                       %C : vector<4x8xi32>) -> vector<4x8xi32> {
+  // CHECK-NOT: arith.extsi
+  // CHECK: %[[R:.*]] = aievec.matmul %[[A]], %[[B]], %[[C]] : vector<4x8xi8>, vector<8x8xi8> into vector<4x8xi32>
+  // CHECK: return %[[R]] : vector<4x8xi32>
+  %0 = arith.extsi %A : vector<4x8xi8> to vector<4x8xi32>
+  %1 = arith.extsi %B : vector<8x8xi8> to vector<8x8xi32>
+  %2 = vector.contract {indexing_maps = [#map, #map1, #map2],
+                        iterator_types = ["parallel", "parallel", "reduction"],
+                        kind = #vector.kind<add>} %0, %1, %C
+                        : vector<4x8xi32>, vector<8x8xi32> into vector<4x8xi32>
+  return %2 : vector<4x8xi32>
+}
+
+// -----
+
+#map = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// CHECK-LABEL: func @contract_i16_i64
+// CHECK-SAME: %[[A:[A-Za-z0-9]+]]: vector<4x4xi16>
+// CHECK-SAME: %[[B:[A-Za-z0-9]+]]: vector<4x4xi16>
+// CHECK-SAME: %[[C:[A-Za-z0-9]+]]: vector<4x4xi64>
+func.func @contract_i16_i64(%A : vector<4x4xi16>, %B : vector<4x4xi16>,
+                            %C : vector<4x4xi64>) -> vector<4x4xi64> {
+  // CHECK: %[[R:.*]] = aievec.matmul %[[A]], %[[B]], %[[C]] : vector<4x4xi16>, vector<4x4xi16> into vector<4x4xi64>
+  // CHECK: return %[[R]] : vector<4x4xi64>
+  %0 = vector.contract {indexing_maps = [#map, #map1, #map2],
+                        iterator_types = ["parallel", "parallel", "reduction"],
+                        kind = #vector.kind<add>} %A, %B, %C
+                        : vector<4x4xi16>, vector<4x4xi16> into vector<4x4xi64>
+  return %0 : vector<4x4xi64>
+}
+
+// -----
+
+#map = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// A 2x2 grid of 4x8x4 blocks accumulated over two steps of K: each
+// accumulator block is extracted once, goes through both steps, and is
+// inserted back once.
+
+// CHECK-LABEL: func @contract_bf16_blocked
+// CHECK-SAME: %[[A:[A-Za-z0-9]+]]: vector<8x16xbf16>
+// CHECK-SAME: %[[B:[A-Za-z0-9]+]]: vector<16x8xbf16>
+// CHECK-SAME: %[[C:[A-Za-z0-9]+]]: vector<8x8xf32>
+func.func @contract_bf16_blocked(%A : vector<8x16xbf16>, %B : vector<16x8xbf16>,
+                                 %C : vector<8x8xf32>) -> vector<8x8xf32> {
+  // CHECK-DAG: %[[C00:.*]] = vector.extract_strided_slice %[[C]] {offsets = [0, 0], sizes = [4, 4], strides = [1, 1]} : vector<8x8xf32> to vector<4x4xf32>
+  // CHECK-DAG: %[[C01:.*]] = vector.extract_strided_slice %[[C]] {offsets = [0, 4], sizes = [4, 4], strides = [1, 1]} : vector<8x8xf32> to vector<4x4xf32>
+  // CHECK-DAG: %[[C10:.*]] = vector.extract_strided_slice %[[C]] {offsets = [4, 0], sizes = [4, 4], strides = [1, 1]} : vector<8x8xf32> to vector<4x4xf32>
+  // CHECK-DAG: %[[C11:.*]] = vector.extract_strided_slice %[[C]] {offsets = [4, 4], sizes = [4, 4], strides = [1, 1]} : vector<8x8xf32> to vector<4x4xf32>
+  // CHECK-DAG: %[[A00:.*]] = vector.extract_strided_slice %[[A]] {offsets = [0, 0], sizes = [4, 8], strides = [1, 1]} : vector<8x16xbf16> to vector<4x8xbf16>
+  // CHECK-DAG: %[[A10:.*]] = vector.extract_strided_slice %[[A]] {offsets = [4, 0], sizes = [4, 8], strides = [1, 1]} : vector<8x16xbf16> to vector<4x8xbf16>
+  // CHECK-DAG: %[[B00:.*]] = vector.extract_strided_slice %[[B]] {offsets = [0, 0], sizes = [8, 4], strides = [1, 1]} : vector<16x8xbf16> to vector<8x4xbf16>
+  // CHECK-DAG: %[[B01:.*]] = vector.extract_strided_slice %[[B]] {offsets = [0, 4], sizes = [8, 4], strides = [1, 1]} : vector<16x8xbf16> to vector<8x4xbf16>
+  // CHECK: %[[M00:.*]] = aievec.matmul %[[A00]], %[[B00]], %[[C00]] : vector<4x8xbf16>, vector<8x4xbf16> into vector<4x4xf32>
+  // CHECK: %[[M01:.*]] = aievec.matmul %[[A00]], %[[B01]], %[[C01]] : vector<4x8xbf16>, vector<8x4xbf16> into vector<4x4xf32>
+  // CHECK: %[[M10:.*]] = aievec.matmul %[[A10]], %[[B00]], %[[C10]] : vector<4x8xbf16>, vector<8x4xbf16> into vector<4x4xf32>
+  // CHECK: %[[M11:.*]] = aievec.matmul %[[A10]], %[[B01]], %[[C11]] : vector<4x8xbf16>, vector<8x4xbf16> into vector<4x4xf32>
+  // CHECK-DAG: %[[A01:.*]] = vector.extract_strided_slice %[[A]] {offsets = [0, 8], sizes = [4, 8], strides = [1, 1]} : vector<8x16xbf16> to vector<4x8xbf16>
+  // CHECK-DAG: %[[A11:.*]] = vector.extract_strided_slice %[[A]] {offsets = [4, 8], sizes = [4, 8], strides = [1, 1]} : vector<8x16xbf16> to vector<4x8xbf16>
+  // CHECK-DAG: %[[B10:.*]] = vector.extract_strided_slice %[[B]] {offsets = [8, 0], sizes = [8, 4], strides = [1, 1]} : vector<16x8xbf16> to vector<8x4xbf16>
+  // CHECK-DAG: %[[B11:.*]] = vector.extract_strided_slice %[[B]] {offsets = [8, 4], sizes = [8, 4], strides = [1, 1]} : vector<16x8xbf16> to vector<8x4xbf16>
+  // CHECK: %[[N00:.*]] = aievec.matmul %[[A01]], %[[B10]], %[[M00]] : vector<4x8xbf16>, vector<8x4xbf16> into vector<4x4xf32>
+  // CHECK: %[[N01:.*]] = aievec.matmul %[[A01]], %[[B11]], %[[M01]] : vector<4x8xbf16>, vector<8x4xbf16> into vector<4x4xf32>
+  // CHECK: %[[N10:.*]] = aievec.matmul %[[A11]], %[[B10]], %[[M10]] : vector<4x8xbf16>, vector<8x4xbf16> into vector<4x4xf32>
+  // CHECK: %[[N11:.*]] = aievec.matmul %[[A11]], %[[B11]], %[[M11]] : vector<4x8xbf16>, vector<8x4xbf16> into vector<4x4xf32>
+  // CHECK: %[[R0:.*]] = vector.insert_strided_slice %[[N00]], %[[C]] {offsets = [0, 0], strides = [1, 1]} : vector<4x4xf32> into vector<8x8xf32>
+  // CHECK: %[[R1:.*]] = vector.insert_strided_slice %[[N01]], %[[R0]] {offsets = [0, 4], strides = [1, 1]} : vector<4x4xf32> into vector<8x8xf32>
+  // CHECK: %[[R2:.*]] = vector.insert_strided_slice %[[N10]], %[[R1]] {offsets = [4, 0], strides = [1, 1]} : vector<4x4xf32> into vector<8x8xf32>
+  // CHECK: %[[R3:.*]] = vector.insert_strided_slice %[[N11]], %[[R2]] {offsets = [4, 4], strides = [1, 1]} : vector<4x4xf32> into vector<8x8xf32>
+  // CHECK: return %[[R3]] : vector<8x8xf32>
+  %0 = arith.extf %A : vector<8x16xbf16> to vector<8x16xf32>
+  %1 = arith.extf %B : vector<16x8xbf16> to vector<16x8xf32>
+  %2 = vector.contract {indexing_maps = [#map, #map1, #map2],
+                        iterator_types = ["parallel", "parallel", "reduction"],
+                        kind = #vector.kind<add>} %0, %1, %C
+                        : vector<8x16xf32>, vector<16x8xf32> into vector<8x8xf32>
+  return %2 : vector<8x8xf32>
+}
+
+// -----
+
+#map = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d1, d2)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// A transposed rhs has no native matmul and is left alone.
+
+// CHECK-LABEL: func @contract_transposed_rhs
+// CHECK-NOT: aievec.matmul
+// CHECK: vector.contract
+func.func @contract_transposed_rhs(%A : vector<4x8xi8>, %B : vector<8x8xi8>,
+                                   %C : vector<4x8xi32>) -> vector<4x8xi32> {
+  %0 = vector.contract {indexing_maps = [#map, #map1, #map2],
+                        iterator_types = ["parallel", "parallel", "reduction"],
+                        kind = #vector.kind<add>} %A, %B, %C
+                        : vector<4x8xi8>, vector<8x8xi8> into vector<4x8xi32>
+  return %0 : vector<4x8xi32>
+}
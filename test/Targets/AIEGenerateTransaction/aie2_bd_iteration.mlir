@@ -0,0 +1,48 @@
+//===- aie2_bd_iteration.mlir ----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-generate-transaction-text %s | FileCheck %s
+
+// The BD chains to itself and alternates between the ping and the pong
+// buffer, 256 words apart.
+
+// CHECK: // 5 records, 20 words
+// CHECK-NEXT: WRITE 0x0E31F030 0x00000001
+// CHECK-NEXT: WRITE 0x0E31D000 0x00720100 0x00000000 0x00000000 0x00000000 0x000020FF 0x06049FE3
+// CHECK-NEXT: WRITE 0x0E31DE04 0x00000000
+// CHECK-NEXT: WRITE 0x0E33F038 0x80000001
+// CHECK-NEXT: WRITE 0x0E33F104 0x80000000
+
+module @aie_module  {
+  AIE.device(xcve2802) {
+    %t73 = AIE.tile(7, 3)
+
+    %buf_a_ping = AIE.buffer(%t73) {address = 1824 : i32, sym_name = "a_buff_0" } : memref<256xi32>
+    %buf_a_pong = AIE.buffer(%t73) {address = 2848 : i32, sym_name = "a_buff_1" } : memref<256xi32>
+
+    %lock_a_write = AIE.lock(%t73, 3) { init = 1 : i32 }
+    %lock_a_read = AIE.lock(%t73, 4)
+
+    %m73 = AIE.mem(%t73) {
+        %srcDma = AIE.dmaStart("S2MM", 0, ^bd0, ^end)
+      ^bd0:
+        AIE.useLock(%lock_a_write, AcquireGreaterEqual, 1)
+        AIE.dmaBd(<%buf_a_ping : memref<256xi32>, 0, 256>, 0) {iteration = #AIE.DimTuple<2, 256>}
+        AIE.useLock(%lock_a_read, Release, 1)
+        AIE.nextBd ^bd0
+      ^end:
+        AIE.end
+    }
+
+    %s73 = AIE.switchbox(%t73) {
+      AIE.connect<DMA : 0, North : 1>
+    }
+ }
+}
@@ -0,0 +1,34 @@
+//===- aie2_memTileDMA.mlir ------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-translate --aie-generate-transaction-text %s | FileCheck %s
+
+// Memtile locks are reset whatever their initial value, and a channel with no
+// BDs is not started.
+
+// CHECK: // 2 records, 6 words
+// CHECK-NEXT: WRITE 0x041C0000 0x00000000
+// CHECK-NEXT: WRITE 0x041C0010 0x00000002
+// CHECK-NOT: WRITE
+
+module @aie_module  {
+  AIE.device(xcve2302) {
+    %t21 = AIE.tile(2, 1)
+
+    %lock_w = AIE.lock(%t21, 0)
+    %lock_r = AIE.lock(%t21, 1) { init = 2 : i32 }
+
+    %m21 = AIE.memTileDMA(%t21) {
+        %srcDma = AIE.dmaStart(S2MM, 0, ^end, ^end)
+      ^end:
+        AIE.end
+    }
+ }
+}
@@ -9,6 +9,12 @@
 //===----------------------------------------------------------------------===//
 
 // RUN: aie-translate --aie-ipu-instgen %s | FileCheck %s
+// RUN: aie-translate --aie-ipu-instgen-binary %s | od -An -v -tx4 | FileCheck %s --check-prefix=BIN
+
+// BIN: 55504941 00000001 0000000c 00000020
+// BIN-NEXT: 00000000 00000000 00000001 00000001
+// BIN-NEXT: 00000000 00000000 00000001 00000000
+// BIN-NEXT: 00000011 01000405 01000100 0b590100
 module {
   AIE.device(ipu) {
     func.func @test0(%arg0: memref<16xf32>, %arg1: memref<16xf32>) {
@@ -0,0 +1,42 @@
+//===- best_fit.mlir -------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-assign-buffer-addresses="alloc-scheme=best-fit" %s | FileCheck %s
+
+// The pong buffer goes to the next of the eight 4KB banks, x and y are never
+// live at the same time and share the gap between ping and pong, v1 is aligned
+// for vector access and s fills the gap left below it.
+// CHECK: AIE.buffer({{.*}}) {address = 1024 : i32, sym_name = "of_buff_0"} : memref<512xi32>
+// CHECK: AIE.buffer({{.*}}) {address = 4096 : i32, sym_name = "of_buff_1"} : memref<512xi32>
+// CHECK: AIE.buffer({{.*}}) {address = 3072 : i32, sym_name = "x"} : memref<256xi32>
+// CHECK: AIE.buffer({{.*}}) {address = 3072 : i32, sym_name = "y"} : memref<256xi32>
+// CHECK: AIE.buffer({{.*}}) {address = 6144 : i32, sym_name = "v0"} : memref<9xi32>
+// CHECK: AIE.buffer({{.*}}) {address = 6208 : i32, sym_name = "v1"} : memref<9xi32>
+// CHECK: AIE.buffer({{.*}}) {address = 6180 : i32, sym_name = "s"} : memref<3xi8>
+
+module @test {
+ AIE.device(xcvc1902) {
+  %0 = AIE.tile(3, 3)
+  %ping = AIE.buffer(%0) { sym_name = "of_buff_0" } : memref<512xi32>
+  %pong = AIE.buffer(%0) { sym_name = "of_buff_1" } : memref<512xi32>
+  %x = AIE.buffer(%0) { sym_name = "x" } : memref<256xi32>
+  %y = AIE.buffer(%0) { sym_name = "y" } : memref<256xi32>
+  %v0 = AIE.buffer(%0) { sym_name = "v0" } : memref<9xi32>
+  %v1 = AIE.buffer(%0) { sym_name = "v1" } : memref<9xi32>
+  %s = AIE.buffer(%0) { sym_name = "s" } : memref<3xi8>
+  AIE.core(%0) {
+    %c0 = arith.constant 0 : index
+    %c7 = arith.constant 7 : i32
+    memref.store %c7, %x[%c0] : memref<256xi32>
+    memref.store %c7, %y[%c0] : memref<256xi32>
+    AIE.end
+  }
+ }
+}
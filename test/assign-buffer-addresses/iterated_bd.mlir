@@ -0,0 +1,40 @@
+//===- iterated_bd.mlir ----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-assign-buffer-addresses="alloc-scheme=sequential" %s | FileCheck %s
+// RUN: aie-opt --aie-assign-buffer-addresses="alloc-scheme=best-fit" %s | FileCheck %s
+
+// The BD iterates over the buffers of @of, which are placed 64 bytes apart.
+// CHECK: AIE.buffer({{.*}}) {address = 1024 : i32, sym_name = "of_buff_0"} : memref<16xi32>
+// CHECK: AIE.buffer({{.*}}) {address = 0 : i32, sym_name = "a"} : memref<256xi32>
+// CHECK: AIE.buffer({{.*}}) {address = 1088 : i32, sym_name = "of_buff_1"} : memref<16xi32>
+// CHECK: AIE.buffer({{.*}}) {address = 1152 : i32, sym_name = "of_buff_2"} : memref<16xi32>
+
+module @test {
+ AIE.device(xcve2302) {
+  %0 = AIE.tile(1, 2)
+  %buff0 = AIE.buffer(%0) { sym_name = "of_buff_0" } : memref<16xi32>
+  %a = AIE.buffer(%0) { sym_name = "a" } : memref<256xi32>
+  %buff1 = AIE.buffer(%0) { sym_name = "of_buff_1" } : memref<16xi32>
+  %buff2 = AIE.buffer(%0) { sym_name = "of_buff_2" } : memref<16xi32>
+  %prod_lock = AIE.lock(%0, 0) { init = 3 : i32, sym_name = "of_prod_lock" }
+  %cons_lock = AIE.lock(%0, 1) { init = 0 : i32, sym_name = "of_cons_lock" }
+  %mem = AIE.mem(%0) {
+    %dma = AIE.dmaStart(S2MM, 0, ^bd0, ^end)
+  ^bd0:
+    AIE.useLock(%prod_lock, AcquireGreaterEqual, 1)
+    AIE.dmaBd(<%buff0 : memref<16xi32>, 0, 16>, 0) {iteration = #AIE.DimTuple<3, 16>}
+    AIE.useLock(%cons_lock, Release, 1)
+    AIE.nextBd ^bd0
+  ^end:
+    AIE.end
+  }
+ }
+}
@@ -0,0 +1,58 @@
+//===- lock_move_order.mlir ------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-assign-lock-ids %s | FileCheck %s
+
+// Tile (2, 3) has no free lock ID left, so %x moves to tile (2, 4). That tile
+// is declared after %x, so it is moved up to keep the IR valid.
+
+// CHECK: %[[T23:.*]] = AIE.tile(2, 3)
+// CHECK: AIE.lock(%[[T23]], 15)
+// CHECK-NEXT: %[[T24:.*]] = AIE.tile(2, 4)
+// CHECK-NEXT: %[[X:.*]] = AIE.lock(%[[T24]], 0)
+// CHECK: AIE.core(%[[T23]])
+// CHECK: AIE.useLock(%[[X]], Acquire, 0)
+// CHECK: AIE.core(%[[T24]])
+
+module @lock_move_order {
+ AIE.device(xcvc1902) {
+  %t23 = AIE.tile(2, 3)
+
+  %l0 = AIE.lock(%t23, 0)
+  %l1 = AIE.lock(%t23, 1)
+  %l2 = AIE.lock(%t23, 2)
+  %l3 = AIE.lock(%t23, 3)
+  %l4 = AIE.lock(%t23, 4)
+  %l5 = AIE.lock(%t23, 5)
+  %l6 = AIE.lock(%t23, 6)
+  %l7 = AIE.lock(%t23, 7)
+  %l8 = AIE.lock(%t23, 8)
+  %l9 = AIE.lock(%t23, 9)
+  %l10 = AIE.lock(%t23, 10)
+  %l11 = AIE.lock(%t23, 11)
+  %l12 = AIE.lock(%t23, 12)
+  %l13 = AIE.lock(%t23, 13)
+  %l14 = AIE.lock(%t23, 14)
+  %l15 = AIE.lock(%t23, 15)
+
+  %x = AIE.lock(%t23)
+
+  %core23 = AIE.core(%t23) {
+    AIE.useLock(%x, Acquire, 0)
+    AIE.useLock(%x, Release, 0)
+    AIE.end
+  }
+
+  %t24 = AIE.tile(2, 4)
+  %core24 = AIE.core(%t24) {
+    AIE.end
+  }
+ }
+}
@@ -0,0 +1,72 @@
+//===- lock_reuse.mlir -----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-assign-lock-ids %s | FileCheck %s
+// RUN: aie-opt --aie-assign-lock-ids=print-report %s -o /dev/null 2>&1 | FileCheck %s --check-prefix=REPORT
+
+// Only lock IDs 14 and 15 of tile (2, 3) are free. %e is used after %a is
+// done with lock 14 and left it at 0, so it takes over lock 14. %b leaves its
+// lock at 1, so %c and %d cannot reuse it; they move to the memory of tile
+// (2, 4), where they share lock 0.
+
+// CHECK: %[[T23:.*]] = AIE.tile(2, 3)
+// CHECK: %[[T24:.*]] = AIE.tile(2, 4)
+// CHECK: %[[A:.*]] = AIE.lock(%[[T23]], 14)
+// CHECK: %[[E:.*]] = AIE.lock(%[[T23]], 14)
+// CHECK: %[[B:.*]] = AIE.lock(%[[T23]], 15)
+// CHECK: %[[C:.*]] = AIE.lock(%[[T24]], 0)
+// CHECK: %[[D:.*]] = AIE.lock(%[[T24]], 0)
+
+// REPORT:      lock moved from tile (2, 3) to tile (2, 4)
+// REPORT-NEXT: lock moved from tile (2, 3) to tile (2, 4)
+// REPORT-NEXT: tile (2, 3): 17 locks on 16 of 16 lock IDs, at most 16 live at once
+// REPORT-NEXT: tile (2, 4): 2 locks on 1 of 16 lock IDs, at most 1 live at once
+
+module @lock_reuse {
+ AIE.device(xcvc1902) {
+  %t23 = AIE.tile(2, 3)
+  %t24 = AIE.tile(2, 4)
+
+  %l0 = AIE.lock(%t23, 0)
+  %l1 = AIE.lock(%t23, 1)
+  %l2 = AIE.lock(%t23, 2)
+  %l3 = AIE.lock(%t23, 3)
+  %l4 = AIE.lock(%t23, 4)
+  %l5 = AIE.lock(%t23, 5)
+  %l6 = AIE.lock(%t23, 6)
+  %l7 = AIE.lock(%t23, 7)
+  %l8 = AIE.lock(%t23, 8)
+  %l9 = AIE.lock(%t23, 9)
+  %l10 = AIE.lock(%t23, 10)
+  %l11 = AIE.lock(%t23, 11)
+  %l12 = AIE.lock(%t23, 12)
+  %l13 = AIE.lock(%t23, 13)
+
+  %a = AIE.lock(%t23)
+  %e = AIE.lock(%t23)
+  %b = AIE.lock(%t23)
+  %c = AIE.lock(%t23)
+  %d = AIE.lock(%t23)
+
+  %core23 = AIE.core(%t23) {
+    AIE.useLock(%a, Acquire, 0)
+    AIE.useLock(%a, Release, 0)
+    AIE.useLock(%e, Acquire, 0)
+    AIE.useLock(%b, Acquire, 0)
+    AIE.useLock(%b, Release, 1)
+    AIE.useLock(%c, Acquire, 0)
+    AIE.useLock(%c, Release, 0)
+    AIE.useLock(%d, Acquire, 0)
+    AIE.useLock(%d, Release, 0)
+    AIE.useLock(%e, Release, 0)
+    AIE.end
+  }
+ }
+}
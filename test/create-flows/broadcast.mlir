@@ -9,6 +9,7 @@
 //===----------------------------------------------------------------------===//
 
 // RUN: aie-opt --aie-create-pathfinder-flows --aie-find-flows %s | FileCheck %s
+// RUN: aie-opt --aie-create-pathfinder-flows="steiner=true" --aie-find-flows %s | FileCheck %s
 // CHECK: %[[T03:.*]] = AIE.tile(0, 3)
 // CHECK: %[[T02:.*]] = AIE.tile(0, 2)
 // CHECK: %[[T00:.*]] = AIE.tile(0, 0)
@@ -13,6 +13,7 @@
 //
 
 // RUN: aie-opt --split-input-file --aie-create-pathfinder-flows -split-input-file %s | FileCheck %s
+// RUN: aie-opt --split-input-file --aie-create-pathfinder-flows="num-threads=4" %s | FileCheck %s
 
 // CHECK-LABEL: test70
 // CHECK: %[[T70:.*]] = AIE.tile(7, 0)
@@ -9,6 +9,9 @@
 //===----------------------------------------------------------------------===//
 
 // RUN: aie-opt --aie-create-pathfinder-flows --aie-find-flows %s | FileCheck %s
+// RUN: aie-opt --aie-create-pathfinder-flows="incremental=true" --aie-find-flows %s | FileCheck %s
+// RUN: aie-opt --aie-create-pathfinder-flows="incremental=true print-stats=true" %s 2>&1 >/dev/null | FileCheck %s --check-prefix=STATS
+// STATS: Pathfinder iteration 1: rerouted 16 flows, {{[0-9]+}} channels over capacity, {{.*}} ms
 // CHECK: %[[T03:.*]] = AIE.tile(0, 3)
 // CHECK: %[[T02:.*]] = AIE.tile(0, 2)
 // CHECK: %[[T00:.*]] = AIE.tile(0, 0)
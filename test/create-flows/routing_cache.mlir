@@ -0,0 +1,38 @@
+//===- routing_cache.mlir --------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: aie-opt --aie-create-pathfinder-flows="cache-dir=%t print-stats=true" %s -o /dev/null 2>&1 | FileCheck %s --check-prefix=MISS
+// RUN: aie-opt --aie-create-pathfinder-flows="cache-dir=%t print-stats=true" %s -o /dev/null 2>&1 | FileCheck %s --check-prefix=HIT
+// RUN: aie-opt --aie-create-pathfinder-flows="cache-dir=%t" --aie-find-flows %s | FileCheck %s
+
+// MISS-NOT: routing cache hit
+// MISS: Pathfinder iteration 1:
+
+// HIT: Pathfinder routing cache hit
+// HIT-NOT: Pathfinder iteration
+
+// CHECK: %[[T23:.*]] = AIE.tile(2, 3)
+// CHECK: %[[T22:.*]] = AIE.tile(2, 2)
+// CHECK: %[[T11:.*]] = AIE.tile(1, 1)
+// CHECK: AIE.flow(%[[T23]], Core : 0, %[[T22]], Core : 1)
+// CHECK: AIE.flow(%[[T22]], Core : 1, %[[T23]], Core : 1)
+// CHECK: AIE.flow(%[[T11]], DMA : 0, %[[T23]], DMA : 0)
+
+module {
+  AIE.device(xcvc1902) {
+    %t23 = AIE.tile(2, 3)
+    %t22 = AIE.tile(2, 2)
+    %t11 = AIE.tile(1, 1)
+    AIE.flow(%t23, Core : 0, %t22, Core : 1)
+    AIE.flow(%t22, Core : 1, %t23, Core : 1)
+    AIE.flow(%t11, DMA : 0, %t23, DMA : 0)
+  }
+}
@@ -0,0 +1,29 @@
+//===- steiner.mlir --------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-create-pathfinder-flows="print-stats=true" %s 2>&1 >/dev/null | FileCheck %s --check-prefix=DEFAULT
+// RUN: aie-opt --aie-create-pathfinder-flows="steiner=true print-stats=true" %s 2>&1 >/dev/null | FileCheck %s --check-prefix=STEINER
+
+// Ties between shortest paths go to the switchbox with the lowest index, so
+// the path to (4, 2) leaves row 1 straight away and the shortest path tree
+// from the source uses 4 + 5 channels. The Steiner tree connects (4, 2) to the
+// path to (4, 1) instead, with a single channel.
+// DEFAULT: Pathfinder iteration 1: rerouted 1 flows, 0 channels over capacity, {{[0-9]+}} switchboxes expanded, 9 channels used
+// STEINER: Pathfinder iteration 1: rerouted 1 flows, 0 channels over capacity, {{[0-9]+}} switchboxes expanded, 5 channels used
+
+module {
+  AIE.device(xcvc1902) {
+    %t01 = AIE.tile(0, 1)
+    %t41 = AIE.tile(4, 1)
+    %t42 = AIE.tile(4, 2)
+    AIE.flow(%t01, DMA : 0, %t41, DMA : 0)
+    AIE.flow(%t01, DMA : 0, %t42, DMA : 0)
+  }
+}
@@ -0,0 +1,40 @@
+//===- unreachable.mlir ----------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: not aie-opt --aie-create-pathfinder-flows %s 2>&1 | FileCheck %s
+// RUN: not aie-opt --aie-create-pathfinder-flows="steiner=true" %s 2>&1 | FileCheck %s
+// CHECK: error: Unable to route the flow from (1, 1) DMA : 0 to all of its destinations
+
+// (0, 2) can only be entered from (0, 1) and (1, 2), and every channel from
+// them into (0, 2) is already taken, while (1, 2) is still reachable.
+module {
+  AIE.device(xcvc1902) {
+    %t01 = AIE.tile(0, 1)
+    %t02 = AIE.tile(0, 2)
+    %t11 = AIE.tile(1, 1)
+    %t12 = AIE.tile(1, 2)
+    %sb01 = AIE.switchbox(%t01) {
+      AIE.connect<South : 0, North : 0>
+      AIE.connect<South : 1, North : 1>
+      AIE.connect<South : 2, North : 2>
+      AIE.connect<South : 3, North : 3>
+      AIE.connect<DMA : 0, North : 4>
+      AIE.connect<DMA : 1, North : 5>
+    }
+    %sb12 = AIE.switchbox(%t12) {
+      AIE.connect<South : 0, West : 0>
+      AIE.connect<South : 1, West : 1>
+      AIE.connect<South : 2, West : 2>
+      AIE.connect<South : 3, West : 3>
+    }
+    AIE.flow(%t11, DMA : 0, %t12, DMA : 0)
+    AIE.flow(%t11, DMA : 0, %t02, DMA : 0)
+  }
+}
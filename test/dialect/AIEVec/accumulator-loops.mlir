@@ -0,0 +1,100 @@
+// RUN: aie-opt %s -optimize-aievec="aie-target=aieml" -split-input-file | FileCheck %s --check-prefixes=CHECK,DEFAULT
+// RUN: aie-opt %s -optimize-aievec="aie-target=aieml keep-acc-in-loops=true" -split-input-file | FileCheck %s --check-prefixes=CHECK,KEEP
+
+// The SRS saturates the sum on every iteration, so by default the accumulator
+// is moved out of the accumulator register and back in each time.
+
+// CHECK-LABEL: func.func @sum_i16(
+// CHECK-SAME: %[[A:[A-Za-z0-9]+]]: memref<256xi16>,
+// CHECK-SAME: %[[INIT:[A-Za-z0-9]+]]: vector<32xi16>) -> vector<32xi16> {
+// DEFAULT: %[[LOOP:.*]] = scf.for %{{.*}} = %{{.*}} to %{{.*}} step %{{.*}}
+// DEFAULT-SAME: iter_args(%[[ACC:.*]] = %[[INIT]]) -> (vector<32xi16>) {
+// DEFAULT: aievec.ups %[[ACC]] {shift = 0 : i8} : vector<32xi16>, vector<32xi32>
+// DEFAULT: %[[SRS:.*]] = aievec.srs %{{.*}}, %{{.*}} : vector<32xi32>, i32, vector<32xi16>
+// DEFAULT: scf.yield %[[SRS]] : vector<32xi16>
+// DEFAULT: return %[[LOOP]] : vector<32xi16>
+// KEEP: %[[INITACC:.*]] = aievec.ups %[[INIT]] {shift = 0 : i8} : vector<32xi16>, vector<32xi32>
+// KEEP: %[[LOOP:.*]] = scf.for %[[I:.*]] = %{{.*}} to %{{.*}} step %{{.*}}
+// KEEP-SAME: iter_args(%[[ACC:.*]] = %[[INITACC]]) -> (vector<32xi32>) {
+// KEEP: %[[V:.*]] = aievec.upd %[[A]][%[[I]]]
+// KEEP: %[[VUPS:.*]] = aievec.ups %[[V]] {shift = 0 : i8} : vector<32xi16>, vector<32xi32>
+// KEEP: %[[SUM:.*]] = aievec.add_elem %[[ACC]], %[[VUPS]] : vector<32xi32>
+// KEEP-NOT: aievec.srs
+// KEEP: scf.yield %[[SUM]] : vector<32xi32>
+// KEEP: %[[RES:.*]] = aievec.srs %[[LOOP]], %{{.*}} : vector<32xi32>, i32, vector<32xi16>
+// KEEP: return %[[RES]] : vector<32xi16>
+func.func @sum_i16(%A : memref<256xi16>, %init : vector<32xi16>) -> vector<32xi16> {
+  %c0 = arith.constant 0 : index
+  %c32 = arith.constant 32 : index
+  %c256 = arith.constant 256 : index
+  %c0_i32 = arith.constant 0 : i32
+  %0 = scf.for %i = %c0 to %c256 step %c32 iter_args(%acc = %init) -> (vector<32xi16>) {
+    %v = aievec.upd %A[%i] {index = 0 : i8, offset = 0 : i32} : memref<256xi16>, vector<32xi16>
+    %accups = aievec.ups %acc {shift = 0 : i8} : vector<32xi16>, vector<32xi32>
+    %vups = aievec.ups %v {shift = 0 : i8} : vector<32xi16>, vector<32xi32>
+    %sum = aievec.add_elem %accups, %vups : vector<32xi32>
+    %srs = aievec.srs %sum, %c0_i32 : vector<32xi32>, i32, vector<32xi16>
+    scf.yield %srs : vector<32xi16>
+  }
+  return %0 : vector<32xi16>
+}
+
+// -----
+
+// Casts only move the value between registers, so the accumulator always stays
+// in the accumulator register.
+
+// CHECK-LABEL: func.func @sum_f32(
+// CHECK-SAME: %[[A:[A-Za-z0-9]+]]: memref<256xf32>,
+// CHECK-SAME: %[[INIT:[A-Za-z0-9]+]]: vector<16xf32>) -> vector<16xf32> {
+// CHECK: %[[INITACC:.*]] = aievec.cast %[[INIT]] {isResAcc = true} : vector<16xf32>, vector<16xf32>
+// CHECK: %[[LOOP:.*]] = scf.for %[[I:.*]] = %{{.*}} to %{{.*}} step %{{.*}}
+// CHECK-SAME: iter_args(%[[ACC:.*]] = %[[INITACC]]) -> (vector<16xf32>) {
+// CHECK: %[[V:.*]] = aievec.upd %[[A]][%[[I]]]
+// CHECK: %[[VACC:.*]] = aievec.cast %[[V]] {isResAcc = true} : vector<16xf32>, vector<16xf32>
+// CHECK: %[[SUM:.*]] = aievec.add_elem %[[ACC]], %[[VACC]] : vector<16xf32>
+// CHECK-NOT: aievec.cast
+// CHECK: scf.yield %[[SUM]] : vector<16xf32>
+// CHECK: %[[RES:.*]] = aievec.cast %[[LOOP]] {isResAcc = false} : vector<16xf32>, vector<16xf32>
+// CHECK: return %[[RES]] : vector<16xf32>
+func.func @sum_f32(%A : memref<256xf32>, %init : vector<16xf32>) -> vector<16xf32> {
+  %c0 = arith.constant 0 : index
+  %c16 = arith.constant 16 : index
+  %c256 = arith.constant 256 : index
+  %0 = scf.for %i = %c0 to %c256 step %c16 iter_args(%acc = %init) -> (vector<16xf32>) {
+    %v = aievec.upd %A[%i] {index = 0 : i8, offset = 0 : i32} : memref<256xf32>, vector<16xf32>
+    %acccast = aievec.cast %acc {isResAcc = true} : vector<16xf32>, vector<16xf32>
+    %vcast = aievec.cast %v {isResAcc = true} : vector<16xf32>, vector<16xf32>
+    %sum = aievec.add_elem %acccast, %vcast : vector<16xf32>
+    %res = aievec.cast %sum {isResAcc = false} : vector<16xf32>, vector<16xf32>
+    scf.yield %res : vector<16xf32>
+  }
+  return %0 : vector<16xf32>
+}
+
+// -----
+
+// The accumulator is rescaled on every iteration, so it can't stay in the
+// accumulator register.
+
+// CHECK-LABEL: func.func @rescaled_sum_i16(
+// CHECK: scf.for
+// CHECK-SAME: -> (vector<32xi16>) {
+// CHECK: aievec.ups
+// CHECK: aievec.srs
+// CHECK: scf.yield
+func.func @rescaled_sum_i16(%A : memref<256xi16>, %init : vector<32xi16>) -> vector<32xi16> {
+  %c0 = arith.constant 0 : index
+  %c32 = arith.constant 32 : index
+  %c256 = arith.constant 256 : index
+  %c1_i32 = arith.constant 1 : i32
+  %0 = scf.for %i = %c0 to %c256 step %c32 iter_args(%acc = %init) -> (vector<32xi16>) {
+    %v = aievec.upd %A[%i] {index = 0 : i8, offset = 0 : i32} : memref<256xi16>, vector<32xi16>
+    %accups = aievec.ups %acc {shift = 0 : i8} : vector<32xi16>, vector<32xi32>
+    %vups = aievec.ups %v {shift = 0 : i8} : vector<32xi16>, vector<32xi32>
+    %sum = aievec.add_elem %accups, %vups : vector<32xi32>
+    %srs = aievec.srs %sum, %c1_i32 : vector<32xi32>, i32, vector<32xi16>
+    scf.yield %srs : vector<32xi16>
+  }
+  return %0 : vector<32xi16>
+}
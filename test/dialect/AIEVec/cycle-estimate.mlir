@@ -0,0 +1,78 @@
+// RUN: aie-opt %s -aievec-cycle-estimate="aie-target=aieml" -o /dev/null | FileCheck %s
+
+// The loads of each iteration take two bundles, and the MACs on the same
+// accumulator can issue back to back, so the loop runs at II = 2. The first
+// MAC waits for the loads, and the last one takes the whole MAC latency.
+
+// CHECK:      "target": "aieml",
+// CHECK:      "name": "dot_i32",
+// CHECK-NEXT: "cycles": 51,
+// CHECK-NEXT: "loops": [
+// CHECK:        "location": "{{.*}}cycle-estimate.mlir:{{[0-9]+}}:{{[0-9]+}}",
+// CHECK-NEXT:   "depth": 0,
+// CHECK-NEXT:   "trip_count": 16,
+// CHECK-NEXT:   "slots": {
+// CHECK-NEXT:     "load": 4,
+// CHECK-NEXT:     "store": 0,
+// CHECK-NEXT:     "vector": 1,
+// CHECK-NEXT:     "scalar": 0,
+// CHECK-NEXT:     "move": 0
+// CHECK-NEXT:   },
+// CHECK-NEXT:   "resource_bound": 2,
+// CHECK-NEXT:   "recurrence_bound": 1,
+// CHECK-NEXT:   "ii": 2,
+// CHECK-NEXT:   "schedule_length": 13,
+// CHECK-NEXT:   "pipelined": true,
+// CHECK-NEXT:   "cycles": 43,
+// CHECK-NEXT:   "loops": []
+func.func @dot_i32(%A : memref<256xi32>, %B : memref<256xi32>, %init : vector<16xi32>) -> vector<16xi32> {
+  %c0 = arith.constant 0 : index
+  %c16 = arith.constant 16 : index
+  %c256 = arith.constant 256 : index
+  %c0_i32 = arith.constant 0 : i32
+  %acc = aievec.ups %init {shift = 0 : i8} : vector<16xi32>, vector<16xi64>
+  %0 = scf.for %i = %c0 to %c256 step %c16 iter_args(%iacc = %acc) -> (vector<16xi64>) {
+    %a = aievec.upd %A[%i] {index = 0 : i8, offset = 0 : i32} : memref<256xi32>, vector<16xi32>
+    %b = aievec.upd %B[%i] {index = 0 : i8, offset = 0 : i32} : memref<256xi32>, vector<16xi32>
+    %mac = aievec.mac_elem %a, %b, %iacc : vector<16xi32>, vector<16xi32>, vector<16xi64>
+    scf.yield %mac : vector<16xi64>
+  }
+  %1 = aievec.srs %0, %c0_i32 : vector<16xi64>, i32, vector<16xi32>
+  return %1 : vector<16xi32>
+}
+
+// The trip count of the inner loop isn't known, so neither are the cycles of
+// the loops around it.
+
+// CHECK:      "name": "copy_rows",
+// CHECK-NEXT: "cycles": null,
+// CHECK-NEXT: "loops": [
+// CHECK:        "depth": 0,
+// CHECK-NEXT:   "trip_count": 4,
+// CHECK:        "pipelined": false,
+// CHECK-NEXT:   "cycles": null,
+// CHECK-NEXT:   "loops": [
+// CHECK:          "depth": 1,
+// CHECK-NEXT:     "trip_count": null,
+// CHECK-NEXT:     "slots": {
+// CHECK-NEXT:       "load": 2,
+// CHECK-NEXT:       "store": 2,
+// CHECK:          "resource_bound": 2,
+// CHECK-NEXT:     "recurrence_bound": 0,
+// CHECK-NEXT:     "ii": 2,
+// CHECK-NEXT:     "schedule_length": 7,
+// CHECK-NEXT:     "pipelined": true,
+// CHECK-NEXT:     "cycles": null,
+func.func @copy_rows(%A : memref<4x?xi32>, %B : memref<4x?xi32>, %n : index) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %c16 = arith.constant 16 : index
+  scf.for %i = %c0 to %c4 step %c1 {
+    scf.for %j = %c0 to %n step %c16 {
+      %v = aievec.upd %A[%i, %j] {index = 0 : i8, offset = 0 : i32} : memref<4x?xi32>, vector<16xi32>
+      vector.transfer_write %v, %B[%i, %j] {in_bounds = [true]} : vector<16xi32>, memref<4x?xi32>
+    }
+  }
+  return
+}
@@ -0,0 +1,92 @@
+//===- depth_sizing.mlir ---------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-depth-sizing %s | FileCheck %s
+// RUN: aie-opt --aie-objectFifo-depth-sizing=print-report %s -o /dev/null 2>&1 | FileCheck %s --check-prefix=REPORT
+
+// @of_shared has a single pool, in which the producer holds 1 element while
+// the consumer holds a window of 2. @of_dma needs one more element than each
+// core holds, for the element in flight. Two elements of @of_big do not fit
+// in the memory of either tile, so it is reduced to one on both.
+
+// CHECK: AIE.objectFifo @of_shared(%{{.*}}, {%{{.*}}}, 3 : i32) : !AIE.objectFifo<memref<16xi32>>
+// CHECK: AIE.objectFifo @of_dma(%{{.*}}, {%{{.*}}}, [2, 3]) : !AIE.objectFifo<memref<256xi32>>
+// CHECK: AIE.objectFifo @of_big(%{{.*}}, {%{{.*}}}, [1, 1]) : !AIE.objectFifo<memref<8192xi32>>
+
+// REPORT:      objectFifo @of_shared (64 bytes per element)
+// REPORT-NEXT:   producer (1, 2) holds 1, releases 1 per iteration, 16 in total
+// REPORT-NEXT:   consumer (1, 3) holds 2, releases 1 per iteration, 16 in total
+// REPORT-NEXT:   shared on tile (1, 2): depth 5 -> 3
+// REPORT-NEXT: objectFifo @of_dma (1024 bytes per element)
+// REPORT-NEXT:   producer (1, 2) holds 1, releases 1 per iteration, 16 in total
+// REPORT-NEXT:   consumer (3, 3) holds 2, releases 2 per iteration, 16 in total
+// REPORT-NEXT:   pool on tile (1, 2): depth 2 -> 2
+// REPORT-NEXT:   pool on tile (3, 3): depth 2 -> 3
+// REPORT-NEXT: objectFifo @of_big (32768 bytes per element)
+// REPORT-NEXT:   producer (1, 2) holds 1, releases 1 per iteration, 16 in total
+// REPORT-NEXT:   consumer (3, 3) holds 1, releases 1 per iteration, 8 in total
+// REPORT-NEXT:   pool on tile (1, 2): depth 2 -> 1
+// REPORT-NEXT:   bottleneck: limited by the memory of the tile, 2 elements needed to not stall
+// REPORT-NEXT:   pool on tile (3, 3): depth 2 -> 1
+// REPORT-NEXT:   bottleneck: limited by the memory of the tile, 2 elements needed to not stall
+// REPORT-NEXT:   bottleneck: producer releases 16 elements but a consumer releases 8
+// REPORT-NEXT: core (1, 2): @of_big moves 32768 bytes per iteration by DMA (8192 cycles)
+// REPORT-NEXT: core (3, 3): @of_big moves 32768 bytes per iteration by DMA (8192 cycles)
+
+module @depth_sizing {
+    AIE.device(xcve2302) {
+        %tile12 = AIE.tile(1, 2)
+        %tile13 = AIE.tile(1, 3)
+        %tile33 = AIE.tile(3, 3)
+
+        AIE.objectFifo @of_shared (%tile12, {%tile13}, 5 : i32) : !AIE.objectFifo<memref<16xi32>>
+        AIE.objectFifo @of_dma (%tile12, {%tile33}, 2 : i32) : !AIE.objectFifo<memref<256xi32>>
+        AIE.objectFifo @of_big (%tile12, {%tile33}, 2 : i32) : !AIE.objectFifo<memref<8192xi32>>
+
+        %core12 = AIE.core(%tile12) {
+            %c0 = arith.constant 0 : index
+            %c1 = arith.constant 1 : index
+            %c16 = arith.constant 16 : index
+            scf.for %i = %c0 to %c16 step %c1 {
+                %0 = AIE.objectFifo.acquire @of_shared (Produce, 1) : !AIE.objectFifoSubview<memref<16xi32>>
+                AIE.objectFifo.release @of_shared (Produce, 1)
+                %1 = AIE.objectFifo.acquire @of_dma (Produce, 1) : !AIE.objectFifoSubview<memref<256xi32>>
+                AIE.objectFifo.release @of_dma (Produce, 1)
+                %2 = AIE.objectFifo.acquire @of_big (Produce, 1) : !AIE.objectFifoSubview<memref<8192xi32>>
+                AIE.objectFifo.release @of_big (Produce, 1)
+            }
+            AIE.end
+        }
+
+        %core13 = AIE.core(%tile13) {
+            %c0 = arith.constant 0 : index
+            %c1 = arith.constant 1 : index
+            %c16 = arith.constant 16 : index
+            scf.for %i = %c0 to %c16 step %c1 {
+                %0 = AIE.objectFifo.acquire @of_shared (Consume, 2) : !AIE.objectFifoSubview<memref<16xi32>>
+                AIE.objectFifo.release @of_shared (Consume, 1)
+            }
+            AIE.end
+        }
+
+        %core33 = AIE.core(%tile33) {
+            %c0 = arith.constant 0 : index
+            %c1 = arith.constant 1 : index
+            %c8 = arith.constant 8 : index
+            scf.for %i = %c0 to %c8 step %c1 {
+                %0 = AIE.objectFifo.acquire @of_dma (Consume, 2) : !AIE.objectFifoSubview<memref<256xi32>>
+                AIE.objectFifo.release @of_dma (Consume, 2)
+                %1 = AIE.objectFifo.acquire @of_big (Consume, 1) : !AIE.objectFifoSubview<memref<8192xi32>>
+                AIE.objectFifo.release @of_big (Consume, 1)
+            }
+            AIE.end
+        }
+    }
+}
@@ -0,0 +1,84 @@
+//===- bd_chain_compression.mlir -------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-stateful-transform %s | FileCheck %s
+// RUN: aie-opt --aie-objectFifo-stateful-transform=compress-bd-chains %s | FileCheck %s --check-prefix=ALL
+
+// The memtile would need 4 chains of 13 BDs, more than the 48 it has, so each
+// chain is folded into one BD that iterates over the 13 elements of @link1.
+// The core tiles have BDs to spare and keep their chains, unless all chains
+// are compressed.
+
+// CHECK-DAG:     %[[IN0:.*]] = AIE.buffer(%{{.*}}) {sym_name = "link1_cons_buff_0"} : memref<48xi32>
+// CHECK-DAG:     %[[IN_PROD:.*]] = AIE.lock(%{{.*}}, 0) {init = 39 : i32, sym_name = "link1_cons_prod_lock"}
+// CHECK-DAG:     %[[IN_CONS:.*]] = AIE.lock(%{{.*}}, 1) {init = 0 : i32, sym_name = "link1_cons_cons_lock"}
+// CHECK-DAG:     %[[OUT0:.*]] = AIE.buffer(%{{.*}}) {sym_name = "link2_cons_buff_0"} : memref<16xi32>
+// CHECK-DAG:     %[[OUT1:.*]] = AIE.buffer(%{{.*}}) {sym_name = "link2_cons_buff_1"} : memref<16xi32>
+// CHECK:         AIE.memTileDMA(%{{.*}}) {
+// CHECK:           AIE.dmaStart(S2MM, 0, ^bb1, ^bb2)
+// CHECK:         ^bb1:  // 2 preds: ^bb0, ^bb1
+// CHECK:           AIE.useLock(%[[IN_PROD]], AcquireGreaterEqual, 3)
+// CHECK:           AIE.dmaBd(<%[[IN0]] : memref<48xi32>, 0, 48>, 0) {iteration = #AIE.DimTuple<13, 48>}
+// CHECK:           AIE.useLock(%[[IN_CONS]], Release, 3)
+// CHECK:           AIE.nextBd ^bb1
+// CHECK:         ^bb2:  // pred: ^bb0
+// CHECK:           AIE.dmaStart(MM2S, 0, ^bb3, ^bb4)
+// CHECK:         ^bb3:  // 2 preds: ^bb2, ^bb3
+// CHECK:           AIE.useLock(%[[IN_CONS]], AcquireGreaterEqual, 1)
+// CHECK:           AIE.dmaBd(<%[[IN0]] : memref<48xi32>, 0, 16>, 0) {iteration = #AIE.DimTuple<13, 48>}
+// CHECK:           AIE.useLock(%[[IN_PROD]], Release, 1)
+// CHECK:           AIE.nextBd ^bb3
+// CHECK:         ^bb4:  // pred: ^bb2
+// CHECK:           AIE.dmaStart(MM2S, 1, ^bb5, ^bb6)
+// CHECK:         ^bb5:  // 2 preds: ^bb4, ^bb5
+// CHECK:           AIE.dmaBd(<%[[IN0]] : memref<48xi32>, 64, 16>, 0) {iteration = #AIE.DimTuple<13, 48>}
+// CHECK:           AIE.nextBd ^bb5
+// CHECK:         ^bb6:  // pred: ^bb4
+// CHECK:           AIE.dmaStart(MM2S, 2, ^bb7, ^bb8)
+// CHECK:         ^bb7:  // 2 preds: ^bb6, ^bb7
+// CHECK:           AIE.dmaBd(<%[[IN0]] : memref<48xi32>, 128, 16>, 0) {iteration = #AIE.DimTuple<13, 48>}
+// CHECK:           AIE.nextBd ^bb7
+// CHECK:         ^bb8:  // pred: ^bb6
+// CHECK:           AIE.end
+// CHECK:         }
+// CHECK:         AIE.mem(%{{.*}}) {
+// CHECK:           AIE.dmaStart(S2MM, 0, ^bb1, ^bb3)
+// CHECK:         ^bb1:  // 2 preds: ^bb0, ^bb2
+// CHECK:           AIE.dmaBd(<%[[OUT0]] : memref<16xi32>, 0, 16>, 0)
+// CHECK:           AIE.nextBd ^bb2
+// CHECK:         ^bb2:  // pred: ^bb1
+// CHECK:           AIE.dmaBd(<%[[OUT1]] : memref<16xi32>, 0, 16>, 0)
+// CHECK:           AIE.nextBd ^bb1
+
+// ALL:           AIE.memTileDMA(%{{.*}}) {
+// ALL:           AIE.mem(%{{.*}}) {
+// ALL:             AIE.dmaStart(S2MM, 0, ^bb1, ^bb2)
+// ALL:           ^bb1:  // 2 preds: ^bb0, ^bb1
+// ALL:             AIE.dmaBd(<%{{.*}} : memref<16xi32>, 0, 16>, 0) {iteration = #AIE.DimTuple<2, 16>}
+// ALL:             AIE.nextBd ^bb1
+// ALL:           ^bb2:  // pred: ^bb0
+// ALL:             AIE.end
+
+module @bd_chain_compression {
+    AIE.device(xcve2302) {
+        %tile20 = AIE.tile(2, 0)
+        %tile21 = AIE.tile(2, 1)
+        %tile22 = AIE.tile(2, 2)
+        %tile23 = AIE.tile(2, 3)
+        %tile33 = AIE.tile(3, 3)
+
+        AIE.objectFifo @link1 (%tile20, {%tile21}, 13 : i32) : !AIE.objectFifo<memref<48xi32>>
+        AIE.objectFifo @link2 (%tile21, {%tile22}, 2 : i32) : !AIE.objectFifo<memref<16xi32>>
+        AIE.objectFifo @link3 (%tile21, {%tile23}, 2 : i32) : !AIE.objectFifo<memref<16xi32>>
+        AIE.objectFifo @link4 (%tile21, {%tile33}, 2 : i32) : !AIE.objectFifo<memref<16xi32>>
+
+        AIE.objectFifo.link [@link1] -> [@link2, @link3, @link4] ()
+    }
+}
@@ -0,0 +1,297 @@
+//===- dynamic_loop_test.mlir ----------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aie-opt --aie-objectFifo-stateful-transform=dynamic-objFifos -split-input-file -verify-diagnostics %s | FileCheck %s
+
+// The loop uses objectFifos of depths 3 and 2, which would otherwise unroll it
+// 6 times. Instead, it is kept rolled and each iteration selects its buffers
+// from the number of iterations so far.
+
+// CHECK-LABEL: module @dynamic_loop {
+// CHECK-DAG:     %[[IN0:.*]] = AIE.buffer(%{{.*}}) {sym_name = "of_in_buff_0"} : memref<16xi32>
+// CHECK-DAG:     %[[IN1:.*]] = AIE.buffer(%{{.*}}) {sym_name = "of_in_buff_1"} : memref<16xi32>
+// CHECK-DAG:     %[[IN2:.*]] = AIE.buffer(%{{.*}}) {sym_name = "of_in_buff_2"} : memref<16xi32>
+// CHECK-DAG:     %[[IN_PROD:.*]] = AIE.lock(%{{.*}}) {init = 3 : i32, sym_name = "of_in_prod_lock"}
+// CHECK-DAG:     %[[IN_CONS:.*]] = AIE.lock(%{{.*}}) {init = 0 : i32, sym_name = "of_in_cons_lock"}
+// CHECK-DAG:     %[[OUT0:.*]] = AIE.buffer(%{{.*}}) {sym_name = "of_out_buff_0"} : memref<16xi32>
+// CHECK-DAG:     %[[OUT1:.*]] = AIE.buffer(%{{.*}}) {sym_name = "of_out_buff_1"} : memref<16xi32>
+// CHECK-DAG:     %[[OUT_PROD:.*]] = AIE.lock(%{{.*}}) {init = 2 : i32, sym_name = "of_out_prod_lock"}
+// CHECK-DAG:     %[[OUT_CONS:.*]] = AIE.lock(%{{.*}}) {init = 0 : i32, sym_name = "of_out_cons_lock"}
+// CHECK:         AIE.core(%{{.*}}) {
+// CHECK:           %[[LB:.*]] = arith.constant 0 : index
+// CHECK:           %[[STEP:.*]] = arith.constant 1 : index
+// CHECK:           %[[UB:.*]] = arith.constant 12 : index
+// CHECK:           scf.for %[[I:.*]] = %[[LB]] to %[[UB]] step %[[STEP]] {
+// CHECK:             %[[SIZE2:.*]] = arith.constant 2 : index
+// CHECK:             %[[ZERO2:.*]] = arith.constant 0 : index
+// CHECK:             %[[SUB2:.*]] = arith.subi %[[I]], %[[LB]] : index
+// CHECK:             %[[DIV2:.*]] = arith.divui %[[SUB2]], %[[STEP]] : index
+// CHECK:             %[[REM2:.*]] = arith.remui %[[DIV2]], %[[SIZE2]] : index
+// CHECK:             %[[ADD2:.*]] = arith.addi %[[ZERO2]], %[[REM2]] : index
+// CHECK:             %[[ITER2:.*]] = arith.remui %[[ADD2]], %[[SIZE2]] : index
+// CHECK:             %[[ADV2:.*]] = arith.constant 1 : index
+// CHECK:             %[[MUL2:.*]] = arith.muli %[[ITER2]], %[[ADV2]] : index
+// CHECK:             %[[ROT2:.*]] = arith.remui %[[MUL2]], %[[SIZE2]] : index
+// CHECK:             %[[SIZE3:.*]] = arith.constant 3 : index
+// CHECK:             %[[ZERO3:.*]] = arith.constant 0 : index
+// CHECK:             %[[SUB3:.*]] = arith.subi %[[I]], %[[LB]] : index
+// CHECK:             %[[DIV3:.*]] = arith.divui %[[SUB3]], %[[STEP]] : index
+// CHECK:             %[[REM3:.*]] = arith.remui %[[DIV3]], %[[SIZE3]] : index
+// CHECK:             %[[ADD3:.*]] = arith.addi %[[ZERO3]], %[[REM3]] : index
+// CHECK:             %[[ITER3:.*]] = arith.remui %[[ADD3]], %[[SIZE3]] : index
+// CHECK:             %[[ADV3:.*]] = arith.constant 1 : index
+// CHECK:             %[[MUL3:.*]] = arith.muli %[[ITER3]], %[[ADV3]] : index
+// CHECK:             %[[ROT3:.*]] = arith.remui %[[MUL3]], %[[SIZE3]] : index
+// CHECK:             AIE.useLock(%[[IN_CONS]], AcquireGreaterEqual, 1)
+// CHECK:             %[[IN:.*]] = scf.index_switch %[[ROT3]] -> memref<16xi32>
+// CHECK:             case 0 {
+// CHECK:               scf.yield %[[IN0]] : memref<16xi32>
+// CHECK:             }
+// CHECK:             case 1 {
+// CHECK:               scf.yield %[[IN1]] : memref<16xi32>
+// CHECK:             }
+// CHECK:             default {
+// CHECK:               scf.yield %[[IN2]] : memref<16xi32>
+// CHECK:             }
+// CHECK:             AIE.useLock(%[[OUT_PROD]], AcquireGreaterEqual, 1)
+// CHECK:             %[[OUT:.*]] = scf.index_switch %[[ROT2]] -> memref<16xi32>
+// CHECK:             case 0 {
+// CHECK:               scf.yield %[[OUT0]] : memref<16xi32>
+// CHECK:             }
+// CHECK:             default {
+// CHECK:               scf.yield %[[OUT1]] : memref<16xi32>
+// CHECK:             }
+// CHECK:             func.call @some_work(%[[IN]], %[[OUT]]) : (memref<16xi32>, memref<16xi32>) -> ()
+// CHECK:             AIE.useLock(%[[IN_PROD]], Release, 1)
+// CHECK:             AIE.useLock(%[[OUT_CONS]], Release, 1)
+// CHECK:           }
+// CHECK:           AIE.end
+// CHECK:         }
+
+module @dynamic_loop {
+    AIE.device(xcve2302) {
+        %tile12 = AIE.tile(1, 2)
+        %tile13 = AIE.tile(1, 3)
+        %tile14 = AIE.tile(1, 4)
+
+        AIE.objectFifo @of_in (%tile12, {%tile13}, 3 : i32) : !AIE.objectFifo<memref<16xi32>>
+        AIE.objectFifo @of_out (%tile13, {%tile14}, 2 : i32) : !AIE.objectFifo<memref<16xi32>>
+
+        func.func @some_work(%in : memref<16xi32>, %out : memref<16xi32>) -> () {
+            return
+        }
+
+        %core13 = AIE.core(%tile13) {
+            %c0 = arith.constant 0 : index
+            %c1 = arith.constant 1 : index
+            %c12 = arith.constant 12 : index
+
+            scf.for %i = %c0 to %c12 step %c1 {
+                %subviewIn = AIE.objectFifo.acquire @of_in (Consume, 1) : !AIE.objectFifoSubview<memref<16xi32>>
+                %elemIn = AIE.objectFifo.subview.access %subviewIn[0] : !AIE.objectFifoSubview<memref<16xi32>> -> memref<16xi32>
+                %subviewOut = AIE.objectFifo.acquire @of_out (Produce, 1) : !AIE.objectFifoSubview<memref<16xi32>>
+                %elemOut = AIE.objectFifo.subview.access %subviewOut[0] : !AIE.objectFifoSubview<memref<16xi32>> -> memref<16xi32>
+                func.call @some_work(%elemIn, %elemOut) : (memref<16xi32>, memref<16xi32>) -> ()
+                AIE.objectFifo.release @of_in (Consume, 1)
+                AIE.objectFifo.release @of_out (Produce, 1)
+            }
+
+            AIE.end
+        }
+    }
+}
+
+// -----
+
+// On AIE1 every element has its own lock, so the lock is selected at run time
+// like the buffer.
+
+// CHECK-LABEL: module @dynamic_loop_AIE1 {
+// CHECK-DAG:     %[[BUFF0:.*]] = AIE.buffer(%{{.*}}) {sym_name = "of_buff_0"} : memref<16xi32>
+// CHECK-DAG:     %[[BUFF1:.*]] = AIE.buffer(%{{.*}}) {sym_name = "of_buff_1"} : memref<16xi32>
+// CHECK-DAG:     %[[LOCK0:.*]] = AIE.lock(%{{.*}}, 0) {init = 0 : i32, sym_name = "of_lock_0"}
+// CHECK-DAG:     %[[LOCK1:.*]] = AIE.lock(%{{.*}}, 1) {init = 0 : i32, sym_name = "of_lock_1"}
+// CHECK:         AIE.core(%{{.*}}) {
+// CHECK:           %[[LB:.*]] = arith.constant 0 : index
+// CHECK:           %[[STEP:.*]] = arith.constant 1 : index
+// CHECK:           %[[UB:.*]] = arith.constant 12 : index
+// CHECK:           scf.for %[[I:.*]] = %[[LB]] to %[[UB]] step %[[STEP]] {
+// CHECK:             %[[SIZE:.*]] = arith.constant 2 : index
+// CHECK:             %[[ZERO:.*]] = arith.constant 0 : index
+// CHECK:             %[[SUB:.*]] = arith.subi %[[I]], %[[LB]] : index
+// CHECK:             %[[DIV:.*]] = arith.divui %[[SUB]], %[[STEP]] : index
+// CHECK:             %[[REM:.*]] = arith.remui %[[DIV]], %[[SIZE]] : index
+// CHECK:             %[[ADD:.*]] = arith.addi %[[ZERO]], %[[REM]] : index
+// CHECK:             %[[ITER:.*]] = arith.remui %[[ADD]], %[[SIZE]] : index
+// CHECK:             %[[ADV:.*]] = arith.constant 1 : index
+// CHECK:             %[[MUL:.*]] = arith.muli %[[ITER]], %[[ADV]] : index
+// CHECK:             %[[ROT:.*]] = arith.remui %[[MUL]], %[[SIZE]] : index
+// CHECK:             scf.index_switch %[[ROT]]
+// CHECK:             case 0 {
+// CHECK:               AIE.useLock(%[[LOCK0]], Acquire, 0)
+// CHECK:             }
+// CHECK:             default {
+// CHECK:               AIE.useLock(%[[LOCK1]], Acquire, 0)
+// CHECK:             }
+// CHECK:             %[[ELEM:.*]] = scf.index_switch %[[ROT]] -> memref<16xi32>
+// CHECK:             case 0 {
+// CHECK:               scf.yield %[[BUFF0]] : memref<16xi32>
+// CHECK:             }
+// CHECK:             default {
+// CHECK:               scf.yield %[[BUFF1]] : memref<16xi32>
+// CHECK:             }
+// CHECK:             func.call @some_work(%[[ELEM]]) : (memref<16xi32>) -> ()
+// CHECK:             scf.index_switch %[[ROT]]
+// CHECK:             case 0 {
+// CHECK:               AIE.useLock(%[[LOCK0]], Release, 1)
+// CHECK:             }
+// CHECK:             default {
+// CHECK:               AIE.useLock(%[[LOCK1]], Release, 1)
+// CHECK:             }
+// CHECK:           }
+// CHECK:           AIE.end
+// CHECK:         }
+
+module @dynamic_loop_AIE1 {
+    AIE.device(xcvc1902) {
+        %tile12 = AIE.tile(1, 2)
+        %tile13 = AIE.tile(1, 3)
+
+        AIE.objectFifo @of (%tile12, {%tile13}, 2 : i32) : !AIE.objectFifo<memref<16xi32>>
+
+        func.func @some_work(%out : memref<16xi32>) -> () {
+            return
+        }
+
+        %core12 = AIE.core(%tile12) {
+            %c0 = arith.constant 0 : index
+            %c1 = arith.constant 1 : index
+            %c12 = arith.constant 12 : index
+
+            scf.for %i = %c0 to %c12 step %c1 {
+                %subview = AIE.objectFifo.acquire @of (Produce, 1) : !AIE.objectFifoSubview<memref<16xi32>>
+                %elem = AIE.objectFifo.subview.access %subview[0] : !AIE.objectFifoSubview<memref<16xi32>> -> memref<16xi32>
+                func.call @some_work(%elem) : (memref<16xi32>) -> ()
+                AIE.objectFifo.release @of (Produce, 1)
+            }
+
+            AIE.end
+        }
+    }
+}
+
+// -----
+
+// The iterations of a loop nested in another are counted across both: the
+// iterations of the outer loop so far times the trip count of the inner loop,
+// plus those of the inner loop.
+
+// CHECK-LABEL: module @dynamic_nested_loop {
+// CHECK:         AIE.core(%{{.*}}) {
+// CHECK:           %[[C0:.*]] = arith.constant 0 : index
+// CHECK:           %[[C1:.*]] = arith.constant 1 : index
+// CHECK:           %[[C3:.*]] = arith.constant 3 : index
+// CHECK:           %[[C4:.*]] = arith.constant 4 : index
+// CHECK:           scf.for %[[I:.*]] = %[[C0]] to %[[C4]] step %[[C1]] {
+// CHECK:             scf.for %[[J:.*]] = %[[C0]] to %[[C3]] step %[[C1]] {
+// CHECK:               %[[SIZE:.*]] = arith.constant 2 : index
+// CHECK:               %[[ZERO:.*]] = arith.constant 0 : index
+// CHECK:               %[[ISUB:.*]] = arith.subi %[[I]], %[[C0]] : index
+// CHECK:               %[[IDIV:.*]] = arith.divui %[[ISUB]], %[[C1]] : index
+// CHECK:               %[[IREM:.*]] = arith.remui %[[IDIV]], %[[SIZE]] : index
+// CHECK:               %[[IADD:.*]] = arith.addi %[[ZERO]], %[[IREM]] : index
+// CHECK:               %[[IITER:.*]] = arith.remui %[[IADD]], %[[SIZE]] : index
+// CHECK:               %[[SPAN:.*]] = arith.subi %[[C3]], %[[C0]] : index
+// CHECK:               %[[TRIP:.*]] = arith.ceildivui %[[SPAN]], %[[C1]] : index
+// CHECK:               %[[TRIPREM:.*]] = arith.remui %[[TRIP]], %[[SIZE]] : index
+// CHECK:               %[[OUTER:.*]] = arith.muli %[[IITER]], %[[TRIPREM]] : index
+// CHECK:               %[[JSUB:.*]] = arith.subi %[[J]], %[[C0]] : index
+// CHECK:               %[[JDIV:.*]] = arith.divui %[[JSUB]], %[[C1]] : index
+// CHECK:               %[[JREM:.*]] = arith.remui %[[JDIV]], %[[SIZE]] : index
+// CHECK:               %[[JADD:.*]] = arith.addi %[[OUTER]], %[[JREM]] : index
+// CHECK:               %[[ITER:.*]] = arith.remui %[[JADD]], %[[SIZE]] : index
+// CHECK:               %[[ADV:.*]] = arith.constant 1 : index
+// CHECK:               %[[MUL:.*]] = arith.muli %[[ITER]], %[[ADV]] : index
+// CHECK:               %[[ROT:.*]] = arith.remui %[[MUL]], %[[SIZE]] : index
+// CHECK:               AIE.useLock(%{{.*}}, AcquireGreaterEqual, 1)
+// CHECK:               %[[ELEM:.*]] = scf.index_switch %[[ROT]] -> memref<16xi32>
+// CHECK:               func.call @some_work(%[[ELEM]]) : (memref<16xi32>) -> ()
+// CHECK:               AIE.useLock(%{{.*}}, Release, 1)
+// CHECK:             }
+// CHECK:           }
+// CHECK:           AIE.end
+// CHECK:         }
+
+module @dynamic_nested_loop {
+    AIE.device(xcve2302) {
+        %tile12 = AIE.tile(1, 2)
+        %tile13 = AIE.tile(1, 3)
+
+        AIE.objectFifo @of (%tile12, {%tile13}, 2 : i32) : !AIE.objectFifo<memref<16xi32>>
+
+        func.func @some_work(%out : memref<16xi32>) -> () {
+            return
+        }
+
+        %core12 = AIE.core(%tile12) {
+            %c0 = arith.constant 0 : index
+            %c1 = arith.constant 1 : index
+            %c3 = arith.constant 3 : index
+            %c4 = arith.constant 4 : index
+
+            scf.for %i = %c0 to %c4 step %c1 {
+                scf.for %j = %c0 to %c3 step %c1 {
+                    %subview = AIE.objectFifo.acquire @of (Produce, 1) : !AIE.objectFifoSubview<memref<16xi32>>
+                    %elem = AIE.objectFifo.subview.access %subview[0] : !AIE.objectFifoSubview<memref<16xi32>> -> memref<16xi32>
+                    func.call @some_work(%elem) : (memref<16xi32>) -> ()
+                    AIE.objectFifo.release @of (Produce, 1)
+                }
+            }
+
+            AIE.end
+        }
+    }
+}
+
+// -----
+
+// An inner loop whose trip count changes with the outer loop can't be kept
+// rolled, and can't be unrolled either.
+
+module @dynamic_triangular_loop {
+    AIE.device(xcve2302) {
+        %tile12 = AIE.tile(1, 2)
+        %tile13 = AIE.tile(1, 3)
+
+        AIE.objectFifo @of (%tile12, {%tile13}, 2 : i32) : !AIE.objectFifo<memref<16xi32>>
+
+        func.func @some_work(%out : memref<16xi32>) -> () {
+            return
+        }
+
+        %core12 = AIE.core(%tile12) {
+            %c0 = arith.constant 0 : index
+            %c1 = arith.constant 1 : index
+            %c4 = arith.constant 4 : index
+
+            scf.for %i = %c0 to %c4 step %c1 {
+                // expected-error@+1 {{'scf.for' op with objectFifo operations must have constant bounds to be unrolled}}
+                scf.for %j = %c0 to %i step %c1 {
+                    %subview = AIE.objectFifo.acquire @of (Produce, 1) : !AIE.objectFifoSubview<memref<16xi32>>
+                    %elem = AIE.objectFifo.subview.access %subview[0] : !AIE.objectFifoSubview<memref<16xi32>> -> memref<16xi32>
+                    func.call @some_work(%elem) : (memref<16xi32>) -> ()
+                    AIE.objectFifo.release @of (Produce, 1)
+                }
+            }
+
+            AIE.end
+        }
+    }
+}
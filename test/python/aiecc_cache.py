@@ -0,0 +1,128 @@
+# Copyright (C) 2023, Advanced Micro Devices, Inc.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# RUN: %PYTHON %s %T/aiecc_cache | FileCheck %s
+
+import asyncio
+import os
+import shutil
+import sys
+
+import aie.compiler.aiecc.cl_arguments
+import aie.compiler.aiecc.main as aiecc
+
+root = sys.argv[1]
+shutil.rmtree(root, ignore_errors=True)
+os.makedirs(os.path.join(root, "lib"))
+
+# A stand-in for the compiler and the linker: concatenates its input files,
+# including the objects its linker script pulls in, into the output.
+tool = os.path.join(root, "tool.py")
+with open(tool, "w") as f:
+    f.write(
+        """import re, sys
+args = sys.argv[1:]
+out = args[args.index("-o") + 1]
+data = ""
+for arg in args[:args.index("-o")]:
+    if arg.startswith("-Wl,-T,"):
+        for obj in re.findall(r"INPUT\\((.*)\\)", open(arg[7:]).read()):
+            data += open(obj).read()
+    elif not arg.startswith("-"):
+        data += open(arg).read()
+open(out, "w").write(data)
+"""
+    )
+
+
+def write(name, text):
+    with open(os.path.join(root, name), "w") as f:
+        f.write(text)
+
+
+write("input.mlir", "input\n")
+write("link_with.o", "link_with\n")
+write("lib/libfoo.a", "foo\n")
+
+opts = aie.compiler.aiecc.cl_arguments.parse_args(
+    ["--cache-dir", os.path.join(root, "cache"), "--profile", "input.mlir"]
+)
+aiecc.opts = opts
+runs = 0
+
+
+# Each build compiles the input and links it with link_with.o through the
+# linker script and with libfoo.a through -l, in a fresh temporary directory.
+def build(label, flag="-O2", libs=["-lfoo"]):
+    global runs
+    runs += 1
+    tmpdir = os.path.join(root, "build%d" % runs)
+    os.makedirs(tmpdir)
+    runner = aiecc.flow_runner("", opts, tmpdir)
+    obj = os.path.join(tmpdir, "input.o")
+    elf = os.path.join(tmpdir, "input.elf")
+    script = os.path.join(tmpdir, "input.ld.script")
+    with open(script, "w") as f:
+        f.write("INPUT(%s)\n" % os.path.join(root, "link_with.o"))
+
+    async def steps():
+        await runner.do_cached_call(
+            None,
+            [sys.executable, tool, flag, os.path.join(root, "input.mlir"), "-o", obj],
+            [obj],
+        )
+        await runner.do_cached_call(
+            None,
+            [sys.executable, tool, obj, "-Wl,-T," + script,
+             "-L" + os.path.join(root, "lib"), *libs, "-o", elf],
+            [elf],
+        )
+
+    asyncio.run(steps())
+    print("build: " + label)
+    with open(elf) as f:
+        print(f.read().replace("\n", " "))
+    runner.dumpprofile()
+
+
+build("first")
+# CHECK-LABEL: build: first
+# CHECK-NEXT: input link_with
+# CHECK: Artifact cache: 0 hits, 2 misses
+
+build("identical")
+# CHECK-LABEL: build: identical
+# CHECK-NEXT: input link_with
+# CHECK: Artifact cache: 2 hits, 0 misses
+
+write("input.mlir", "changed\n")
+build("input")
+# CHECK-LABEL: build: input
+# CHECK-NEXT: changed link_with
+# CHECK: Artifact cache: 0 hits, 2 misses
+write("input.mlir", "input\n")
+
+# The object doesn't change, so the link is still cached.
+build("flag", flag="-O3")
+# CHECK-LABEL: build: flag
+# CHECK-NEXT: input link_with
+# CHECK: Artifact cache: 1 hits, 1 misses
+
+write("link_with.o", "changed\n")
+build("link_with")
+# CHECK-LABEL: build: link_with
+# CHECK-NEXT: input changed
+# CHECK: Artifact cache: 1 hits, 1 misses
+write("link_with.o", "link_with\n")
+
+write("lib/libfoo.a", "changed\n")
+build("library")
+# CHECK-LABEL: build: library
+# CHECK-NEXT: input link_with
+# CHECK: Artifact cache: 1 hits, 1 misses
+
+# The linker may find libbar in a default directory, so the link isn't cached.
+build("unknown library", libs=["-lfoo", "-lbar"])
+# CHECK-LABEL: build: unknown library
+# CHECK-NEXT: input link_with
+# CHECK: Artifact cache: 1 hits, 0 misses
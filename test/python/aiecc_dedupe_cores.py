@@ -0,0 +1,105 @@
+# Copyright (C) 2023, Advanced Micro Devices, Inc.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# RUN: %PYTHON %s %T/dedupe_ld --no-xbridge | FileCheck %s --check-prefixes=CHECK,LD
+# RUN: %PYTHON %s %T/dedupe_bcf --xbridge | FileCheck %s --check-prefixes=CHECK,BCF
+
+import asyncio
+import os
+import sys
+
+import aie.compiler.aiecc.cl_arguments
+import aie.compiler.aiecc.main as aiecc
+
+# Cores (1, 3) and (3, 3) run the same code on their own buffer; core (2, 3)
+# stores a different value and keeps its own object.
+module = """
+module {
+  AIE.device(xcvc1902) {
+    %t13 = AIE.tile(1, 3)
+    %t23 = AIE.tile(2, 3)
+    %t33 = AIE.tile(3, 3)
+    %a = AIE.buffer(%t13) {address = 1024 : i32, sym_name = "a"} : memref<16xi32>
+    %b = AIE.buffer(%t33) {address = 1024 : i32, sym_name = "b"} : memref<16xi32>
+    %c = AIE.buffer(%t23) {address = 1024 : i32, sym_name = "c"} : memref<16xi32>
+    AIE.core(%t13) {
+      %c0 = arith.constant 0 : index
+      %v = arith.constant 7 : i32
+      memref.store %v, %a[%c0] : memref<16xi32>
+      AIE.end
+    }
+    AIE.core(%t23) {
+      %c0 = arith.constant 0 : index
+      %v = arith.constant 9 : i32
+      memref.store %v, %c[%c0] : memref<16xi32>
+      AIE.end
+    }
+    AIE.core(%t33) {
+      %c0 = arith.constant 0 : index
+      %v = arith.constant 7 : i32
+      memref.store %v, %b[%c0] : memref<16xi32>
+      AIE.end
+    }
+  }
+}
+"""
+
+tmpdir = sys.argv[1]
+os.makedirs(tmpdir, exist_ok=True)
+opts = aie.compiler.aiecc.cl_arguments.parse_args(
+    ["--dedupe-cores", "--no-unified", "--compile", "--link", "--no-xchesscc",
+     sys.argv[2], "-nv", "--tmpdir", tmpdir, "dedupe.mlir"])
+aiecc.opts = opts
+
+runner = aiecc.flow_runner(module, opts, tmpdir)
+runner.aie_target = "AIE"
+runner.aie_peano_target = "aie-none-elf"
+runner.file_with_addresses = os.path.join(tmpdir, "input_with_addresses.mlir")
+with open(runner.file_with_addresses, "w") as f:
+    f.write(module)
+
+cores = [(1, 3, None), (2, 3, None), (3, 3, None)]
+runner.lower_cores_inprocess(cores)
+runner.find_identical_cores(cores)
+# CHECK: 2 cores share 1 kernels
+
+
+async def link_kernel_cores():
+    for core in cores:
+        if core[0:2] in runner.core_kernels:
+            await runner.link_kernel_core(None, core, [])
+
+
+# The kernel is compiled once and linked for both of its cores.
+asyncio.run(link_kernel_cores())
+# CHECK: {{^}}llc {{.*}}kernel_[[KEY:[0-9a-f]+]].stripped.ll
+# CHECK-SAME: -o {{.*}}kernel_[[KEY]].o
+# CHECK-NOT: {{^}}llc
+# LD: {{^}}clang {{.*}}kernel_[[KEY]].o {{.*}}core_1_3.kernel.ld.script -o ./core_1_3.elf
+# LD: {{^}}clang {{.*}}kernel_[[KEY]].o {{.*}}core_3_3.kernel.ld.script -o ./core_3_3.elf
+# BCF: {{^}}xchesscc_wrapper {{.*}}kernel_[[KEY]].o {{.*}}core_1_3.kernel.bcf -o ./core_1_3.elf
+# BCF: {{^}}xchesscc_wrapper {{.*}}kernel_[[KEY]].o {{.*}}core_3_3.kernel.bcf -o ./core_3_3.elf
+# CHECK-NOT: {{^}}llc
+
+# Each core maps the kernel's buffer onto its own.
+ext = "kernel.bcf" if opts.xbridge else "kernel.ld.script"
+for core in cores:
+    if core[0:2] in runner.core_kernels:
+        print("script", *core[0:2])
+        with open(runner.tmpcorefile(core, ext)) as f:
+            print(f.read())
+
+# CHECK-LABEL: script 1 3
+# LD: PROVIDE(_main = kernel_[[KEY]]);
+# LD: kernel_[[KEY]]_buf0 = a;
+# BCF: _symbol kernel_[[KEY]] _after _main_init
+# BCF: _symbol a [[A:0x[0-9A-F]+]] 0x40
+# BCF: _symbol kernel_[[KEY]]_buf0 [[A]] 0x40
+# BCF-NEXT: _extern kernel_[[KEY]]_buf0
+# CHECK-LABEL: script 3 3
+# LD: PROVIDE(_main = kernel_[[KEY]]);
+# LD: kernel_[[KEY]]_buf0 = b;
+# BCF: _symbol kernel_[[KEY]] _after _main_init
+# BCF: _symbol b [[B:0x[0-9A-F]+]] 0x40
+# BCF: _symbol kernel_[[KEY]]_buf0 [[B]] 0x40
+# BCF-NEXT: _extern kernel_[[KEY]]_buf0
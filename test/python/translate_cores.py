@@ -0,0 +1,55 @@
+# Copyright (C) 2023, Advanced Micro Devices, Inc.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+# RUN: %PYTHON %s | FileCheck %s
+
+import aie
+from aie.ir import *
+from aie.dialects.aie import *
+from aie.compiler.aiecc.main import aie_opt_passes, to_pass_pipeline
+
+module = """
+module {
+  AIE.device(xcvc1902) {
+    %t12 = AIE.tile(1, 2)
+    %t13 = AIE.tile(1, 3)
+    %a = AIE.buffer(%t12) {address = 1024 : i32, sym_name = "a"} : memref<16xi32>
+    %b = AIE.buffer(%t13) {address = 1024 : i32, sym_name = "b"} : memref<16xi32>
+    AIE.core(%t12) {
+      %c0 = arith.constant 0 : index
+      %v = arith.constant 7 : i32
+      memref.store %v, %a[%c0] : memref<16xi32>
+      AIE.end
+    }
+    AIE.core(%t13) {
+      %c0 = arith.constant 0 : index
+      %v = arith.constant 9 : i32
+      memref.store %v, %b[%c0] : memref<16xi32>
+      AIE.end
+    }
+  }
+}
+"""
+
+with Context() as ctx, Location.unknown():
+    aie.dialects.aie.register_dialect(ctx)
+    mlir_module = Module.parse(module)
+    artifacts = translate_cores(
+        mlir_module.operation, [(1, 2), (1, 3)], to_pass_pipeline(aie_opt_passes)
+    )
+
+# The design is parsed once; each core gets its own LLVM IR and linker script.
+for col, row, llvmir, linker_script in artifacts:
+    print("core", col, row)
+    print(llvmir)
+    print(linker_script)
+
+# CHECK-LABEL: core 1 2
+# CHECK: define void @core_1_2()
+# CHECK-NOT: define void @core_1_3()
+# CHECK: a = .;
+# CHECK: PROVIDE(_main = core_1_2);
+# CHECK-LABEL: core 1 3
+# CHECK: define void @core_1_3()
+# CHECK: b = .;
+# CHECK: PROVIDE(_main = core_1_3);
@@ -0,0 +1,21 @@
+//===- aie.mlir ------------------------------------------------*- MLIR -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+// RUN: aiecc.py %VitisSysrootFlag% --host-target=%aieHostTargetTriplet% %s -I%host_runtime_lib%/test_lib/include %extraAieCcFlags% %S/test.cpp -o test.elf -L%host_runtime_lib%/test_lib/lib -ltest_lib
+// RUN: %run_on_board ./test.elf
+
+module @test32_acquire_locks {
+  %tile13 = AIE.tile(1, 3)
+
+  %lock13_3 = AIE.lock(%tile13, 3) { sym_name = "lock1" }
+  %lock13_5 = AIE.lock(%tile13, 5) { sym_name = "lock2" }
+
+  %buf13 = AIE.buffer(%tile13) { sym_name = "buf" } : memref<8xi32>
+}
@@ -0,0 +1,122 @@
+//===- test.cpp -------------------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// (c) Copyright 2023 Advanced Micro Devices, Inc.
+//
+//===----------------------------------------------------------------------===//
+
+#include "test_library.h"
+#include <cstdio>
+#include <xaiengine.h>
+
+#include "aie_inc.cpp"
+
+#define LOCK_TIMEOUT 1000
+
+// Check the acquired bit and the value of a lock of tile (1, 3).
+int check_lock(aie_libxaie_ctx_t *_xaie, int lock, u32 acquired, u32 value) {
+  u32 locks =
+      mlir_aie_read32(_xaie, mlir_aie_get_tile_addr(_xaie, 1, 3) + 0x0001EF00);
+  u32 two_bits = (locks >> (lock * 2)) & 0x3;
+  if ((two_bits & 0x1) == acquired && ((two_bits >> 1) & 0x1) == value)
+    return 0;
+  printf("Error: lock %d is %s with value %d\n", lock,
+         (two_bits & 0x1) ? "acquired" : "released", (two_bits >> 1) & 0x1);
+  return 1;
+}
+
+int main(int argc, char *argv[]) {
+  printf("test start.\n");
+
+  aie_libxaie_ctx_t *_xaie = mlir_aie_init_libxaie();
+  mlir_aie_init_device(_xaie);
+
+  mlir_aie_configure_switchboxes(_xaie);
+  mlir_aie_initialize_locks(_xaie);
+
+  int errors = 0;
+
+  // Lock 5 has value 0, so it can't be acquired with 1. Lock 3 is acquired
+  // on the way and must be released again when the timeout expires.
+  mlir_aie_lock_t blocked[] = {{1, 3, 3, 0}, {1, 3, 5, 1}};
+  if (mlir_aie_acquire_locks(_xaie, blocked, 2, LOCK_TIMEOUT)) {
+    printf("Error: Locks acquired successfully in wrong state!\n");
+    errors++;
+  }
+  errors += check_lock(_xaie, 3, 0, 0);
+  errors += check_lock(_xaie, 5, 0, 0);
+
+  mlir_aie_lock_t both[] = {{1, 3, 3, 0}, {1, 3, 5, 0}};
+  if (!mlir_aie_acquire_locks(_xaie, both, 2, LOCK_TIMEOUT)) {
+    printf("Error: Locks could not be acquired!\n");
+    errors++;
+  }
+  errors += check_lock(_xaie, 3, 1, 0);
+  errors += check_lock(_xaie, 5, 1, 0);
+
+  mlir_aie_lock_t released[] = {{1, 3, 3, 1}, {1, 3, 5, 1}};
+  if (!mlir_aie_release_locks(_xaie, released, 2, LOCK_TIMEOUT)) {
+    printf("Error: Locks could not be released!\n");
+    errors++;
+  }
+  errors += check_lock(_xaie, 3, 0, 1);
+  errors += check_lock(_xaie, 5, 0, 1);
+
+  // Both locks now have value 1, so only the second one can be acquired.
+  mlir_aie_lock_t any[] = {{1, 3, 3, 0}, {1, 3, 5, 1}};
+  int acquired = mlir_aie_acquire_any_lock(_xaie, any, 2, LOCK_TIMEOUT);
+  if (acquired != 1) {
+    printf("Error: Acquired lock %d instead of lock 1!\n", acquired);
+    errors++;
+  }
+  errors += check_lock(_xaie, 3, 0, 1);
+  errors += check_lock(_xaie, 5, 1, 1);
+
+  // Lock 5 is held now, so neither lock can be acquired.
+  acquired = mlir_aie_acquire_any_lock(_xaie, any, 2, LOCK_TIMEOUT);
+  if (acquired != -1) {
+    printf("Error: Lock %d acquired successfully in wrong state!\n", acquired);
+    errors++;
+  }
+  errors += check_lock(_xaie, 3, 0, 1);
+  errors += check_lock(_xaie, 5, 1, 1);
+
+  // Write the buffer as a block and read it back word by word, then the
+  // other way round.
+  u32 words[8];
+  for (int i = 0; i < 8; i++)
+    words[i] = 100 + i;
+  if (mlir_aie_data_mem_wr_words(_xaie, 1, 3, buf_offset, words, 8)) {
+    printf("Error: Buffer could not be written!\n");
+    errors++;
+  }
+  for (int i = 0; i < 8; i++)
+    mlir_aie_check("Block write:", mlir_aie_read_buffer_buf(_xaie, i), 100 + i,
+                   errors);
+
+  for (int i = 0; i < 8; i++)
+    mlir_aie_write_buffer_buf(_xaie, i, 200 + i);
+  if (mlir_aie_data_mem_rd_words(_xaie, 1, 3, buf_offset, words, 8)) {
+    printf("Error: Buffer could not be read!\n");
+    errors++;
+  }
+  for (int i = 0; i < 8; i++)
+    mlir_aie_check("Block read:", (int)words[i], 200 + i, errors);
+
+  int res = 0;
+  if (!errors) {
+    printf("PASS!\n");
+    res = 0;
+  } else {
+    printf("Fail!\n");
+    printf("%d Errors\n", errors);
+    res = -1;
+  }
+  mlir_aie_deinit_libxaie(_xaie);
+
+  printf("test done.\n");
+  return res;
+}